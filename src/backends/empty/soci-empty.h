@@ -127,6 +127,8 @@ struct SOCI_EMPTY_DECL empty_statement_backend : details::statement_backend
     empty_vector_into_type_backend* make_vector_into_type_backend();
     empty_vector_use_type_backend* make_vector_use_type_backend();
 
+    bool reset_for_reuse();
+
     empty_session_backend& session_;
 };
 
@@ -81,6 +81,12 @@ void empty_statement_backend::describe_column(int /* colNum */,
     // ...
 }
 
+bool empty_statement_backend::reset_for_reuse()
+{
+    // ...
+    return true;
+}
+
 empty_standard_into_type_backend * empty_statement_backend::make_into_type_backend()
 {
     return new empty_standard_into_type_backend(*this);
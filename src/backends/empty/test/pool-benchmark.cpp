@@ -0,0 +1,292 @@
+//
+// Copyright (C) 2008 Maciej Sobczak
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "soci.h"
+#include "soci-empty.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+using namespace soci;
+
+// Throughput of connection_pool lease and give_back under contention.
+//
+// The empty backend doesn't do any work, so this measures the overhead of
+// the pool itself: every thread repeatedly takes a session from the pool,
+// "uses" it very briefly and gives it back. This also checks that no
+// session is ever given to two threads at the same time.
+
+#ifndef _WIN32
+
+#include <pthread.h>
+#include <time.h>
+
+namespace // anonymous
+{
+
+struct benchmark_context
+{
+    connection_pool * pool_;
+    std::vector<int> * owners_;
+    int iterations_;
+    int timeout_;
+    long timeouts_;
+
+    // in the priority mode, the odd threads are interactive and use the
+    // reserved sessions, the even ones hold their sessions for a while
+    bool priorities_;
+};
+
+double now()
+{
+    struct timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+    return tm.tv_sec + tm.tv_nsec / 1e9;
+}
+
+struct thread_args
+{
+    benchmark_context * context_;
+    int id_;
+    long timeouts_;
+    std::vector<double> waits_;
+};
+
+extern "C" void * worker(void * p)
+{
+    thread_args & args = *static_cast<thread_args *>(p);
+    benchmark_context & context = *args.context_;
+
+    bool const interactive = context.priorities_ && args.id_ % 2 != 0;
+    int const priority = interactive ? 1 : 0;
+
+    for (int i = 0; i != context.iterations_; ++i)
+    {
+        double const start = context.priorities_ ? now() : 0;
+
+        std::size_t pos;
+        if (context.pool_->try_lease(pos, context.timeout_, priority) == false)
+        {
+            ++args.timeouts_;
+            continue;
+        }
+
+        if (context.priorities_)
+        {
+            args.waits_.push_back(now() - start);
+            if (interactive == false)
+            {
+                struct timespec tm = { 0, 100 * 1000 };
+                nanosleep(&tm, NULL);
+            }
+        }
+
+        // nobody else can use this session now
+        std::vector<int> & owners = *context.owners_;
+        assert(owners[pos] == 0);
+        owners[pos] = args.id_;
+        assert(owners[pos] == args.id_);
+        owners[pos] = 0;
+
+        context.pool_->give_back(pos);
+    }
+
+    return NULL;
+}
+
+// 99th percentile of the wait times of the interactive or the other threads
+double wait_p99(std::vector<thread_args> const & args, bool interactive)
+{
+    std::vector<double> waits;
+    for (std::size_t i = 0; i != args.size(); ++i)
+    {
+        if ((args[i].id_ % 2 != 0) == interactive)
+        {
+            waits.insert(waits.end(),
+                args[i].waits_.begin(), args[i].waits_.end());
+        }
+    }
+
+    if (waits.empty())
+    {
+        return 0;
+    }
+
+    std::vector<double>::iterator const p99 =
+        waits.begin() + waits.size() * 99 / 100;
+    std::nth_element(waits.begin(), p99, waits.end());
+    return *p99;
+}
+
+int run(int threads, std::size_t poolSize, int iterations, int timeout,
+    bool affinity, bool priorities)
+{
+    connection_pool pool(poolSize);
+    pool.set_thread_affinity(affinity);
+    if (priorities)
+    {
+        // one session in four for the interactive threads
+        pool.set_reserved(1, poolSize > 4 ? poolSize / 4 : 1);
+    }
+    for (std::size_t i = 0; i != poolSize; ++i)
+    {
+        pool.at(i).open(*factory_empty(), "dummy");
+    }
+
+    std::vector<int> owners(poolSize, 0);
+
+    benchmark_context context;
+    context.pool_ = &pool;
+    context.owners_ = &owners;
+    context.iterations_ = iterations;
+    context.timeout_ = timeout;
+    context.priorities_ = priorities;
+
+    std::vector<pthread_t> ids(threads);
+    std::vector<thread_args> args(threads);
+
+    double const start = now();
+
+    for (int i = 0; i != threads; ++i)
+    {
+        args[i].context_ = &context;
+        args[i].id_ = i + 1;
+        args[i].timeouts_ = 0;
+
+        if (pthread_create(&ids[i], NULL, worker, &args[i]) != 0)
+        {
+            std::cerr << "Cannot create thread.\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    long timeouts = 0;
+    for (int i = 0; i != threads; ++i)
+    {
+        pthread_join(ids[i], NULL);
+        timeouts += args[i].timeouts_;
+    }
+
+    double const elapsed = now() - start;
+    double const leases = static_cast<double>(threads) * iterations - timeouts;
+
+    std::cout << threads << " threads, " << poolSize << " sessions: "
+        << leases << " leases in " << elapsed << "s, "
+        << static_cast<long>(leases / elapsed) << " leases/s";
+    if (affinity)
+    {
+        std::cout << ", thread affinity";
+    }
+
+    // the statistics of the pool must agree with what the threads saw
+    connection_pool_stats stats;
+    pool.get_stats(stats);
+    assert(stats.leases_ == static_cast<long long>(leases));
+    assert(stats.timeouts_ == timeouts);
+    assert(stats.inUse_ == 0 && stats.waiting_ == 0);
+
+    // upper bound of the bucket of the 99th percentile of the wait time
+    long long seen = 0;
+    std::size_t bucket = 0;
+    while (bucket + 1 != connection_pool_stats::histogram_size &&
+        (seen += stats.waitTime_[bucket]) * 100 < stats.leases_ * 99)
+    {
+        ++bucket;
+    }
+    std::cout << ", 99% waited < " << (1L << bucket) << "us";
+
+    if (priorities)
+    {
+        std::cout << ", 99% of interactive leases waited "
+            << static_cast<long>(wait_p99(args, true) * 1e6) << "us, others "
+            << static_cast<long>(wait_p99(args, false) * 1e6) << "us";
+    }
+    if (timeout >= 0)
+    {
+        std::cout << ", " << timeouts << " timeouts";
+    }
+    std::cout << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+} // namespace anonymous
+
+#endif // _WIN32
+
+int main(int argc, char** argv)
+{
+    // the first argument is the connection string, for uniformity with the
+    // other tests, it is not used as the sessions use the empty backend
+    if (argc < 2)
+    {
+        std::cout << "usage: " << argv[0]
+            << " connectstring [threads [pool size [iterations]]]\n"
+            << "example: " << argv[0]
+            << " dummy 64 256 100000\n";
+        std::exit(1);
+    }
+
+    int threads = 16;
+    int poolSize = 8;
+    int iterations = 20000;
+
+    if (argc > 2)
+    {
+        std::istringstream(argv[2]) >> threads;
+    }
+    if (argc > 3)
+    {
+        std::istringstream(argv[3]) >> poolSize;
+    }
+    if (argc > 4)
+    {
+        std::istringstream(argv[4]) >> iterations;
+    }
+
+#ifndef _WIN32
+    try
+    {
+        // blocking leases and the ones with timeout, with and without the
+        // thread affinity
+        int result = EXIT_SUCCESS;
+        for (int affinity = 0; affinity != 2 && result == EXIT_SUCCESS;
+            ++affinity)
+        {
+            result = run(threads, poolSize, iterations, -1, affinity != 0,
+                false);
+            if (result == EXIT_SUCCESS)
+            {
+                result = run(threads, poolSize, iterations, 1000,
+                    affinity != 0, false);
+            }
+        }
+
+        // interactive threads with reserved sessions against slower batch
+        // threads taking all the others
+        if (result == EXIT_SUCCESS && poolSize > 1)
+        {
+            result = run(threads, poolSize, iterations / 10, -1, false, true);
+        }
+
+        return result;
+    }
+    catch (std::exception const & e)
+    {
+        std::cout << e.what() << '\n';
+    }
+
+    return EXIT_FAILURE;
+#else
+    std::cout << "The pool benchmark is not available on this platform.\n";
+    return EXIT_SUCCESS;
+#endif // _WIN32
+}
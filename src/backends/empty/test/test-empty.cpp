@@ -9,9 +9,17 @@
 #include "soci-empty.h"
 #include <iostream>
 #include <string>
+#include <vector>
 #include <cassert>
 #include <cstdlib>
 #include <ctime>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 using namespace soci;
 
@@ -33,6 +41,27 @@ backend_factory const &backEnd = *soci::factory_empty();
 // from the database-development point of view. For new tests, you may wish
 // to remove this code and keep only the general structure of this file.
 
+// count all the memory allocations done by the program, this is used to
+// check that the "once" statements don't allocate anything in steady state
+std::size_t allocationsCount = 0;
+
+void * operator new(std::size_t size) throw (std::bad_alloc)
+{
+    ++allocationsCount;
+
+    void * p = std::malloc(size == 0 ? 1 : size);
+    if (p == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void * p) throw ()
+{
+    std::free(p);
+}
+
 struct Person
 {
     int id;
@@ -125,6 +154,591 @@ void test1()
     std::cout << "test 1 passed" << std::endl;
 }
 
+// test the allocation-free path of "once" statements
+void test2()
+{
+    {
+        session sql(backEnd, connectString);
+        sql.set_statement_cache_size(10);
+
+        // the first execution prepares everything that is reused later
+        std::string const query = "update some_table set some_column = 0";
+        sql << "update some_table set some_column = 0";
+
+        std::size_t const before = allocationsCount;
+        for (int i = 0; i != 100; ++i)
+        {
+            sql << "update some_table set some_column = 0";
+            sql << query;
+        }
+        assert(allocationsCount == before);
+        assert(sql.get_statement_cache_hits() == 200);
+        assert(sql.get_last_query() == query);
+
+        // the into and use elements of the basic types and their backends
+        // are reused too
+        int x = 1;
+        int y = 0;
+        indicator ind = i_ok;
+        sql << "update some_table set some_column = :x", use(x);
+        sql << "select some_column from some_table", into(y);
+        sql << "select :x from some_table", use(x), into(y, ind);
+
+        std::size_t const beforeElements = allocationsCount;
+        for (int i = 0; i != 100; ++i)
+        {
+            sql << "update some_table set some_column = :x", use(x);
+            sql << "select some_column from some_table", into(y);
+            sql << "select :x from some_table", use(x), into(y, ind);
+        }
+        assert(allocationsCount == beforeElements);
+        assert(sql.get_statement_cache_hits() == 200 + 300);
+
+        // formatted parts of the query are still supported
+        sql << "update some_table set some_column = " << 1;
+        assert(sql.get_last_query() ==
+            "update some_table set some_column = 1");
+        sql << query;
+        assert(sql.get_last_query() == query);
+    }
+
+    std::cout << "test 2 passed" << std::endl;
+}
+
+// connection pool bookkeeping
+void test3()
+{
+    {
+        std::size_t const poolSize = 3;
+        connection_pool pool(poolSize);
+
+        for (std::size_t i = 0; i != poolSize; ++i)
+        {
+            pool.at(i).open(backEnd, connectString);
+        }
+
+        std::size_t pos[poolSize];
+        for (std::size_t i = 0; i != poolSize; ++i)
+        {
+            assert(pool.try_lease(pos[i], 0));
+        }
+        assert(pos[0] != pos[1] && pos[1] != pos[2] && pos[0] != pos[2]);
+
+        // all the sessions are in use now
+        std::size_t other;
+        assert(pool.try_lease(other, 0) == false);
+
+        std::time_t const start = std::time(NULL);
+        assert(pool.try_lease(other, 50) == false);
+        assert(std::time(NULL) - start < 2);
+
+        // the session given back last is leased first
+        pool.give_back(pos[0]);
+        pool.give_back(pos[2]);
+        assert(pool.try_lease(other, 0));
+        assert(other == pos[2]);
+
+        try
+        {
+            pool.give_back(pos[0]);
+            assert(false);
+        }
+        catch (soci_error const &)
+        {
+        }
+
+        pool.give_back(pos[1]);
+        pool.give_back(pos[2]);
+    }
+
+    std::cout << "test 3 passed" << std::endl;
+}
+
+void sleep_ms(int ms)
+{
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    usleep(ms * 1000);
+#endif
+}
+
+std::size_t count_open(connection_pool & pool, std::size_t size)
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        if (pool.at(i).get_backend() != NULL)
+        {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// elastic connection pool
+void test4()
+{
+    {
+        connection_parameters const parameters(backEnd, connectString);
+
+        // the minimal number of sessions is opened immediately
+        connection_pool pool(parameters, 2, 4, 50);
+        assert(count_open(pool, 4) == 2);
+
+        // the others are opened when needed
+        std::size_t pos[4];
+        assert(pool.try_lease(pos[0], 0));
+        assert(pool.try_lease(pos[1], 0));
+        assert(count_open(pool, 4) == 2);
+        assert(pool.try_lease(pos[2], 0));
+        assert(pool.at(pos[2]).get_backend() != NULL);
+        assert(count_open(pool, 4) == 3);
+
+        {
+            session sql(pool);
+            assert(count_open(pool, 4) == 4);
+            sql << "update some_table set some_column = 0";
+        }
+
+        for (int i = 0; i != 3; ++i)
+        {
+            pool.give_back(pos[i]);
+        }
+
+        // the sessions not used for too long are closed again, down to the
+        // minimal number of them
+        for (int i = 0; i != 50 && count_open(pool, 4) != 2; ++i)
+        {
+            sleep_ms(20);
+        }
+        assert(count_open(pool, 4) == 2);
+
+        // and are opened again when needed
+        for (int i = 0; i != 4; ++i)
+        {
+            assert(pool.try_lease(pos[i], 0));
+        }
+        assert(count_open(pool, 4) == 4);
+        for (int i = 0; i != 4; ++i)
+        {
+            pool.give_back(pos[i]);
+        }
+    }
+
+    {
+        // the reaper waits without a deadline while there is nothing to
+        // close and is woken up when a session becomes idle
+        connection_pool pool(connection_parameters(backEnd, connectString),
+            0, 2, 0);
+        assert(count_open(pool, 2) == 0);
+        sleep_ms(20);
+
+        std::size_t pos;
+        assert(pool.try_lease(pos, 0));
+        assert(count_open(pool, 2) == 1);
+        pool.give_back(pos);
+        for (int i = 0; i != 50 && count_open(pool, 2) != 0; ++i)
+        {
+            sleep_ms(20);
+        }
+        assert(count_open(pool, 2) == 0);
+    }
+
+    {
+        // the sessions which are never closed
+        connection_pool pool(connection_parameters(backEnd, connectString),
+            0, 3);
+        assert(count_open(pool, 3) == 0);
+
+        std::size_t pos;
+        assert(pool.try_lease(pos, 0));
+        pool.give_back(pos);
+        sleep_ms(20);
+        assert(count_open(pool, 3) == 1);
+    }
+
+    try
+    {
+        connection_pool pool(connection_parameters(backEnd, connectString),
+            3, 2);
+        assert(false);
+    }
+    catch (soci_error const &)
+    {
+    }
+
+    std::cout << "test 4 passed" << std::endl;
+}
+
+// thread affinity mode of the connection pool
+void test5()
+{
+    {
+        std::size_t const poolSize = 3;
+        connection_pool pool(poolSize);
+        pool.set_thread_affinity(true);
+        assert(pool.get_thread_affinity());
+
+        for (std::size_t i = 0; i != poolSize; ++i)
+        {
+            pool.at(i).open(backEnd, connectString);
+        }
+
+        std::size_t pos[poolSize];
+        for (std::size_t i = 0; i != poolSize; ++i)
+        {
+            assert(pool.try_lease(pos[i], 0));
+        }
+
+        // the session given back last by this thread is leased again
+        pool.give_back(pos[1]);
+        std::size_t other;
+        assert(pool.try_lease(other, 0));
+        assert(other == pos[1]);
+
+        // and it is not leased twice
+        assert(pool.try_lease(other, 0) == false);
+
+        pool.give_back(pos[1]);
+        try
+        {
+            pool.give_back(pos[1]);
+            assert(false);
+        }
+        catch (soci_error const &)
+        {
+        }
+
+        // the other sessions are taken when it is busy
+        pool.give_back(pos[0]);
+        assert(pool.try_lease(pos[0], 0));
+        assert(pool.try_lease(other, 0));
+        assert(other != pos[0] && other != pos[2]);
+        assert(pool.try_lease(pos[1], 0) == false);
+        pool.give_back(other);
+
+        pool.give_back(pos[0]);
+        pool.give_back(pos[2]);
+
+        for (std::size_t i = 0; i != poolSize; ++i)
+        {
+            assert(pool.try_lease(pos[i], 0));
+        }
+        assert(pos[0] != pos[1] && pos[1] != pos[2] && pos[0] != pos[2]);
+        assert(pool.try_lease(other, 0) == false);
+
+        for (std::size_t i = 0; i != poolSize; ++i)
+        {
+            pool.give_back(pos[i]);
+        }
+    }
+
+    {
+        // the sessions created from the pool reuse the same connection
+        connection_pool pool(connection_parameters(backEnd, connectString),
+            2, 2);
+        pool.set_thread_affinity(true);
+
+        details::session_backend * backend;
+        {
+            session sql(pool);
+            backend = sql.get_backend();
+        }
+        {
+            session sql(pool);
+            assert(sql.get_backend() == backend);
+        }
+    }
+
+    std::cout << "test 5 passed" << std::endl;
+}
+
+long long histogram_count(long long const * histogram, std::size_t from)
+{
+    long long count = 0;
+    for (std::size_t i = from; i != connection_pool_stats::histogram_size; ++i)
+    {
+        count += histogram[i];
+    }
+    return count;
+}
+
+// statistics of the connection pool
+void test6()
+{
+    for (int affinity = 0; affinity != 2; ++affinity)
+    {
+        connection_pool pool(2);
+        pool.set_thread_affinity(affinity != 0);
+        for (std::size_t i = 0; i != 2; ++i)
+        {
+            pool.at(i).open(backEnd, connectString);
+        }
+
+        connection_pool_stats stats;
+        pool.get_stats(stats);
+        assert(stats.size_ == 2 && stats.open_ == 2);
+        assert(stats.inUse_ == 0 && stats.waiting_ == 0);
+        assert(stats.leases_ == 0 && stats.timeouts_ == 0);
+        assert(histogram_count(stats.waitTime_, 0) == 0);
+        assert(histogram_count(stats.holdTime_, 0) == 0);
+
+        std::size_t pos[2];
+        assert(pool.try_lease(pos[0], 0));
+        assert(pool.try_lease(pos[1], 0));
+
+        std::size_t other;
+        assert(pool.try_lease(other, 0) == false);
+        assert(pool.try_lease(other, 10) == false);
+
+        pool.get_stats(stats);
+        assert(stats.inUse_ == 2);
+        assert(stats.leases_ == 2 && stats.timeouts_ == 2);
+        assert(histogram_count(stats.waitTime_, 0) == 2);
+        assert(histogram_count(stats.holdTime_, 0) == 0);
+
+        // held for at least 4096us
+        sleep_ms(5);
+        pool.give_back(pos[0]);
+
+        // leased again, directly in the thread affinity mode
+        assert(pool.try_lease(pos[0], 0));
+        pool.give_back(pos[0]);
+        pool.give_back(pos[1]);
+
+        pool.get_stats(stats);
+        assert(stats.inUse_ == 0);
+        assert(stats.leases_ == 3 && stats.timeouts_ == 2);
+        assert(histogram_count(stats.waitTime_, 0) == 3);
+        assert(histogram_count(stats.holdTime_, 0) == 3);
+        assert(histogram_count(stats.holdTime_, 13) == 2);
+    }
+
+    {
+        connection_pool pool(connection_parameters(backEnd, connectString),
+            0, 2);
+
+        connection_pool_stats stats;
+        pool.get_stats(stats);
+        assert(stats.size_ == 2 && stats.open_ == 0);
+
+        {
+            session sql(pool);
+            pool.get_stats(stats);
+            assert(stats.open_ == 1 && stats.inUse_ == 1);
+        }
+
+        pool.get_stats(stats);
+        assert(stats.open_ == 1 && stats.inUse_ == 0 && stats.leases_ == 1);
+    }
+
+    std::cout << "test 6 passed" << std::endl;
+}
+
+// priorities and reserved sessions of the connection pool
+void test7()
+{
+    for (int affinity = 0; affinity != 2; ++affinity)
+    {
+        connection_pool pool(3);
+        pool.set_thread_affinity(affinity != 0);
+        pool.set_reserved(1, 1);
+        for (std::size_t i = 0; i != 3; ++i)
+        {
+            pool.at(i).open(backEnd, connectString);
+        }
+
+        std::size_t pos[3];
+        assert(pool.try_lease(pos[0], 0));
+        assert(pool.try_lease(pos[1], 0));
+
+        // the last session is kept for the higher priority
+        std::size_t other;
+        assert(pool.try_lease(other, 0) == false);
+        assert(pool.try_lease(other, 10) == false);
+        assert(pool.try_lease(other, 0, -1) == false);
+        assert(pool.try_lease(pos[2], 0, 1));
+        assert(pool.try_lease(other, 0, 2) == false);
+
+        // even when it was given back last by this thread
+        pool.give_back(pos[2]);
+        pool.give_back(pos[1]);
+        assert(pool.try_lease(pos[1], 0));
+        assert(pool.try_lease(other, 0) == false);
+        assert(pool.try_lease(pos[2], 0, 1));
+
+        for (std::size_t i = 0; i != 3; ++i)
+        {
+            pool.give_back(pos[i]);
+        }
+    }
+
+    {
+        // nested reservations
+        connection_pool pool(4);
+        pool.set_reserved(1, 3);
+        pool.set_reserved(2, 2);
+        for (std::size_t i = 0; i != 4; ++i)
+        {
+            pool.at(i).open(backEnd, connectString);
+        }
+
+        std::size_t pos[4];
+        std::size_t other;
+        assert(pool.try_lease(pos[0], 0));
+        assert(pool.try_lease(other, 0) == false);
+        assert(pool.try_lease(pos[1], 0, 1));
+        assert(pool.try_lease(other, 0, 1) == false);
+        assert(pool.try_lease(pos[2], 0, 2));
+        assert(pool.try_lease(pos[3], 0, 2));
+        assert(pool.try_lease(other, 0, 2) == false);
+
+        for (std::size_t i = 0; i != 4; ++i)
+        {
+            pool.give_back(pos[i]);
+        }
+
+        // the reservation can be removed
+        pool.set_reserved(1, 0);
+        pool.set_reserved(2, 0);
+        for (std::size_t i = 0; i != 4; ++i)
+        {
+            assert(pool.try_lease(pos[i], 0));
+        }
+    }
+
+    {
+        // the closed sessions of an elastic pool are free too
+        connection_pool pool(connection_parameters(backEnd, connectString),
+            1, 3);
+        pool.set_reserved(1, 1);
+
+        session sql1(pool);
+        session sql2(pool);
+        assert(sql1.get_backend() != NULL && sql2.get_backend() != NULL);
+
+        std::size_t other;
+        assert(pool.try_lease(other, 0) == false);
+
+        session sql3(pool, 1);
+        assert(sql3.get_backend() != NULL);
+    }
+
+    try
+    {
+        connection_pool pool(2);
+        pool.set_reserved(1, 2);
+        assert(false);
+    }
+    catch (soci_error const &)
+    {
+    }
+
+    std::cout << "test 7 passed" << std::endl;
+}
+
+int get_answer(session & sql)
+{
+    assert(sql.get_backend() != NULL);
+    return 42;
+}
+
+void fail_job(session &)
+{
+    throw soci_error("Job failed");
+}
+
+struct doubler
+{
+    typedef int result_type;
+
+    explicit doubler(int n) : n_(n) {}
+
+    int operator()(session & sql) const
+    {
+        assert(sql.get_backend() != NULL);
+        return n_ * 2;
+    }
+
+    int n_;
+};
+
+// asynchronous executor
+void test8()
+{
+    {
+        executor ex(connection_parameters(backEnd, connectString), 4, 2);
+
+        executor_future<int> answer = ex.submit(get_answer);
+        assert(answer.valid());
+        assert(answer.get() == 42);
+        assert(answer.is_ready() && answer.wait(0));
+
+        // the futures can be copied and outlive each other
+        executor_future<int> copy;
+        assert(copy.valid() == false);
+        copy = answer;
+        answer = executor_future<int>();
+        assert(copy.get() == 42);
+
+        std::vector<executor_future<int> > results;
+        for (int i = 0; i != 100; ++i)
+        {
+            results.push_back(ex.submit(doubler(i)));
+        }
+        for (int i = 0; i != 100; ++i)
+        {
+            assert(results[i].get() == i * 2);
+        }
+
+        executor_future<void> failed = ex.submit(fail_job);
+        failed.wait();
+        try
+        {
+            failed.get();
+            assert(false);
+        }
+        catch (soci_error const & e)
+        {
+            assert(std::string(e.what()) == "Job failed");
+        }
+
+        connection_pool_stats stats;
+        ex.get_pool().get_stats(stats);
+        assert(stats.size_ == 2 && stats.open_ == 2);
+        assert(stats.leases_ == 102);
+    }
+
+    {
+        // the queued jobs are executed before the executor is destroyed
+        std::vector<executor_future<int> > results;
+        {
+            executor ex(connection_parameters(backEnd, connectString), 2, 1);
+            for (int i = 0; i != 20; ++i)
+            {
+                results.push_back(ex.submit(doubler(i)));
+            }
+        }
+        for (int i = 0; i != 20; ++i)
+        {
+            assert(results[i].is_ready());
+            assert(results[i].get() == i * 2);
+        }
+    }
+
+    try
+    {
+        executor_future<int> invalid;
+        invalid.get();
+        assert(false);
+    }
+    catch (soci_error const &)
+    {
+    }
+
+    std::cout << "test 8 passed" << std::endl;
+}
 
 int main(int argc, char** argv)
 {
@@ -154,7 +768,13 @@ int main(int argc, char** argv)
     try
     {
         test1();
-        // test2();
+        test2();
+        test3();
+        test4();
+        test5();
+        test6();
+        test7();
+        test8();
         // ...
 
         std::cout << "\nOK, all tests passed.\n\n";
@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <string>
 
 namespace // anonymous
 {
@@ -75,6 +76,100 @@ void soci::details::mysql::parse_std_tm(char const *buf, std::tm &t)
     std::mktime(&t);
 }
 
+void soci::details::mysql::mysql_time_to_std_tm(MYSQL_TIME const &mt,
+    std::tm &t)
+{
+    t.tm_isdst = -1;
+
+    // the values of the time columns get the same date as when parsed
+    if (mt.time_type == MYSQL_TIMESTAMP_TIME)
+    {
+        t.tm_year = 2000 - 1900;
+        t.tm_mon  = 0;
+        t.tm_mday = 1;
+    }
+    else
+    {
+        t.tm_year = static_cast<int>(mt.year) - 1900;
+        t.tm_mon  = static_cast<int>(mt.month) - 1;
+        t.tm_mday = static_cast<int>(mt.day);
+    }
+    t.tm_hour = static_cast<int>(mt.hour);
+    t.tm_min  = static_cast<int>(mt.minute);
+    t.tm_sec  = static_cast<int>(mt.second);
+
+    std::mktime(&t);
+}
+
+void soci::details::mysql::std_tm_to_mysql_time(std::tm const &t,
+    MYSQL_TIME &mt)
+{
+    std::memset(&mt, 0, sizeof(mt));
+    mt.year   = t.tm_year + 1900;
+    mt.month  = t.tm_mon + 1;
+    mt.day    = t.tm_mday;
+    mt.hour   = t.tm_hour;
+    mt.minute = t.tm_min;
+    mt.second = t.tm_sec;
+    mt.time_type = MYSQL_TIMESTAMP_DATETIME;
+}
+
+void soci::details::mysql::bind_param(MYSQL_BIND &bind, MYSQL_TIME &mt,
+    void *data, exchange_type type)
+{
+    switch (type)
+    {
+    case x_char:
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = data;
+        bind.buffer_length = 1;
+        break;
+    case x_stdstring:
+        {
+            // the string is sent without copying it
+            std::string *s = static_cast<std::string *>(data);
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            bind.buffer = const_cast<char *>(s->data());
+            bind.buffer_length = static_cast<unsigned long>(s->size());
+        }
+        break;
+    case x_short:
+        bind.buffer_type = MYSQL_TYPE_SHORT;
+        bind.buffer = data;
+        break;
+    case x_integer:
+        bind.buffer_type = MYSQL_TYPE_LONG;
+        bind.buffer = data;
+        break;
+    case x_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        break;
+    case x_unsigned_long_long:
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = data;
+        bind.is_unsigned = 1;
+        break;
+    case x_double:
+        if (is_infinity_or_nan(*static_cast<double *>(data)))
+        {
+            throw soci_error(
+                "Use element used with infinity or NaN, which are "
+                "not supported by the MySQL server.");
+        }
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = data;
+        break;
+    case x_stdtm:
+        std_tm_to_mysql_time(*static_cast<std::tm *>(data), mt);
+        bind.buffer_type = MYSQL_TYPE_DATETIME;
+        bind.buffer = &mt;
+        break;
+    default:
+        throw soci_error("Use element used with non-supported type.");
+    }
+}
+
 char * soci::details::mysql::quote(MYSQL * conn, const char *s, int len)
 {
     char *retv = new char[2 * len + 3];
@@ -27,6 +27,15 @@ namespace mysql
 // helper function for parsing datetime values
 void parse_std_tm(char const *buf, std::tm &t);
 
+// helper functions for datetime values in the prepared statement mode
+void mysql_time_to_std_tm(MYSQL_TIME const &mt, std::tm &t);
+void std_tm_to_mysql_time(std::tm const &t, MYSQL_TIME &mt);
+
+// helper for binding the value of a use element in the prepared statement
+// mode, the time structure is used for std::tm values
+void bind_param(MYSQL_BIND &bind, MYSQL_TIME &mt,
+    void *data, exchange_type type);
+
 // The idea is that infinity - infinity gives NaN, and NaN != NaN is true.
 //
 // This should work on any IEEE-754-compliant implementation, which is
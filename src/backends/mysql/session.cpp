@@ -157,7 +157,9 @@ void parse_connect_string(const string & connectString,
     int *port, bool *port_p, string *ssl_ca, bool *ssl_ca_p,
     string *ssl_cert, bool *ssl_cert_p, string *ssl_key, bool *ssl_key_p,
     int *local_infile, bool *local_infile_p,
-    string *charset, bool *charset_p)
+    string *charset, bool *charset_p,
+    int *prepared_statements, bool *prepared_statements_p,
+    int *use_result, bool *use_result_p)
 {
     *host_p = false;
     *user_p = false;
@@ -170,6 +172,8 @@ void parse_connect_string(const string & connectString,
     *ssl_key_p = false;
     *local_infile_p = false;
     *charset_p = false;
+    *prepared_statements_p = false;
+    *use_result_p = false;
     string err = "Malformed connection string.";
     string::const_iterator i = connectString.begin(),
         end = connectString.end();
@@ -263,6 +267,32 @@ void parse_connect_string(const string & connectString,
             *charset = val;
             *charset_p = true;
         }
+        else if (par == "prepared_statements" and not *prepared_statements_p)
+        {
+            if (not valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *prepared_statements = std::atoi(val.c_str());
+            if (*prepared_statements != 0 and *prepared_statements != 1)
+            {
+                throw soci_error(err);
+            }
+            *prepared_statements_p = true;
+        }
+        else if (par == "use_result" and not *use_result_p)
+        {
+            if (not valid_int(val))
+            {
+                throw soci_error(err);
+            }
+            *use_result = std::atoi(val.c_str());
+            if (*use_result != 0 and *use_result != 1)
+            {
+                throw soci_error(err);
+            }
+            *use_result_p = true;
+        }
         else
         {
             throw soci_error(err);
@@ -277,14 +307,19 @@ mysql_session_backend::mysql_session_backend(
 {
     string host, user, password, db, unix_socket, ssl_ca, ssl_cert, ssl_key,
         charset;
-    int port, local_infile;
+    int port, local_infile, prepared_statements, use_result;
     bool host_p, user_p, password_p, db_p, unix_socket_p, port_p,
-        ssl_ca_p, ssl_cert_p, ssl_key_p, local_infile_p, charset_p;
+        ssl_ca_p, ssl_cert_p, ssl_key_p, local_infile_p, charset_p,
+        prepared_statements_p, use_result_p;
     parse_connect_string(parameters.get_connect_string(), &host, &host_p, &user, &user_p,
         &password, &password_p, &db, &db_p,
         &unix_socket, &unix_socket_p, &port, &port_p,
         &ssl_ca, &ssl_ca_p, &ssl_cert, &ssl_cert_p, &ssl_key, &ssl_key_p,
-        &local_infile, &local_infile_p, &charset, &charset_p);
+        &local_infile, &local_infile_p, &charset, &charset_p,
+        &prepared_statements, &prepared_statements_p,
+        &use_result, &use_result_p);
+    preparedStatements_ = prepared_statements_p and prepared_statements == 1;
+    useResult_ = use_result_p and use_result == 1;
     conn_ = mysql_init(NULL);
     if (conn_ == NULL)
     {
@@ -44,6 +44,27 @@ public:
     unsigned int err_num_;
 };
 
+// In the prepared statement mode the values of the columns are received in
+// the binary form into these holders, one per into element, and copied to
+// the user's variables when the rows are fetched.
+struct mysql_result_column
+{
+    mysql_result_column() : data_(NULL), vector_(false) {}
+
+    void *data_;
+    details::exchange_type type_;
+    bool vector_;
+
+    // scratch space for the value of the current row
+    long long integer_;
+    double double_;
+    char char_[2];
+    MYSQL_TIME time_;
+
+    // null indicators of the rows of the last fetch
+    std::vector<indicator> indicators_;
+};
+
 struct mysql_statement_backend;
 struct mysql_standard_into_type_backend : details::standard_into_type_backend
 {
@@ -64,6 +85,8 @@ struct mysql_standard_into_type_backend : details::standard_into_type_backend
     void *data_;
     details::exchange_type type_;
     int position_;
+
+    mysql_result_column column_;
 };
 
 struct mysql_vector_into_type_backend : details::vector_into_type_backend
@@ -87,6 +110,8 @@ struct mysql_vector_into_type_backend : details::vector_into_type_backend
     void *data_;
     details::exchange_type type_;
     int position_;
+
+    mysql_result_column column_;
 };
 
 struct mysql_standard_use_type_backend : details::standard_use_type_backend
@@ -111,6 +136,10 @@ struct mysql_standard_use_type_backend : details::standard_use_type_backend
     int position_;
     std::string name_;
     char *buf_;
+
+    // used instead of buf_ in the prepared statement mode
+    MYSQL_BIND bind_;
+    MYSQL_TIME time_;
 };
 
 struct mysql_vector_use_type_backend : details::vector_use_type_backend
@@ -136,6 +165,10 @@ struct mysql_vector_use_type_backend : details::vector_use_type_backend
     int position_;
     std::string name_;
     std::vector<char *> buffers_;
+
+    // used instead of buffers_ in the prepared statement mode
+    std::vector<MYSQL_BIND> binds_;
+    std::vector<MYSQL_TIME> times_;
 };
 
 struct mysql_session_backend;
@@ -165,9 +198,26 @@ struct mysql_statement_backend : details::statement_backend
     virtual mysql_vector_into_type_backend * make_vector_into_type_backend();
     virtual mysql_vector_use_type_backend * make_vector_use_type_backend();
 
+    virtual bool reset_for_reuse();
+    virtual void reuse_into_type_backend(
+        details::standard_into_type_backend * backEnd);
+    virtual void reuse_use_type_backend(
+        details::standard_use_type_backend * backEnd);
+
+    void free_result();
+    void execute_prepared(int number);
+    void bind_result();
+    bool fetch_row(int row);
+    exec_fetch_result fetch_streamed(int number);
+    void copy_streamed_row(MYSQL_ROW row);
+    char const * streamed_value(int row, int pos, unsigned long &length);
+
     mysql_session_backend &session_;
     
+    // In the prepared statement mode the result only holds the metadata,
+    // the rows are kept in the statement handle.
     MYSQL_RES *result_;
+    MYSQL_STMT *stmt_;
     
     // The query is split into chunks, separated by the named parameters;
     // e.g. for "SELECT id FROM ttt WHERE name = :foo AND gender = :bar"
@@ -202,6 +252,42 @@ struct mysql_statement_backend : details::statement_backend
 
     typedef std::map<std::string, char **> UseByNameBuffersMap;
     UseByNameBuffersMap useByNameBuffers_;
+
+    // the same for the prepared statement mode
+
+    typedef std::map<int, MYSQL_BIND *> UseByPosBindsMap;
+    UseByPosBindsMap useByPosBinds_;
+
+    typedef std::map<std::string, MYSQL_BIND *> UseByNameBindsMap;
+    UseByNameBindsMap useByNameBinds_;
+
+    std::vector<MYSQL_BIND> paramBinds_;
+
+    // the into elements by their positions and the bindings of all the
+    // columns of the result, which are made before fetching the first row
+    typedef std::map<int, mysql_result_column *> ResultColumnsMap;
+    ResultColumnsMap resultColumns_;
+
+    std::vector<MYSQL_BIND> resultBinds_;
+    bool resultBound_;
+
+    // When enabled, the rows are retrieved from the server as they are
+    // fetched instead of storing the whole result on the client side. The
+    // default comes from the "use_result" option of the session, it can be
+    // changed before executing the statement and is restored when the
+    // statement is reused.
+    void set_use_result(bool enable);
+
+    bool useResult_; // changed with set_use_result()
+    bool endOfStream_;
+
+    // In the streaming mode the rows of the current chunk are copied here,
+    // as the rows returned by mysql_fetch_row() are only valid until the
+    // next call to it. The values are null-terminated, the offsets of the
+    // null values are -1.
+    std::vector<char> streamedData_;
+    std::vector<long> streamedOffsets_;
+    std::vector<unsigned long> streamedLengths_;
 };
 
 struct mysql_rowid_backend : details::rowid_backend
@@ -247,6 +333,12 @@ struct mysql_session_backend : details::session_backend
     virtual mysql_blob_backend * make_blob_backend();
     
     MYSQL *conn_;
+
+    // use server-side prepared statements and the binary protocol
+    bool preparedStatements_;
+
+    // stream the results of the statements by default
+    bool useResult_;
 };
 
 
@@ -33,6 +33,10 @@ void mysql_standard_into_type_backend::define_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+
+    column_.data_ = data_;
+    column_.type_ = type_;
+    statement_.resultColumns_[position_] = &column_;
 }
 
 void mysql_standard_into_type_backend::pre_fetch()
@@ -50,14 +54,40 @@ void mysql_standard_into_type_backend::post_fetch(
         return;
     }
     
-    if (gotData)
+    if (gotData && statement_.stmt_ != NULL)
+    {
+        // the value was already stored when the row was fetched
+        if (column_.indicators_[0] == i_null && ind == NULL)
+        {
+            throw soci_error("Null value fetched and no indicator defined.");
+        }
+        if (ind != NULL)
+        {
+            *ind = column_.indicators_[0];
+        }
+    }
+    else if (gotData)
     {
         int pos = position_ - 1;
-        //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
-        MYSQL_ROW row = mysql_fetch_row(statement_.result_);
-        if (row[pos] == NULL)
+        char const *value;
+        unsigned long length = 0;
+        if (statement_.useResult_)
+        {
+            value = statement_.streamed_value(0, pos, length);
+        }
+        else
+        {
+            //mysql_data_seek(statement_.result_, statement_.currentRow_);
+            mysql_row_seek(statement_.result_,
+                statement_.resultRowOffsets_[statement_.currentRow_]);
+            MYSQL_ROW row = mysql_fetch_row(statement_.result_);
+            value = row[pos];
+            if (value != NULL && type_ == x_stdstring)
+            {
+                length = mysql_fetch_lengths(statement_.result_)[pos];
+            }
+        }
+        if (value == NULL)
         {
             if (ind == NULL)
             {
@@ -74,7 +104,7 @@ void mysql_standard_into_type_backend::post_fetch(
                 *ind = i_ok;
             }
         }
-        const char *buf = row[pos] != NULL ? row[pos] : "";
+        const char *buf = value;
         switch (type_)
         {
         case x_char:
@@ -86,9 +116,7 @@ void mysql_standard_into_type_backend::post_fetch(
         case x_stdstring:
             {
                 std::string *dest = static_cast<std::string *>(data_);
-                unsigned long * lengths =
-                    mysql_fetch_lengths(statement_.result_);
-                dest->assign(buf, lengths[pos]);
+                dest->assign(buf, length);
             }
             break;
         case x_short:
@@ -31,6 +31,7 @@ void mysql_standard_use_type_backend::bind_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+    name_.clear();
 }
 
 void mysql_standard_use_type_backend::bind_by_name(
@@ -38,11 +39,37 @@ void mysql_standard_use_type_backend::bind_by_name(
 {
     data_ = data;
     type_ = type;
+    position_ = 0;
     name_ = name;
 }
 
 void mysql_standard_use_type_backend::pre_use(indicator const *ind)
 {
+    if (statement_.stmt_ != NULL)
+    {
+        // the value is sent in the binary form directly from the
+        // user's variable
+        std::memset(&bind_, 0, sizeof(bind_));
+        if (ind != NULL && *ind == i_null)
+        {
+            bind_.buffer_type = MYSQL_TYPE_NULL;
+        }
+        else
+        {
+            bind_param(bind_, time_, data_, type_);
+        }
+
+        if (position_ > 0)
+        {
+            statement_.useByPosBinds_[position_] = &bind_;
+        }
+        else
+        {
+            statement_.useByNameBinds_[name_] = &bind_;
+        }
+        return;
+    }
+
     if (ind != NULL && *ind == i_null)
     {
         buf_ = new char[5];
@@ -8,8 +8,11 @@
 
 #define SOCI_MYSQL_SOURCE
 #include "soci-mysql.h"
+#include "common.h"
 #include <cctype>
 #include <ciso646>
+#include <cstring>
+#include <limits>
 //#include <iostream>
 
 #ifdef _MSC_VER
@@ -18,15 +21,49 @@
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::mysql;
 using std::string;
 
+namespace // anonymous
+{
+
+void throw_stmt_error(MYSQL_STMT *stmt)
+{
+    throw mysql_soci_error(mysql_stmt_error(stmt), mysql_stmt_errno(stmt));
+}
+
+// the variable receiving the value of a column in the given row
+template <typename T>
+T & target(mysql_result_column &column, int row)
+{
+    if (column.vector_)
+    {
+        std::vector<T> &v = *static_cast<std::vector<T> *>(column.data_);
+        return v[row];
+    }
+    return *static_cast<T *>(column.data_);
+}
+
+template <typename T>
+T narrow(long long x)
+{
+    if (x < std::numeric_limits<T>::min() || x > std::numeric_limits<T>::max())
+    {
+        throw soci_error("Cannot convert data.");
+    }
+    return static_cast<T>(x);
+}
+
+} // namespace anonymous
 
 mysql_statement_backend::mysql_statement_backend(
     mysql_session_backend &session)
-    : session_(session), result_(NULL), 
+    : session_(session), result_(NULL), stmt_(NULL),
        rowsAffectedBulk_(-1LL), justDescribed_(false),
        hasIntoElements_(false), hasVectorIntoElements_(false),
-       hasUseElements_(false), hasVectorUseElements_(false)
+       hasUseElements_(false), hasVectorUseElements_(false),
+       resultBound_(false), useResult_(session.useResult_),
+       endOfStream_(false)
 {
 }
 
@@ -36,6 +73,17 @@ void mysql_statement_backend::alloc()
 }
 
 void mysql_statement_backend::clean_up()
+{
+    free_result();
+
+    if (stmt_ != NULL)
+    {
+        mysql_stmt_close(stmt_);
+        stmt_ = NULL;
+    }
+}
+
+void mysql_statement_backend::free_result()
 {
     // 'reset' the value for a 
     // potential new execution.
@@ -46,6 +94,12 @@ void mysql_statement_backend::clean_up()
         mysql_free_result(result_);
         result_ = NULL;
     }
+
+    if (stmt_ != NULL)
+    {
+        mysql_stmt_free_result(stmt_);
+    }
+    resultBound_ = false;
 }
 
 void mysql_statement_backend::prepare(std::string const & query,
@@ -122,6 +176,41 @@ void mysql_statement_backend::prepare(std::string const & query,
     {
         names_.push_back(name);
     }
+
+    if (session_.preparedStatements_)
+    {
+        // the named parameters are replaced with the placeholders
+        std::string preparedQuery;
+        for (std::size_t i = 0; i != queryChunks_.size(); ++i)
+        {
+            preparedQuery += queryChunks_[i];
+            if (i < names_.size())
+            {
+                preparedQuery += '?';
+            }
+        }
+
+        stmt_ = mysql_stmt_init(session_.conn_);
+        if (stmt_ == NULL)
+        {
+            throw soci_error("mysql_stmt_init() failed.");
+        }
+        if (0 != mysql_stmt_prepare(stmt_, preparedQuery.c_str(),
+                static_cast<unsigned long>(preparedQuery.size())))
+        {
+            std::string errMsg = mysql_stmt_error(stmt_);
+            unsigned int errNum = mysql_stmt_errno(stmt_);
+            mysql_stmt_close(stmt_);
+            stmt_ = NULL;
+
+            // the statements which can't be prepared on the server
+            // (ER_UNSUPPORTED_PS) are sent as text queries instead
+            if (errNum != 1295)
+            {
+                throw mysql_soci_error(errMsg, errNum);
+            }
+        }
+    }
 /*
   cerr << "Chunks: ";
   for (std::vector<std::string>::iterator i = queryChunks_.begin();
@@ -142,9 +231,13 @@ void mysql_statement_backend::prepare(std::string const & query,
 statement_backend::exec_fetch_result
 mysql_statement_backend::execute(int number)
 {
-    if (justDescribed_ == false)
+    if (justDescribed_ == false && stmt_ != NULL)
     {
-        clean_up();
+        execute_prepared(number);
+    }
+    else if (justDescribed_ == false)
+    {
+        free_result();
         
         if (number > 1 && hasIntoElements_)
         {
@@ -275,17 +368,19 @@ mysql_statement_backend::execute(int number)
             throw mysql_soci_error(mysql_error(session_.conn_),
                 mysql_errno(session_.conn_));
         }
-        result_ = mysql_store_result(session_.conn_);
+        result_ = useResult_ ? mysql_use_result(session_.conn_)
+                             : mysql_store_result(session_.conn_);
         if (result_ == NULL and mysql_field_count(session_.conn_) != 0)
         {
             throw mysql_soci_error(mysql_error(session_.conn_),
                 mysql_errno(session_.conn_));
         }
-        if (result_ != NULL)
+        if (result_ != NULL and not useResult_)
         {
             // Cache the rows offsets to have random access to the rows later.
             // [mysql_data_seek() is O(n) so we don't want to use it].
             int numrows = static_cast<int>(mysql_num_rows(result_));
+            numberOfRows_ = numrows;
             resultRowOffsets_.resize(numrows);
             for (int i = 0; i < numrows; i++)
             {
@@ -304,7 +399,13 @@ mysql_statement_backend::execute(int number)
         currentRow_ = 0;
         rowsToConsume_ = 0;
 
-        numberOfRows_ = static_cast<int>(mysql_num_rows(result_));
+        if (useResult_)
+        {
+            // the number of rows is not known until all of them are read
+            endOfStream_ = false;
+            return number > 0 ? fetch(number) : ef_success;
+        }
+
         if (numberOfRows_ == 0)
         {
             return ef_no_data;
@@ -330,6 +431,319 @@ mysql_statement_backend::execute(int number)
     }
 }
 
+void mysql_statement_backend::execute_prepared(int number)
+{
+    free_result();
+
+    if (number > 1 && hasIntoElements_)
+    {
+         throw soci_error(
+              "Bulk use with single into elements is not supported.");
+    }
+    int numberOfExecutions = 1;
+    if (number > 0)
+    {
+         numberOfExecutions = hasUseElements_ ? 1 : number;
+    }
+
+    if (not useByPosBinds_.empty() and not useByNameBinds_.empty())
+    {
+        throw soci_error(
+            "Binding for use elements must be either by position "
+            "or by name.");
+    }
+
+    // the same prepared statement is executed for every row of the
+    // use elements, only the bindings of the parameters change
+    unsigned long const paramCount = mysql_stmt_param_count(stmt_);
+    long long rowsAffectedBulkTemp = 0;
+    for (int i = 0; i != numberOfExecutions; ++i)
+    {
+        paramBinds_.clear();
+        if (not useByPosBinds_.empty())
+        {
+            for (UseByPosBindsMap::iterator it = useByPosBinds_.begin(),
+                     end = useByPosBinds_.end();
+                 it != end; ++it)
+            {
+                paramBinds_.push_back(it->second[i]);
+            }
+        }
+        else if (not useByNameBinds_.empty())
+        {
+            for (std::vector<std::string>::iterator
+                     it = names_.begin(), end = names_.end();
+                 it != end; ++it)
+            {
+                UseByNameBindsMap::iterator b = useByNameBinds_.find(*it);
+                if (b == useByNameBinds_.end())
+                {
+                    std::string msg(
+                        "Missing use element for bind by name (");
+                    msg += *it;
+                    msg += ").";
+                    throw soci_error(msg);
+                }
+                paramBinds_.push_back(b->second[i]);
+            }
+        }
+
+        if (paramBinds_.size() != paramCount)
+        {
+            throw soci_error("Wrong number of parameters.");
+        }
+        if (paramCount != 0 &&
+            mysql_stmt_bind_param(stmt_, &paramBinds_[0]))
+        {
+            throw_stmt_error(stmt_);
+        }
+
+        if (0 != mysql_stmt_execute(stmt_))
+        {
+            if (numberOfExecutions > 1)
+            {
+                // preserve the number of rows affected so far.
+                rowsAffectedBulk_ = rowsAffectedBulkTemp;
+            }
+            throw_stmt_error(stmt_);
+        }
+
+        if (numberOfExecutions > 1)
+        {
+            rowsAffectedBulkTemp += static_cast<long long>(
+                mysql_stmt_affected_rows(stmt_));
+            if (mysql_stmt_field_count(stmt_) != 0)
+            {
+                throw soci_error("The query shouldn't have returned"
+                    " any data but it did.");
+            }
+        }
+    }
+    if (numberOfExecutions > 1)
+    {
+        rowsAffectedBulk_ = rowsAffectedBulkTemp;
+        return;
+    }
+
+    if (mysql_stmt_field_count(stmt_) != 0)
+    {
+        // unless streaming, the rows are retrieved from the server at once,
+        // like in the text mode, but they are converted to the bound types
+        // only when fetched
+        if (not useResult_ and 0 != mysql_stmt_store_result(stmt_))
+        {
+            throw_stmt_error(stmt_);
+        }
+        result_ = mysql_stmt_result_metadata(stmt_);
+        if (result_ == NULL)
+        {
+            throw_stmt_error(stmt_);
+        }
+        numberOfRows_ = static_cast<int>(mysql_stmt_num_rows(stmt_));
+    }
+}
+
+void mysql_statement_backend::bind_result()
+{
+    unsigned int const columns = mysql_stmt_field_count(stmt_);
+    resultBinds_.resize(columns);
+    std::memset(&resultBinds_[0], 0, columns * sizeof(MYSQL_BIND));
+    for (unsigned int i = 0; i != columns; ++i)
+    {
+        // the columns without into elements are skipped
+        MYSQL_BIND &bind = resultBinds_[i];
+        bind.buffer_type = MYSQL_TYPE_NULL;
+        bind.is_null = &bind.is_null_value;
+        bind.length = &bind.length_value;
+        bind.error = &bind.error_value;
+    }
+
+    for (ResultColumnsMap::iterator it = resultColumns_.begin(),
+             end = resultColumns_.end();
+         it != end; ++it)
+    {
+        int const pos = it->first - 1;
+        if (pos < 0 || pos >= static_cast<int>(columns))
+        {
+            throw soci_error("Into element used with non-existent column.");
+        }
+
+        mysql_result_column &column = *it->second;
+        MYSQL_BIND &bind = resultBinds_[pos];
+        switch (column.type_)
+        {
+        case x_char:
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            bind.buffer = column.char_;
+            bind.buffer_length = sizeof(column.char_);
+            break;
+        case x_stdstring:
+            // the length is only known after fetching the row, the value
+            // is then read directly into the string
+            bind.buffer_type = MYSQL_TYPE_STRING;
+            break;
+        case x_short:
+        case x_integer:
+        case x_long_long:
+            bind.buffer_type = MYSQL_TYPE_LONGLONG;
+            bind.buffer = &column.integer_;
+            break;
+        case x_unsigned_long_long:
+            bind.buffer_type = MYSQL_TYPE_LONGLONG;
+            bind.buffer = &column.integer_;
+            bind.is_unsigned = 1;
+            break;
+        case x_double:
+            bind.buffer_type = MYSQL_TYPE_DOUBLE;
+            bind.buffer = &column.double_;
+            break;
+        case x_stdtm:
+            bind.buffer_type = MYSQL_TYPE_DATETIME;
+            bind.buffer = &column.time_;
+            break;
+        default:
+            throw soci_error("Into element used with non-supported type.");
+        }
+    }
+
+    if (mysql_stmt_bind_result(stmt_, &resultBinds_[0]))
+    {
+        throw_stmt_error(stmt_);
+    }
+    resultBound_ = true;
+}
+
+bool mysql_statement_backend::fetch_row(int row)
+{
+    if (resultBound_ == false)
+    {
+        bind_result();
+    }
+
+    // MYSQL_DATA_TRUNCATED is expected, as the strings are read separately
+    int const res = mysql_stmt_fetch(stmt_);
+    if (res == 1)
+    {
+        throw_stmt_error(stmt_);
+    }
+    if (res == MYSQL_NO_DATA)
+    {
+        return false;
+    }
+
+    for (ResultColumnsMap::iterator it = resultColumns_.begin(),
+             end = resultColumns_.end();
+         it != end; ++it)
+    {
+        int const pos = it->first - 1;
+        mysql_result_column &column = *it->second;
+        MYSQL_BIND &bind = resultBinds_[pos];
+
+        if (static_cast<int>(column.indicators_.size()) <= row)
+        {
+            column.indicators_.resize(row + 1);
+        }
+        if (*bind.is_null)
+        {
+            column.indicators_[row] = i_null;
+            continue;
+        }
+        column.indicators_[row] = i_ok;
+
+        if (*bind.error && column.type_ != x_char &&
+            column.type_ != x_stdstring)
+        {
+            throw soci_error("Cannot convert data.");
+        }
+
+        switch (column.type_)
+        {
+        case x_char:
+            target<char>(column, row) = column.char_[0];
+            break;
+        case x_stdstring:
+            {
+                std::string &dest = target<std::string>(column, row);
+                unsigned long const length = *bind.length;
+                dest.resize(length);
+                if (length != 0)
+                {
+                    MYSQL_BIND value;
+                    std::memset(&value, 0, sizeof(value));
+                    value.buffer_type = MYSQL_TYPE_STRING;
+                    value.buffer = &dest[0];
+                    value.buffer_length = length;
+                    value.is_null = &value.is_null_value;
+                    value.length = &value.length_value;
+                    value.error = &value.error_value;
+                    if (mysql_stmt_fetch_column(stmt_, &value, pos, 0))
+                    {
+                        throw_stmt_error(stmt_);
+                    }
+                }
+            }
+            break;
+        case x_short:
+            target<short>(column, row) = narrow<short>(column.integer_);
+            break;
+        case x_integer:
+            target<int>(column, row) = narrow<int>(column.integer_);
+            break;
+        case x_long_long:
+            target<long long>(column, row) = column.integer_;
+            break;
+        case x_unsigned_long_long:
+            target<unsigned long long>(column, row) =
+                static_cast<unsigned long long>(column.integer_);
+            break;
+        case x_double:
+            target<double>(column, row) = column.double_;
+            break;
+        case x_stdtm:
+            mysql_time_to_std_tm(column.time_, target<std::tm>(column, row));
+            break;
+        default:
+            throw soci_error("Into element used with non-supported type.");
+        }
+    }
+
+    return true;
+}
+
+void mysql_statement_backend::copy_streamed_row(MYSQL_ROW row)
+{
+    unsigned int const columns = mysql_num_fields(result_);
+    unsigned long *lengths = mysql_fetch_lengths(result_);
+    for (unsigned int i = 0; i != columns; ++i)
+    {
+        if (row[i] == NULL)
+        {
+            streamedOffsets_.push_back(-1);
+            streamedLengths_.push_back(0);
+        }
+        else
+        {
+            streamedOffsets_.push_back(static_cast<long>(streamedData_.size()));
+            streamedLengths_.push_back(lengths[i]);
+            streamedData_.insert(streamedData_.end(),
+                row[i], row[i] + lengths[i]);
+            streamedData_.push_back('\0');
+        }
+    }
+}
+
+char const * mysql_statement_backend::streamed_value(int row, int pos,
+    unsigned long &length)
+{
+    std::size_t const i = row * mysql_num_fields(result_) + pos;
+    if (streamedOffsets_[i] < 0)
+    {
+        return NULL;
+    }
+    length = streamedLengths_[i];
+    return &streamedData_[streamedOffsets_[i]];
+}
+
 statement_backend::exec_fetch_result
 mysql_statement_backend::fetch(int number)
 {
@@ -342,6 +756,11 @@ mysql_statement_backend::fetch(int number)
     // forward the "cursor" from the last fetch
     currentRow_ += rowsToConsume_;
 
+    if (useResult_)
+    {
+        return fetch_streamed(number);
+    }
+
     if (currentRow_ >= numberOfRows_)
     {
         // all rows were already consumed
@@ -349,6 +768,7 @@ mysql_statement_backend::fetch(int number)
     }
     else
     {
+        exec_fetch_result res;
         if (currentRow_ + number > numberOfRows_)
         {
             rowsToConsume_ = numberOfRows_ - currentRow_;
@@ -356,27 +776,99 @@ mysql_statement_backend::fetch(int number)
             // this simulates the behaviour of Oracle
             // - when EOF is hit, we return ef_no_data even when there are
             // actually some rows fetched
-            return ef_no_data;
+            res = ef_no_data;
         }
         else
         {
             rowsToConsume_ = number;
-            return ef_success;
+            res = ef_success;
+        }
+
+        // in the prepared statement mode the rows are consumed right here,
+        // they are read sequentially from the statement handle
+        if (stmt_ != NULL)
+        {
+            for (int i = 0; i != rowsToConsume_; ++i)
+            {
+                fetch_row(i);
+            }
         }
+
+        return res;
     }
 }
 
+statement_backend::exec_fetch_result
+mysql_statement_backend::fetch_streamed(int number)
+{
+    // In the streaming mode the rows are read from the server right here
+    // and the rows of the chunk are kept until the next fetch.
+    rowsToConsume_ = 0;
+    if (stmt_ == NULL)
+    {
+        streamedData_.clear();
+        streamedOffsets_.clear();
+        streamedLengths_.clear();
+    }
+
+    while (not endOfStream_ and rowsToConsume_ != number)
+    {
+        if (stmt_ != NULL)
+        {
+            if (fetch_row(rowsToConsume_) == false)
+            {
+                endOfStream_ = true;
+                break;
+            }
+        }
+        else
+        {
+            MYSQL_ROW row = mysql_fetch_row(result_);
+            if (row == NULL)
+            {
+                if (mysql_errno(session_.conn_) != 0)
+                {
+                    throw mysql_soci_error(mysql_error(session_.conn_),
+                        mysql_errno(session_.conn_));
+                }
+                endOfStream_ = true;
+                break;
+            }
+            copy_streamed_row(row);
+        }
+        ++rowsToConsume_;
+    }
+
+    // as with the stored results, ef_no_data is returned when the end of
+    // the rows is hit even when some rows were fetched
+    return rowsToConsume_ == number ? ef_success : ef_no_data;
+}
+
 long long mysql_statement_backend::get_affected_rows()
 {
     if (rowsAffectedBulk_ >= 0)
     {
         return rowsAffectedBulk_;
     }
+    if (stmt_ != NULL)
+    {
+        return static_cast<long long>(mysql_stmt_affected_rows(stmt_));
+    }
     return static_cast<long long>(mysql_affected_rows(session_.conn_));
 }
 
+void mysql_statement_backend::set_use_result(bool enable)
+{
+    useResult_ = enable;
+}
+
 int mysql_statement_backend::get_number_of_rows()
 {
+    if (useResult_)
+    {
+        // only the rows of the current chunk are known
+        return rowsToConsume_;
+    }
     return numberOfRows_ - currentRow_;
 }
 
@@ -390,7 +882,18 @@ std::string mysql_statement_backend::rewrite_for_procedure_call(
 
 int mysql_statement_backend::prepare_for_describe()
 {
-    execute(1);
+    if (stmt_ != NULL)
+    {
+        // don't fetch anything before the into elements for the row are
+        // defined, the first row will be fetched by the next execute()
+        execute(0);
+        justDescribed_ = true;
+
+        return static_cast<int>(mysql_stmt_field_count(stmt_));
+    }
+
+    // the streamed rows can't be read again by the next execute()
+    execute(useResult_ ? 0 : 1);
     justDescribed_ = true;
 
     int columns = mysql_field_count(session_.conn_);
@@ -451,6 +954,42 @@ void mysql_statement_backend::describe_column(int colNum,
     columnName = field->name;
 }
 
+bool mysql_statement_backend::reset_for_reuse()
+{
+    // keep the query chunks and names and the prepared statement,
+    // forget everything else
+    free_result();
+    resultRowOffsets_.clear();
+    justDescribed_ = false;
+    useResult_ = session_.useResult_;
+
+    hasIntoElements_ = false;
+    hasVectorIntoElements_ = false;
+    hasUseElements_ = false;
+    hasVectorUseElements_ = false;
+
+    useByPosBuffers_.clear();
+    useByNameBuffers_.clear();
+
+    useByPosBinds_.clear();
+    useByNameBinds_.clear();
+    resultColumns_.clear();
+
+    return true;
+}
+
+void mysql_statement_backend::reuse_into_type_backend(
+    details::standard_into_type_backend * /* backEnd */)
+{
+    hasIntoElements_ = true;
+}
+
+void mysql_statement_backend::reuse_use_type_backend(
+    details::standard_use_type_backend * /* backEnd */)
+{
+    hasUseElements_ = true;
+}
+
 mysql_standard_into_type_backend *
 mysql_statement_backend::make_into_type_backend()
 {
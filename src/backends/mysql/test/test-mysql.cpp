@@ -851,6 +851,283 @@ void test15()
     std::cout << "test 15 passed" << std::endl;
 }
 
+// prepared statements and the binary protocol
+struct prepared_table_creator : table_creator_base
+{
+    prepared_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, sh smallint, "
+            "ll bigint, ull bigint unsigned, d double, n numeric(10, 2), "
+            "c char(1), s varchar(100), b blob, t datetime)";
+    }
+};
+
+void test16()
+{
+    {
+        session sql(backEnd, connectString + " prepared_statements=1");
+        prepared_table_creator tableCreator(sql);
+
+        {
+            int id = 1;
+            short sh = -123;
+            long long ll = -123456789012345LL;
+            unsigned long long ull = 18446744073709551615ULL;
+            double d = 3.125;
+            char c = 'x';
+            std::string s = "Ala ma kota.";
+            std::string b("Ala\0ma\0kota", 11);
+            std::tm t = std::tm();
+            t.tm_year = 2014 - 1900;
+            t.tm_mon = 6;
+            t.tm_mday = 15;
+            t.tm_hour = 12;
+            t.tm_min = 34;
+            t.tm_sec = 56;
+
+            statement st = (sql.prepare << "insert into soci_test "
+                "(id, sh, ll, ull, d, n, c, s, b, t) values "
+                "(:id, :sh, :ll, :ull, :d, :d, :c, :s, :b, :t)",
+                use(id), use(sh), use(ll), use(ull), use(d), use(d),
+                use(c), use(s), use(b), use(t));
+            mysql_statement_backend *backend =
+                static_cast<mysql_statement_backend *>(st.get_backend());
+            assert(backend->stmt_ != NULL);
+            st.execute(true);
+            assert(st.get_affected_rows() == 1);
+
+            // the same server-side statement is executed again
+            MYSQL_STMT * const stmt = backend->stmt_;
+            id = 3;
+            sh = 456;
+            s = "Ala ma psa.";
+            st.execute(true);
+            assert(st.get_affected_rows() == 1);
+            assert(backend->stmt_ == stmt);
+
+            // the null values are sent as well
+            id = 2;
+            indicator ind = i_null;
+            statement st2 = (sql.prepare << "insert into soci_test (id, s) "
+                "values (:id, :s)", use(id), use(s, ind));
+            st2.execute(true);
+        }
+
+        int id;
+        short sh;
+        long long ll;
+        unsigned long long ull;
+        double d, n;
+        char c;
+        std::string s, b;
+        std::tm t;
+        sql << "select id, sh, ll, ull, d, n, c, s, b, t from soci_test "
+            "where id = 1",
+            into(id), into(sh), into(ll), into(ull), into(d), into(n),
+            into(c), into(s), into(b), into(t);
+        assert(id == 1);
+        assert(sh == -123);
+        assert(ll == -123456789012345LL);
+        assert(ull == 18446744073709551615ULL);
+        assert(d == 3.125);
+        assert(std::fabs(n - 3.125) < 0.01);
+        assert(c == 'x');
+        assert(s == "Ala ma kota.");
+        assert(b == std::string("Ala\0ma\0kota", 11));
+        assert(t.tm_year == 2014 - 1900);
+        assert(t.tm_mon == 6);
+        assert(t.tm_mday == 15);
+        assert(t.tm_hour == 12);
+        assert(t.tm_min == 34);
+        assert(t.tm_sec == 56);
+
+        sql << "select id, sh, s, t from soci_test where id = 3",
+            into(id), into(sh), into(s), into(t);
+        assert(id == 3);
+        assert(sh == 456);
+        assert(s == "Ala ma psa.");
+        assert(t.tm_mday == 15 && t.tm_sec == 56);
+
+        indicator ind;
+        sql << "select s from soci_test where id = 2", into(s, ind);
+        assert(ind == i_null);
+
+        try
+        {
+            sql << "select s from soci_test where id = 2", into(s);
+            assert(false);
+        }
+        catch (soci_error const &e)
+        {
+            assert(e.what() == std::string(
+                "Null value fetched and no indicator defined."));
+        }
+
+        // values out of the range of the into element type are rejected
+        try
+        {
+            sql << "select ll from soci_test where id = 1", into(sh);
+            assert(false);
+        }
+        catch (soci_error const &e)
+        {
+            assert(e.what() == std::string("Cannot convert data."));
+        }
+
+        // bulk operations
+        sql << "delete from soci_test";
+
+        std::vector<int> ids;
+        std::vector<std::string> strings;
+        std::vector<indicator> inds;
+        for (int i = 0; i != 100; ++i)
+        {
+            ids.push_back(i);
+            std::ostringstream ss;
+            ss << "value " << i;
+            strings.push_back(ss.str());
+            inds.push_back(i % 10 == 0 ? i_null : i_ok);
+        }
+        statement st = (sql.prepare << "insert into soci_test (id, s) "
+            "values (:id, :s)", use(ids), use(strings, inds));
+        st.execute(true);
+        assert(st.get_affected_rows() == 100);
+
+        std::vector<int> ids2(30);
+        std::vector<std::string> strings2(30);
+        std::vector<indicator> inds2(30);
+        statement st2 = (sql.prepare << "select id, s from soci_test "
+            "order by id", into(ids2), into(strings2, inds2));
+        st2.execute();
+        int count = 0;
+        while (st2.fetch())
+        {
+            for (std::size_t i = 0; i != ids2.size(); ++i, ++count)
+            {
+                assert(ids2[i] == count);
+                if (count % 10 == 0)
+                {
+                    assert(inds2[i] == i_null);
+                }
+                else
+                {
+                    assert(inds2[i] == i_ok);
+                    assert(strings2[i] == strings[count]);
+                }
+            }
+        }
+        assert(count == 100);
+
+        // dynamic rows
+        rowset<row> rs = (sql.prepare << "select id, s from soci_test "
+            "where id between 1 and 3 order by id");
+        count = 0;
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end();
+             ++it, ++count)
+        {
+            assert(it->get<int>(0) == count + 1);
+            assert(it->get<std::string>(1) == strings[count + 1]);
+        }
+        assert(count == 3);
+
+        // the statements which can't be prepared are still executed
+        sql << "lock tables soci_test write";
+        sql << "unlock tables";
+    }
+
+    std::cout << "test 16 passed" << std::endl;
+}
+
+// streaming results with mysql_use_result()
+void test17()
+{
+    {
+        session sql(backEnd, connectString + " use_result=1");
+        integer_value_table_creator tableCreator(sql);
+
+        std::vector<int> values;
+        for (int i = 0; i != 100; ++i)
+        {
+            values.push_back(i);
+        }
+        sql << "insert into soci_test (val) values (:val)", use(values);
+
+        // bulk fetch in chunks
+        std::vector<int> v(30);
+        statement st = (sql.prepare << "select val from soci_test "
+            "order by val", into(v));
+        st.execute();
+        int count = 0;
+        while (st.fetch())
+        {
+            for (std::size_t i = 0; i != v.size(); ++i, ++count)
+            {
+                assert(v[i] == count);
+            }
+        }
+        assert(count == 100);
+
+        // single rows with an indicator
+        int val;
+        indicator ind;
+        statement st2 = (sql.prepare << "select val from soci_test "
+            "where val < 10 order by val", into(val, ind));
+        st2.execute();
+        count = 0;
+        while (st2.fetch())
+        {
+            assert(ind == i_ok);
+            assert(val == count);
+            ++count;
+        }
+        assert(count == 10);
+
+        // dynamic rows
+        rowset<row> rs = (sql.prepare << "select val from soci_test "
+            "order by val");
+        count = 0;
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end();
+             ++it, ++count)
+        {
+            assert(it->get<int>(0) == count);
+        }
+        assert(count == 100);
+    }
+
+    {
+        // the streaming can also be selected for a single statement
+        session sql(backEnd,
+            connectString + " prepared_statements=1");
+        integer_value_table_creator tableCreator(sql);
+
+        std::vector<int> values;
+        for (int i = 0; i != 100; ++i)
+        {
+            values.push_back(i);
+        }
+        sql << "insert into soci_test (val) values (:val)", use(values);
+
+        std::vector<int> v(40);
+        statement st = (sql.prepare << "select val from soci_test "
+            "order by val", into(v));
+        static_cast<mysql_statement_backend *>(st.get_backend())
+            ->set_use_result(true);
+        st.execute();
+        int count = 0;
+        while (st.fetch())
+        {
+            for (std::size_t i = 0; i != v.size(); ++i, ++count)
+            {
+                assert(v[i] == count);
+            }
+        }
+        assert(count == 100);
+    }
+
+    std::cout << "test 17 passed" << std::endl;
+}
+
 // DDL Creation objects for common tests
 struct table_creator_one : public table_creator_base
 {
@@ -989,6 +1266,8 @@ int main(int argc, char** argv)
         test13();
         test14();
         test15();
+        test16();
+        test17();
 
         std::cout << "\nOK, all tests passed.\n\n";
         return EXIT_SUCCESS;
@@ -28,6 +28,11 @@ void mysql_vector_into_type_backend::define_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+
+    column_.data_ = data_;
+    column_.type_ = type_;
+    column_.vector_ = true;
+    statement_.resultColumns_[position_] = &column_;
 }
 
 void mysql_vector_into_type_backend::pre_fetch()
@@ -52,7 +57,23 @@ void set_invector_(void *p, int indx, T const &val)
 
 void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
 {
-    if (gotData)
+    if (gotData && statement_.stmt_ != NULL)
+    {
+        // the values were already stored when the rows were fetched
+        for (int i = 0; i != statement_.rowsToConsume_; ++i)
+        {
+            if (column_.indicators_[i] == i_null && ind == NULL)
+            {
+                throw soci_error(
+                    "Null value fetched and no indicator defined.");
+            }
+            if (ind != NULL)
+            {
+                ind[i] = column_.indicators_[i];
+            }
+        }
+    }
+    else if (gotData)
     {
         // Here, rowsToConsume_ in the Statement object designates
         // the number of rows that need to be put in the user's buffers.
@@ -63,14 +84,32 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
         int const endRow = statement_.currentRow_ + statement_.rowsToConsume_;
 
         //mysql_data_seek(statement_.result_, statement_.currentRow_);
-        mysql_row_seek(statement_.result_,
-            statement_.resultRowOffsets_[statement_.currentRow_]);
+        if (statement_.useResult_ == false)
+        {
+            mysql_row_seek(statement_.result_,
+                statement_.resultRowOffsets_[statement_.currentRow_]);
+        }
         for (int curRow = statement_.currentRow_, i = 0;
              curRow != endRow; ++curRow, ++i)
         {
-            MYSQL_ROW row = mysql_fetch_row(statement_.result_);
+            char const *value;
+            unsigned long length = 0;
+            if (statement_.useResult_)
+            {
+                value = statement_.streamed_value(i, pos, length);
+            }
+            else
+            {
+                MYSQL_ROW row = mysql_fetch_row(statement_.result_);
+                value = row[pos];
+                if (value != NULL && type_ == x_stdstring)
+                {
+                    length = mysql_fetch_lengths(statement_.result_)[pos];
+                }
+            }
+
             // first, deal with indicators
-            if (row[pos] == NULL)
+            if (value == NULL)
             {
                 if (ind == NULL)
                 {
@@ -92,7 +131,7 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
             }
 
             // buffer with data retrieved from server, in text format
-            const char *buf = row[pos] != NULL ? row[pos] : "";
+            const char *buf = value;
 
             switch (type_)
             {
@@ -101,15 +140,13 @@ void mysql_vector_into_type_backend::post_fetch(bool gotData, indicator *ind)
                 break;
             case x_stdstring:
                 {
-                    unsigned long * lengths =
-                        mysql_fetch_lengths(statement_.result_);
                     // Not sure if it's necessary, but the code below is used
                     // instead of
-                    // set_invector_(data_, i, std::string(buf, lengths[pos]);
+                    // set_invector_(data_, i, std::string(buf, length);
                     // to avoid copying the (possibly large) temporary string.
                     std::vector<std::string> *dest =
                         static_cast<std::vector<std::string> *>(data_);
-                    (*dest)[i].assign(buf, lengths[pos]);
+                    (*dest)[i].assign(buf, length);
                 }
                 break;
             case x_short:
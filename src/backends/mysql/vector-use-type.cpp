@@ -46,9 +46,74 @@ void mysql_vector_use_type_backend::bind_by_name(
     name_ = name;
 }
 
+namespace // anonymous
+{
+
+template <typename T>
+void * element_address(void *p, std::size_t i)
+{
+    std::vector<T> &v = *static_cast<std::vector<T> *>(p);
+    return &v[i];
+}
+
+} // namespace anonymous
+
 void mysql_vector_use_type_backend::pre_use(indicator const *ind)
 {
     std::size_t const vsize = size();
+
+    if (statement_.stmt_ != NULL)
+    {
+        // the values are sent in the binary form directly from the
+        // user's vector, one row per execution
+        binds_.resize(vsize);
+        times_.resize(vsize);
+        for (std::size_t i = 0; i != vsize; ++i)
+        {
+            MYSQL_BIND &bind = binds_[i];
+            std::memset(&bind, 0, sizeof(bind));
+            if (ind != NULL && ind[i] == i_null)
+            {
+                bind.buffer_type = MYSQL_TYPE_NULL;
+                continue;
+            }
+
+            void *data = NULL;
+            switch (type_)
+            {
+            case x_char:      data = element_address<char>(data_, i); break;
+            case x_short:     data = element_address<short>(data_, i); break;
+            case x_integer:   data = element_address<int>(data_, i); break;
+            case x_long_long: data = element_address<long long>(data_, i); break;
+            case x_unsigned_long_long:
+                data = element_address<unsigned long long>(data_, i);
+                break;
+            case x_double:    data = element_address<double>(data_, i); break;
+            case x_stdstring:
+                data = element_address<std::string>(data_, i);
+                break;
+            case x_stdtm:     data = element_address<std::tm>(data_, i); break;
+            default:
+                throw soci_error(
+                    "Use vector element used with non-supported type.");
+            }
+            bind_param(bind, times_[i], data, type_);
+        }
+
+        if (vsize != 0)
+        {
+            if (position_ > 0)
+            {
+                statement_.useByPosBinds_[position_] = &binds_[0];
+            }
+            else
+            {
+                statement_.useByNameBinds_[name_] = &binds_[0];
+            }
+        }
+        return;
+    }
+
     for (size_t i = 0; i != vsize; ++i)
     {
         char *buf;
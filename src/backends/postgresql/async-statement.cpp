@@ -0,0 +1,445 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_POSTGRESQL_SOURCE
+#include "soci-postgresql.h"
+#include <soci-platform.h>
+#include "session.h"
+#include <cstdlib>
+
+using namespace soci;
+using namespace soci::details;
+
+namespace // unnamed
+{
+
+postgresql_session_backend & get_session_backend(session & sql)
+{
+    postgresql_session_backend * const backend =
+        dynamic_cast<postgresql_session_backend *>(sql.get_backend());
+    if (backend == NULL)
+    {
+        throw soci_error("The session doesn't use the PostgreSQL backend.");
+    }
+
+    return *backend;
+}
+
+} // namespace unnamed
+
+postgresql_async_statement::postgresql_async_statement(session & sql,
+    std::string const & query)
+    : session_(get_session_backend(sql)), query_(query), state_(idle),
+      wantsWrite_(false), cancelled_(false), pending_(NULL), callback_(NULL), arg_(NULL),
+      failed_(false)
+{
+}
+
+postgresql_async_statement::~postgresql_async_statement()
+{
+    PGconn * const conn = session_.conn_;
+
+    if (state_ != idle)
+    {
+        if (cancelled_ == false)
+        {
+            cancel();
+        }
+
+        // PQgetResult() waits for the rest of the results in both modes
+        if (pending_ == NULL)
+        {
+            pending_ = PQgetResult(conn);
+        }
+        while (PGresult * res = PQgetResult(conn))
+        {
+            PQclear(res);
+        }
+
+        if (state_ == preparing && PQresultStatus(pending_) != PGRES_COMMAND_OK)
+        {
+            statementName_.clear();
+        }
+        PQclear(pending_);
+
+        PQsetnonblocking(conn, 0);
+    }
+
+    if (statementName_.empty() == false)
+    {
+        try
+        {
+            session_.deallocate_prepared_statement(statementName_);
+        }
+        catch (...)
+        {
+            // Don't allow exceptions to escape from dtor, the statement
+            // remains prepared until the end of the session then.
+        }
+    }
+}
+
+void postgresql_async_statement::set_param(int position,
+    std::string const & value)
+{
+    if (position < 1)
+    {
+        throw soci_error("Invalid parameter position.");
+    }
+
+    if (static_cast<std::size_t>(position) > values_.size())
+    {
+        values_.resize(position);
+        nulls_.resize(position, true);
+    }
+
+    values_[position - 1] = value;
+    nulls_[position - 1] = false;
+}
+
+void postgresql_async_statement::set_null_param(int position)
+{
+    if (position < 1)
+    {
+        throw soci_error("Invalid parameter position.");
+    }
+
+    if (static_cast<std::size_t>(position) > values_.size())
+    {
+        values_.resize(position);
+        nulls_.resize(position, true);
+    }
+
+    nulls_[position - 1] = true;
+}
+
+void postgresql_async_statement::clear_params()
+{
+    values_.clear();
+    nulls_.clear();
+}
+
+void postgresql_async_statement::execute(callback cb, void * arg)
+{
+    if (state_ != idle)
+    {
+        throw soci_error("The statement is already being executed.");
+    }
+
+    PGconn * const conn = session_.conn_;
+
+    result_.reset();
+    cancelled_ = false;
+    failed_ = false;
+    error_.clear();
+    sqlstate_.clear();
+    callback_ = cb;
+    arg_ = arg;
+
+    // the session is switched back to the blocking mode by finish()
+    if (PQsetnonblocking(conn, 1) != 0)
+    {
+        throw soci_error(PQerrorMessage(conn));
+    }
+
+    try
+    {
+        if (statementName_.empty())
+        {
+            std::string const statementName =
+                session_.get_next_statement_name();
+            if (PQsendPrepare(conn, statementName.c_str(), query_.c_str(),
+                    0, NULL) != 1)
+            {
+                throw soci_error(PQerrorMessage(conn));
+            }
+
+            statementName_ = statementName;
+            state_ = preparing;
+
+            int const cc = PQflush(conn);
+            if (cc == -1)
+            {
+                throw soci_error(PQerrorMessage(conn));
+            }
+            wantsWrite_ = cc == 1;
+        }
+        else
+        {
+            start_execution();
+        }
+    }
+    catch (...)
+    {
+        if (state_ == preparing)
+        {
+            // whether it was prepared is unknown, let the server tell
+            PGresult * res;
+            while ((res = PQgetResult(conn)) != NULL)
+            {
+                PQclear(res);
+            }
+            statementName_.clear();
+        }
+
+        state_ = idle;
+        wantsWrite_ = false;
+        PQsetnonblocking(conn, 0);
+        throw;
+    }
+}
+
+void postgresql_async_statement::start_execution()
+{
+    PGconn * const conn = session_.conn_;
+
+    int const count = static_cast<int>(values_.size());
+    paramValues_.resize(count);
+    for (int i = 0; i != count; ++i)
+    {
+        paramValues_[i] = nulls_[i] ? NULL : values_[i].c_str();
+    }
+
+    if (PQsendQueryPrepared(conn, statementName_.c_str(), count,
+            count != 0 ? &paramValues_[0] : NULL, NULL, NULL, 0) != 1)
+    {
+        throw soci_error(PQerrorMessage(conn));
+    }
+
+    state_ = executing;
+
+    int const cc = PQflush(conn);
+    if (cc == -1)
+    {
+        throw soci_error(PQerrorMessage(conn));
+    }
+    wantsWrite_ = cc == 1;
+}
+
+int postgresql_async_statement::get_socket() const
+{
+    return PQsocket(session_.conn_);
+}
+
+bool postgresql_async_statement::flush()
+{
+    if (state_ == idle)
+    {
+        return true;
+    }
+
+    int const cc = PQflush(session_.conn_);
+    if (cc == -1)
+    {
+        fail(PQerrorMessage(session_.conn_));
+        return true;
+    }
+
+    wantsWrite_ = cc == 1;
+    return false;
+}
+
+bool postgresql_async_statement::consume()
+{
+    if (state_ == idle)
+    {
+        return true;
+    }
+
+    PGconn * const conn = session_.conn_;
+
+    if (PQconsumeInput(conn) != 1)
+    {
+        fail(PQerrorMessage(conn));
+        return true;
+    }
+
+    // the server may need to read the rest of the query before sending
+    // anything back
+    if (wantsWrite_ && flush())
+    {
+        return true;
+    }
+
+    while (PQisBusy(conn) == 0)
+    {
+        PGresult * const res = PQgetResult(conn);
+        if (res != NULL)
+        {
+            // only the first result of the command is kept
+            if (pending_ == NULL)
+            {
+                pending_ = res;
+            }
+            else
+            {
+                PQclear(res);
+            }
+            continue;
+        }
+
+        // the command is complete
+        PGresult * const result = pending_;
+        pending_ = NULL;
+
+        if (state_ == preparing)
+        {
+            if (PQresultStatus(result) != PGRES_COMMAND_OK)
+            {
+                statementName_.clear();
+                complete(result, "Cannot prepare statement.");
+                return true;
+            }
+
+            PQclear(result);
+
+            try
+            {
+                start_execution();
+            }
+            catch (soci_error const & e)
+            {
+                fail(e.what());
+                return true;
+            }
+        }
+        else
+        {
+            complete(result, "Cannot execute query.");
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void postgresql_async_statement::cancel()
+{
+    if (state_ == idle)
+    {
+        return;
+    }
+
+    cancelled_ = true;
+
+    // the errors are irrelevant, the query may be complete already
+    if (PGcancel * cancel = PQgetCancel(session_.conn_))
+    {
+        char errbuf[256];
+        PQcancel(cancel, errbuf, sizeof(errbuf));
+        PQfreeCancel(cancel);
+    }
+}
+
+void postgresql_async_statement::complete(PGresult * result,
+    char const * errMsg)
+{
+    result_.reset(result);
+
+    try
+    {
+        result_.check_for_errors(errMsg);
+    }
+    catch (postgresql_soci_error const & e)
+    {
+        failed_ = true;
+        error_ = e.what();
+        sqlstate_ = e.sqlstate();
+    }
+
+    finish();
+}
+
+void postgresql_async_statement::fail(char const * msg)
+{
+    PQclear(pending_);
+    pending_ = NULL;
+    result_.reset();
+
+    failed_ = true;
+    error_ = msg;
+
+    finish();
+}
+
+void postgresql_async_statement::finish()
+{
+    state_ = idle;
+    wantsWrite_ = false;
+    PQsetnonblocking(session_.conn_, 0);
+
+    // the callback may execute the statement again
+    if (callback_ != NULL)
+    {
+        callback_(*this, arg_);
+    }
+}
+
+void postgresql_async_statement::check_done() const
+{
+    if (state_ != idle)
+    {
+        throw soci_error("The statement is being executed.");
+    }
+}
+
+int postgresql_async_statement::get_number_of_rows() const
+{
+    check_done();
+    return PQntuples(result_);
+}
+
+int postgresql_async_statement::get_number_of_columns() const
+{
+    check_done();
+    return PQnfields(result_);
+}
+
+std::string postgresql_async_statement::get_column_name(int column) const
+{
+    check_done();
+
+    if (column < 0 || column >= PQnfields(result_))
+    {
+        throw soci_error("Invalid column.");
+    }
+
+    return PQfname(result_, column);
+}
+
+bool postgresql_async_statement::is_null(int row, int column) const
+{
+    check_done();
+
+    if (row < 0 || row >= PQntuples(result_) ||
+        column < 0 || column >= PQnfields(result_))
+    {
+        throw soci_error("Invalid row or column.");
+    }
+
+    return PQgetisnull(result_, row, column) != 0;
+}
+
+std::string postgresql_async_statement::get_value(int row, int column) const
+{
+    if (is_null(row, column))
+    {
+        throw soci_error("Null value fetched and no indicator defined.");
+    }
+
+    return PQgetvalue(result_, row, column);
+}
+
+long long postgresql_async_statement::get_affected_rows() const
+{
+    check_done();
+
+    char const * const resultStr = PQcmdTuples(result_.get_result());
+    char * end;
+    long long const result = std::strtoll(resultStr, &end, 0);
+    return end != resultStr ? result : -1;
+}
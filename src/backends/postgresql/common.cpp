@@ -7,10 +7,16 @@
 
 #include <soci-platform.h>
 #include <soci-backend.h>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include "common.h"
 
+#ifdef _MSC_VER
+#define snprintf _snprintf
+#endif
+
 namespace // anonymous
 {
 
@@ -29,6 +35,183 @@ long parse10(char const * & p1, char * & p2, char const * msg)
     }
 }
 
+using namespace soci::details::postgresql;
+
+// number of days between 1970-01-01 and 2000-01-01, the PostgreSQL epoch
+long const postgresql_epoch_days = 10957;
+
+long long const usecs_per_day = 86400000000LL;
+
+// reads an integer stored in the network byte order
+unsigned long long read_unsigned(char const * buf, int len)
+{
+    unsigned long long v = 0;
+    for (int i = 0; i != len; ++i)
+    {
+        v = (v << 8) | static_cast<unsigned char>(buf[i]);
+    }
+    return v;
+}
+
+long long read_signed(char const * buf, int len)
+{
+    unsigned long long const v = read_unsigned(buf, len);
+    int const bits = 8 * len;
+    if (bits < 64 && (v >> (bits - 1)) != 0)
+    {
+        // negative value, extend the sign
+        return static_cast<long long>(v) - (1LL << bits);
+    }
+    return static_cast<long long>(v);
+}
+
+void check_length(int len, int expected)
+{
+    if (len != expected)
+    {
+        throw soci::soci_error("Cannot convert binary data.");
+    }
+}
+
+// returns the number of days since the PostgreSQL epoch for the given date
+long long date_to_days(long long year, long long month, long long day)
+{
+    // see http://howardhinnant.github.io/date_algorithms.html
+    year -= month <= 2 ? 1 : 0;
+    long long const era = (year >= 0 ? year : year - 399) / 400;
+    long long const yoe = year - era * 400;
+    long long const doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5
+        + day - 1;
+    long long const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + doe - 719468 - postgresql_epoch_days;
+}
+
+// splits the number of days since the PostgreSQL epoch into the date parts
+void days_to_date(long long days, long & year, long & month, long & day)
+{
+    // see http://howardhinnant.github.io/date_algorithms.html
+    long long const z = days + postgresql_epoch_days + 719468;
+    long long const era = (z >= 0 ? z : z - 146096) / 146097;
+    long long const doe = z - era * 146097;
+    long long const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long const mp = (5 * doy + 2) / 153;
+
+    day = static_cast<long>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<long>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<long>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+// splits the number of microseconds since the PostgreSQL epoch
+void usecs_to_parts(long long usecs, long long & days, long long & usecsOfDay)
+{
+    days = usecs / usecs_per_day;
+    usecsOfDay = usecs % usecs_per_day;
+    if (usecsOfDay < 0)
+    {
+        usecsOfDay += usecs_per_day;
+        --days;
+    }
+}
+
+void format_time_of_day(long long usecsOfDay, std::string & str)
+{
+    long long const secs = usecsOfDay / 1000000;
+    long const fraction = static_cast<long>(usecsOfDay % 1000000);
+
+    char buf[32];
+    std::sprintf(buf, "%02d:%02d:%02d",
+        static_cast<int>(secs / 3600), static_cast<int>(secs / 60 % 60),
+        static_cast<int>(secs % 60));
+    str += buf;
+
+    if (fraction != 0)
+    {
+        // PostgreSQL omits the trailing zeros of the fractional seconds
+        std::sprintf(buf, ".%06ld", fraction);
+        std::size_t n = std::strlen(buf);
+        while (buf[n - 1] == '0')
+        {
+            --n;
+        }
+        str.append(buf, n);
+    }
+}
+
+void format_date(long long days, std::string & str)
+{
+    long year, month, day;
+    days_to_date(days, year, month, day);
+
+    char buf[32];
+    std::sprintf(buf, "%04ld-%02ld-%02ld", year, month, day);
+    str += buf;
+}
+
+// formats the binary numeric value in the same way as PostgreSQL does
+void format_numeric(char const * buf, int len, std::string & str)
+{
+    if (len < 8)
+    {
+        throw soci::soci_error("Cannot convert binary data.");
+    }
+
+    int const ndigits = static_cast<int>(read_signed(buf, 2));
+    int const weight = static_cast<int>(read_signed(buf + 2, 2));
+    unsigned long const sign = static_cast<unsigned long>(read_unsigned(buf + 4, 2));
+    int const dscale = static_cast<int>(read_signed(buf + 6, 2));
+
+    check_length(len, 8 + 2 * ndigits);
+
+    switch (sign)
+    {
+    case 0xC000:
+        str = "NaN";
+        return;
+    case 0xD000:
+        str = "Infinity";
+        return;
+    case 0xF000:
+        str = "-Infinity";
+        return;
+    }
+
+    str.clear();
+    if (sign == 0x4000)
+    {
+        str += '-';
+    }
+
+    // each digit holds 4 decimal digits, the first one has the given weight
+    char group[8];
+    if (weight < 0)
+    {
+        str += '0';
+    }
+    for (int d = 0; d <= weight; ++d)
+    {
+        int const digit = d < ndigits
+            ? static_cast<int>(read_signed(buf + 8 + 2 * d, 2)) : 0;
+        std::sprintf(group, d == 0 ? "%d" : "%04d", digit);
+        str += group;
+    }
+
+    if (dscale > 0)
+    {
+        str += '.';
+        std::size_t const end = str.size() + dscale;
+        for (int d = weight + 1; str.size() < end; ++d)
+        {
+            int const digit = d >= 0 && d < ndigits
+                ? static_cast<int>(read_signed(buf + 8 + 2 * d, 2)) : 0;
+            std::sprintf(group, "%04d", digit);
+            str += group;
+        }
+        str.resize(end);
+    }
+}
+
 } // namespace anonymous
 
 
@@ -109,3 +292,371 @@ double soci::details::postgresql::string_to_double(char const * buf)
         throw soci_error("Cannot convert data.");
     }
 }
+
+bool soci::details::postgresql::is_binary_result_type(unsigned long typeOid)
+{
+    switch (typeOid)
+    {
+    case oid_bool:
+    case oid_int2:
+    case oid_int4:
+    case oid_int8:
+    case oid_oid:
+    case oid_float4:
+    case oid_float8:
+    case oid_numeric:
+    case oid_date:
+    case oid_time:
+    case oid_timestamp:
+    case oid_timestamptz:
+    // the binary representation of the textual types is their text
+    case oid_char:
+    case oid_name:
+    case oid_text:
+    case oid_unknown:
+    case oid_bpchar:
+    case oid_varchar:
+    // returned as raw bytes
+    case oid_bytea:
+        return true;
+    default:
+        return false;
+    }
+}
+
+char soci::details::postgresql::binary_to_char(unsigned long typeOid,
+    char const * buf, int len)
+{
+    if (typeOid == oid_bool)
+    {
+        check_length(len, 1);
+        return buf[0] != 0 ? 't' : 'f';
+    }
+
+    // the first character of the text representation, as in the text format
+    std::string str;
+    binary_to_string(typeOid, buf, len, str);
+    return str.empty() ? '\0' : str[0];
+}
+
+bool soci::details::postgresql::binary_to_long_long(unsigned long typeOid,
+    char const * buf, int len, long long & val)
+{
+    switch (typeOid)
+    {
+    case oid_bool:
+        check_length(len, 1);
+        val = buf[0] != 0 ? 1 : 0;
+        return true;
+    case oid_int2:
+        check_length(len, 2);
+        val = read_signed(buf, 2);
+        return true;
+    case oid_int4:
+        check_length(len, 4);
+        val = read_signed(buf, 4);
+        return true;
+    case oid_int8:
+        check_length(len, 8);
+        val = read_signed(buf, 8);
+        return true;
+    case oid_oid:
+        check_length(len, 4);
+        val = static_cast<long long>(read_unsigned(buf, 4));
+        return true;
+    default:
+        // not an integral type
+        return false;
+    }
+}
+
+double soci::details::postgresql::binary_to_double(unsigned long typeOid,
+    char const * buf, int len)
+{
+    switch (typeOid)
+    {
+    case oid_float8:
+        {
+            check_length(len, 8);
+            unsigned long long const bits = read_unsigned(buf, 8);
+            double val;
+            std::memcpy(&val, &bits, sizeof(val));
+            return val;
+        }
+    case oid_float4:
+        {
+            check_length(len, 4);
+            unsigned long const bits32 =
+                static_cast<unsigned long>(read_unsigned(buf, 4));
+            unsigned int const bits = static_cast<unsigned int>(bits32);
+            float val;
+            std::memcpy(&val, &bits, sizeof(val));
+            return val;
+        }
+    case oid_numeric:
+        {
+            std::string str;
+            format_numeric(buf, len, str);
+            return string_to_double(str.c_str());
+        }
+    default:
+        {
+            long long val;
+            if (binary_to_long_long(typeOid, buf, len, val))
+            {
+                return static_cast<double>(val);
+            }
+
+            // libpq terminates all values with a null character
+            return string_to_double(buf);
+        }
+    }
+}
+
+void soci::details::postgresql::binary_to_std_tm(unsigned long typeOid,
+    char const * buf, int len, std::tm & t)
+{
+    long long days = 0;
+    long long usecsOfDay = 0;
+    long year = 1900, month = 1, day = 1;
+
+    switch (typeOid)
+    {
+    case oid_date:
+        check_length(len, 4);
+        days = read_signed(buf, 4);
+        if (days == 0x7FFFFFFFLL || days == -0x80000000LL)
+        {
+            throw soci_error("Cannot convert infinite date to std::tm.");
+        }
+        days_to_date(days, year, month, day);
+        break;
+    case oid_timestamp:
+    case oid_timestamptz:
+        {
+            check_length(len, 8);
+            long long const usecs = read_signed(buf, 8);
+            if (usecs == (std::numeric_limits<long long>::max)() ||
+                usecs == (std::numeric_limits<long long>::min)())
+            {
+                throw soci_error("Cannot convert infinite timestamp to std::tm.");
+            }
+            usecs_to_parts(usecs, days, usecsOfDay);
+            days_to_date(days, year, month, day);
+        }
+        break;
+    case oid_time:
+        // only the time of day, leave the date part as 1900-01-01
+        check_length(len, 8);
+        usecsOfDay = read_signed(buf, 8);
+        break;
+    default:
+        parse_std_tm(buf, t);
+        return;
+    }
+
+    long long const secs = usecsOfDay / 1000000;
+
+    t.tm_isdst = -1;
+    t.tm_year = year - 1900;
+    t.tm_mon  = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = static_cast<int>(secs / 3600);
+    t.tm_min  = static_cast<int>(secs / 60 % 60);
+    t.tm_sec  = static_cast<int>(secs % 60);
+
+    std::mktime(&t);
+}
+
+void soci::details::postgresql::binary_to_string(unsigned long typeOid,
+    char const * buf, int len, std::string & str)
+{
+    char tmp[32];
+
+    switch (typeOid)
+    {
+    case oid_bool:
+        check_length(len, 1);
+        str = buf[0] != 0 ? "t" : "f";
+        break;
+    case oid_int2:
+    case oid_int4:
+    case oid_int8:
+    case oid_oid:
+        {
+            long long val = 0;
+            binary_to_long_long(typeOid, buf, len, val);
+            std::sprintf(tmp, "%" LL_FMT_FLAGS "d", val);
+            str = tmp;
+        }
+        break;
+    case oid_float4:
+        std::sprintf(tmp, "%.9g", binary_to_double(typeOid, buf, len));
+        str = tmp;
+        break;
+    case oid_float8:
+        std::sprintf(tmp, "%.17g", binary_to_double(typeOid, buf, len));
+        str = tmp;
+        break;
+    case oid_numeric:
+        format_numeric(buf, len, str);
+        break;
+    case oid_date:
+        check_length(len, 4);
+        str.clear();
+        format_date(read_signed(buf, 4), str);
+        break;
+    case oid_timestamp:
+    case oid_timestamptz:
+        {
+            check_length(len, 8);
+            long long days, usecsOfDay;
+            usecs_to_parts(read_signed(buf, 8), days, usecsOfDay);
+            str.clear();
+            format_date(days, str);
+            str += ' ';
+            format_time_of_day(usecsOfDay, str);
+            if (typeOid == oid_timestamptz)
+            {
+                // the binary values are always sent in UTC
+                str += "+00";
+            }
+        }
+        break;
+    case oid_time:
+        check_length(len, 8);
+        str.clear();
+        format_time_of_day(read_signed(buf, 8), str);
+        break;
+    default:
+        // the binary representation of the textual types is their text and
+        // bytea is returned as is, without any escaping
+        str.assign(buf, len);
+        break;
+    }
+}
+
+void soci::details::postgresql::integer_to_binary(long long val, int len,
+    char * buf)
+{
+    unsigned long long const v = static_cast<unsigned long long>(val);
+    for (int i = 0; i != len; ++i)
+    {
+        buf[i] = static_cast<char>(v >> (8 * (len - 1 - i)));
+    }
+}
+
+void soci::details::postgresql::double_to_binary(double val, char * buf)
+{
+    unsigned long long bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    integer_to_binary(static_cast<long long>(bits), 8, buf);
+}
+
+void soci::details::postgresql::std_tm_to_binary(std::tm const & t, char * buf)
+{
+    if (t.tm_mon < 0 || t.tm_mon > 11)
+    {
+        throw soci_error("Cannot convert std::tm with invalid month.");
+    }
+
+    long long const days =
+        date_to_days(t.tm_year + 1900LL, t.tm_mon + 1, t.tm_mday);
+    long long const secs = days * 86400LL
+        + t.tm_hour * 3600LL + t.tm_min * 60LL + t.tm_sec;
+
+    integer_to_binary(secs * 1000000LL, 8, buf);
+}
+
+unsigned long soci::details::postgresql::use_binary_type(exchange_type type)
+{
+    switch (type)
+    {
+    case x_short:
+        return oid_int2;
+    case x_integer:
+        return oid_int4;
+    case x_long_long:
+        return oid_int8;
+    case x_double:
+        return oid_float8;
+    case x_stdtm:
+        return oid_timestamp;
+    default:
+        return 0;
+    }
+}
+
+int soci::details::postgresql::format_use_value(exchange_type type,
+    void const * data, bool binary, char * buf)
+{
+    switch (type)
+    {
+    case x_char:
+        buf[0] = *static_cast<char const *>(data);
+        buf[1] = '\0';
+        return 1;
+    case x_short:
+        {
+            short const val = *static_cast<short const *>(data);
+            if (binary)
+            {
+                integer_to_binary(val, 2, buf);
+                return 2;
+            }
+            return std::sprintf(buf, "%d", static_cast<int>(val));
+        }
+    case x_integer:
+        {
+            int const val = *static_cast<int const *>(data);
+            if (binary)
+            {
+                integer_to_binary(val, 4, buf);
+                return 4;
+            }
+            return std::sprintf(buf, "%d", val);
+        }
+    case x_long_long:
+        {
+            long long const val = *static_cast<long long const *>(data);
+            if (binary)
+            {
+                integer_to_binary(val, 8, buf);
+                return 8;
+            }
+            return std::sprintf(buf, "%" LL_FMT_FLAGS "d", val);
+        }
+    case x_unsigned_long_long:
+        // there is no unsigned type in PostgreSQL, always use text
+        return std::sprintf(buf, "%" LL_FMT_FLAGS "u",
+            *static_cast<unsigned long long const *>(data));
+    case x_double:
+        {
+            double const val = *static_cast<double const *>(data);
+            if (binary)
+            {
+                double_to_binary(val, buf);
+                return 8;
+            }
+            return std::sprintf(buf, "%.20g", val);
+        }
+    case x_stdtm:
+        {
+            std::tm const & t = *static_cast<std::tm const *>(data);
+            if (binary)
+            {
+                std_tm_to_binary(t, buf);
+                return 8;
+            }
+            // the fields are not checked, so the output could be truncated
+            int const len = snprintf(buf, use_value_size,
+                "%d-%02d-%02d %02d:%02d:%02d",
+                t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+                t.tm_hour, t.tm_min, t.tm_sec);
+            return len < static_cast<int>(use_value_size) && len >= 0
+                ? len : static_cast<int>(std::strlen(buf));
+        }
+    default:
+        throw soci_error("Use element used with non-supported type.");
+    }
+}
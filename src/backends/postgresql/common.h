@@ -13,6 +13,7 @@
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <string>
 #include <vector>
 
 namespace soci
@@ -24,6 +25,30 @@ namespace details
 namespace postgresql
 {
 
+// PostgreSQL type OIDs which have a binary representation handled here
+enum
+{
+    oid_bool = 16,
+    oid_bytea = 17,
+    oid_char = 18,
+    oid_name = 19,
+    oid_int8 = 20,
+    oid_int2 = 21,
+    oid_int4 = 23,
+    oid_text = 25,
+    oid_oid = 26,
+    oid_float4 = 700,
+    oid_float8 = 701,
+    oid_unknown = 705,
+    oid_bpchar = 1042,
+    oid_varchar = 1043,
+    oid_date = 1082,
+    oid_time = 1083,
+    oid_timestamp = 1114,
+    oid_timestamptz = 1184,
+    oid_numeric = 1700
+};
+
 // helper function for parsing integers
 template <typename T>
 T string_to_integer(char const * buf)
@@ -118,6 +143,90 @@ double string_to_double(char const * buf);
 // helper function for parsing datetime values
 void parse_std_tm(char const * buf, std::tm & t);
 
+// true if the values of the given type can be received in the binary format
+// and decoded by the helpers below
+bool is_binary_result_type(unsigned long typeOid);
+
+// helpers for decoding values received in the binary format, the type of
+// the value is given by its OID and the types which have no special binary
+// representation are handled as text
+char binary_to_char(unsigned long typeOid, char const * buf, int len);
+bool binary_to_long_long(unsigned long typeOid, char const * buf, int len,
+    long long & val);
+double binary_to_double(unsigned long typeOid, char const * buf, int len);
+void binary_to_std_tm(unsigned long typeOid, char const * buf, int len,
+    std::tm & t);
+void binary_to_string(unsigned long typeOid, char const * buf, int len,
+    std::string & str);
+
+// helpers for encoding the values sent in the binary format, the integers
+// are stored in the given number of bytes and std::tm as a timestamp
+void integer_to_binary(long long val, int len, char * buf);
+void double_to_binary(double val, char * buf);
+void std_tm_to_binary(std::tm const & t, char * buf);
+
+// maximal length of the formatted values of the use elements of all types
+// except strings, which are used directly
+std::size_t const use_value_size = 32;
+
+// type in the binary format of which the values of the given type can be
+// sent, or 0 if they are always sent as text
+unsigned long use_binary_type(exchange_type type);
+
+// formats a value of a use element into the buffer of use_value_size bytes
+// and returns its length
+int format_use_value(exchange_type type, void const * data, bool binary,
+    char * buf);
+
+template <typename T>
+T binary_to_integer(unsigned long typeOid, char const * buf, int len)
+{
+    long long t(0);
+    if (binary_to_long_long(typeOid, buf, len, t) == false)
+    {
+        std::string str;
+        binary_to_string(typeOid, buf, len, str);
+        return string_to_integer<T>(str.c_str());
+    }
+
+    const T max = (std::numeric_limits<T>::max)();
+    const T min = (std::numeric_limits<T>::min)();
+    if (t <= static_cast<long long>(max) &&
+        t >= static_cast<long long>(min))
+    {
+        return static_cast<T>(t);
+    }
+    else
+    {
+        // value out of target range
+        throw soci_error("Cannot convert data.");
+    }
+}
+
+template <typename T>
+T binary_to_unsigned_integer(unsigned long typeOid, char const * buf, int len)
+{
+    long long t(0);
+    if (binary_to_long_long(typeOid, buf, len, t) == false)
+    {
+        std::string str;
+        binary_to_string(typeOid, buf, len, str);
+        return string_to_unsigned_integer<T>(str.c_str());
+    }
+
+    const T max = (std::numeric_limits<T>::max)();
+    if (t >= 0 && static_cast<unsigned long long>(t) <=
+        static_cast<unsigned long long>(max))
+    {
+        return static_cast<T>(t);
+    }
+    else
+    {
+        // value out of target range
+        throw soci_error("Cannot convert data.");
+    }
+}
+
 // helper for vector operations
 template <typename T>
 std::size_t get_vector_size(void * p)
@@ -45,6 +45,7 @@ details::postgresql_result::check_for_data(char const* errMsg) const
             return false;
 
         case PGRES_TUPLES_OK:
+        case PGRES_SINGLE_TUPLE: // the rows streamed in single row mode
             return true;
 
         default:
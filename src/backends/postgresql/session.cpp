@@ -11,7 +11,9 @@
 #include <connection-parameters.h>
 #include <libpq/libpq-fs.h> // libpq
 #include <cctype>
+#include <climits>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <sstream>
@@ -29,11 +31,155 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // unnamed
+{
+
+// std::isspace() can't be called with negative characters
+bool is_space(char c)
+{
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+bool parse_bool_option(std::string const & name, std::string const & value)
+{
+    if (value == "1" || value == "true" || value == "yes" || value == "on")
+    {
+        return true;
+    }
+    else if (value == "0" || value == "false" || value == "no" || value == "off")
+    {
+        return false;
+    }
+
+    throw soci_error("Invalid value of the \"" + name +
+        "\" connection string option.");
+}
+
+int parse_int_option(std::string const & name, std::string const & value)
+{
+    char * end;
+    long const result = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || result < 0 || result > INT_MAX)
+    {
+        throw soci_error("Invalid value of the \"" + name +
+            "\" connection string option.");
+    }
+
+    return static_cast<int>(result);
+}
+
+// Removes the options handled by SOCI itself from the connection string,
+// as PQconnectdb() doesn't accept any unknown keywords. The syntax of the
+// string is "keyword = value ...", with the values possibly single-quoted.
+std::string extract_options(std::string const & connectString,
+    bool & binaryResults, int & fetchChunkSize,
+    std::size_t & maxPreparedStatements)
+{
+    std::string result;
+
+    std::string::size_type const len = connectString.size();
+    std::string::size_type i = 0;
+    for (;;)
+    {
+        while (i != len && is_space(connectString[i]))
+        {
+            ++i;
+        }
+        if (i == len)
+        {
+            break;
+        }
+
+        std::string::size_type const start = i;
+        while (i != len && connectString[i] != '=' &&
+            is_space(connectString[i]) == false)
+        {
+            ++i;
+        }
+        std::string const keyword = connectString.substr(start, i - start);
+
+        while (i != len && is_space(connectString[i]))
+        {
+            ++i;
+        }
+        if (i == len || connectString[i] != '=')
+        {
+            // not something we understand, let libpq report the error
+            result += connectString.substr(start);
+            break;
+        }
+        ++i;
+        while (i != len && is_space(connectString[i]))
+        {
+            ++i;
+        }
+
+        std::string value;
+        if (i != len && connectString[i] == '\'')
+        {
+            for (++i; i != len && connectString[i] != '\''; ++i)
+            {
+                if (connectString[i] == '\\' && i + 1 != len)
+                {
+                    ++i;
+                }
+                value += connectString[i];
+            }
+            if (i != len)
+            {
+                ++i;
+            }
+        }
+        else
+        {
+            for (; i != len && is_space(connectString[i]) == false; ++i)
+            {
+                if (connectString[i] == '\\' && i + 1 != len)
+                {
+                    ++i;
+                }
+                value += connectString[i];
+            }
+        }
+
+        if (keyword == "binary_results")
+        {
+            binaryResults = parse_bool_option(keyword, value);
+        }
+        else if (keyword == "fetch_chunk_size")
+        {
+            fetchChunkSize = parse_int_option(keyword, value);
+        }
+        else if (keyword == "max_prepared_statements")
+        {
+            maxPreparedStatements = parse_int_option(keyword, value);
+        }
+        else
+        {
+            if (result.empty() == false)
+            {
+                result += ' ';
+            }
+            result += connectString.substr(start, i - start);
+        }
+    }
+
+    return result;
+}
+
+} // namespace unnamed
+
 postgresql_session_backend::postgresql_session_backend(
     connection_parameters const& parameters)
-    : statementCount_(0)
+    : statementCount_(0), maxPreparedStatements_(0)
+    , unusedPreparedStatements_(0)
+    , binaryResults_(false), fetchChunkSize_(0)
 {
-    PGconn* conn = PQconnectdb(parameters.get_connect_string().c_str());
+    std::string const connectString = extract_options(
+        parameters.get_connect_string(), binaryResults_, fetchChunkSize_,
+        maxPreparedStatements_);
+
+    PGconn* conn = PQconnectdb(connectString.c_str());
     if (0 == conn || CONNECTION_OK != PQstatus(conn))
     {
         std::string msg = "Cannot establish connection to the database.";
@@ -114,6 +260,133 @@ std::string postgresql_session_backend::get_next_statement_name()
     return nameBuf;
 }
 
+bool postgresql_session_backend::is_utc_time_zone() const
+{
+    // the parameter is reported by the server whenever it changes
+    char const * const zone = PQparameterStatus(conn_, "TimeZone");
+    if (zone == NULL)
+    {
+        return false;
+    }
+
+    static char const * const utcZones[] =
+    {
+        "UTC", "Etc/UTC", "UCT", "Etc/UCT", "GMT", "Etc/GMT", "GMT0",
+        "Etc/GMT0", "Universal", "Etc/Universal", "Zulu", "Etc/Zulu"
+    };
+
+    for (std::size_t i = 0; i != sizeof(utcZones) / sizeof(utcZones[0]); ++i)
+    {
+        if (std::strcmp(zone, utcZones[i]) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+postgresql_prepared_statement *
+postgresql_session_backend::use_prepared_statement(std::string const & query)
+{
+    PreparedStatementsMap::iterator const it =
+        preparedStatementsByQuery_.find(query);
+    if (it == preparedStatementsByQuery_.end())
+    {
+        return NULL;
+    }
+
+    PreparedStatementsList::iterator const ps = it->second;
+    preparedStatements_.splice(preparedStatements_.begin(),
+        preparedStatements_, ps);
+    if (ps->useCount_++ == 0)
+    {
+        --unusedPreparedStatements_;
+    }
+
+    return &*ps;
+}
+
+postgresql_prepared_statement *
+postgresql_session_backend::add_prepared_statement(
+    std::string const & query, std::string const & statementName)
+{
+    if (maxPreparedStatements_ == 0 ||
+        preparedStatementsByQuery_.find(query) !=
+            preparedStatementsByQuery_.end())
+    {
+        return NULL;
+    }
+
+    postgresql_prepared_statement ps;
+    ps.query_ = query;
+    ps.name_ = statementName;
+    ps.useCount_ = 1;
+    ps.described_ = false;
+    ps.zonedResults_ = false;
+    ps.textResults_ = false;
+
+    preparedStatements_.push_front(ps);
+    preparedStatementsByQuery_[query] = preparedStatements_.begin();
+    return &preparedStatements_.front();
+}
+
+void postgresql_session_backend::release_prepared_statement(
+    std::string const & query)
+{
+    PreparedStatementsMap::iterator const it =
+        preparedStatementsByQuery_.find(query);
+    if (it == preparedStatementsByQuery_.end())
+    {
+        return;
+    }
+
+    if (--it->second->useCount_ == 0)
+    {
+        ++unusedPreparedStatements_;
+    }
+
+    // evict the least recently used statements which are not in use
+    PreparedStatementsList::iterator ps = preparedStatements_.end();
+    while (unusedPreparedStatements_ > maxPreparedStatements_ &&
+        ps != preparedStatements_.begin())
+    {
+        --ps;
+        if (ps->useCount_ == 0)
+        {
+            pendingDeallocations_.push_back(ps->name_);
+            preparedStatementsByQuery_.erase(ps->query_);
+            ps = preparedStatements_.erase(ps);
+            --unusedPreparedStatements_;
+        }
+    }
+
+    // the statements are deallocated in batches to save round trips, but
+    // only outside of any transaction: the connection may be busy with
+    // another query, a failed transaction rejects the commands and the
+    // deallocation done in one would be lost if it was rolled back
+    std::size_t const batchSize = 16;
+    if (pendingDeallocations_.size() >= batchSize &&
+        PQtransactionStatus(conn_) == PQTRANS_IDLE)
+    {
+        // the statements which fail to be deallocated are not retried,
+        // they remain prepared until the end of the session then
+        std::vector<std::string> names;
+        names.swap(pendingDeallocations_);
+
+        std::string query;
+        for (std::size_t i = 0; i != names.size(); ++i)
+        {
+            query += "DEALLOCATE ";
+            query += names[i];
+            query += ";";
+        }
+
+        hard_exec(conn_, query.c_str(),
+            "Cannot deallocate prepared statements.");
+    }
+}
+
 postgresql_statement_backend * postgresql_session_backend::make_statement_backend()
 {
     return new postgresql_statement_backend(*this);
@@ -26,6 +26,8 @@
 
 #include <soci-backend.h>
 #include <libpq-fe.h>
+#include <list>
+#include <map>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -96,6 +98,9 @@ public:
     // careful to avoid really modifying it.
     PGresult* get_result() const { return result_; }
 
+    // Give up the ownership of the result, without freeing it.
+    void release() { result_ = NULL; }
+
     // Dtor frees the result.
     ~postgresql_result() { free(); }
 
@@ -119,8 +124,50 @@ private:
     postgresql_result& operator=(postgresql_result const &);
 };
 
+// Statement prepared on the server and shared by all the statements of the
+// session using the same query.
+struct postgresql_prepared_statement
+{
+    std::string query_;
+    std::string name_;
+    int useCount_; // number of the statements using it
+
+    // the statement is only described on the server when the types below
+    // are needed for the first time
+    bool described_;
+
+    // types of the parameters, as inferred by the server
+    std::vector<Oid> paramTypes_;
+
+    // the results contain timestamptz values, which are sent in the session
+    // time zone only in the text format
+    bool zonedResults_;
+
+    // the results contain values of the types which can't be decoded from
+    // the binary format, see postgresql::is_binary_result_type()
+    bool textResults_;
+};
+
 } // namespace details
 
+// The values of a use element in the form in which they are passed to libpq,
+// a single one or one for each row of a bulk operation. The buffers are kept
+// by the use element for all the executions of its statement, so that they
+// don't need to be allocated again once they are big enough.
+struct postgresql_use_buffers
+{
+    postgresql_use_buffers() : format_(0) {}
+
+    // prepare the buffers for the given number of values, each of them
+    // taking at most valueSize bytes in data_
+    void resize(std::size_t count, std::size_t valueSize);
+
+    std::vector<char> data_;
+    std::vector<char const *> values_; // NULL for the null values
+    std::vector<int> lengths_;
+    int format_; // 0 for text, 1 for binary
+};
+
 struct postgresql_statement_backend;
 struct postgresql_standard_into_type_backend : details::standard_into_type_backend
 {
@@ -169,7 +216,7 @@ struct postgresql_vector_into_type_backend : details::vector_into_type_backend
 struct postgresql_standard_use_type_backend : details::standard_use_type_backend
 {
     postgresql_standard_use_type_backend(postgresql_statement_backend & st)
-        : statement_(st), position_(0), buf_(NULL) {}
+        : statement_(st), position_(0) {}
 
     virtual void bind_by_pos(int & position,
         void * data, details::exchange_type type, bool readOnly);
@@ -187,7 +234,7 @@ struct postgresql_standard_use_type_backend : details::standard_use_type_backend
     details::exchange_type type_;
     int position_;
     std::string name_;
-    char * buf_;
+    postgresql_use_buffers buffers_;
 };
 
 struct postgresql_vector_use_type_backend : details::vector_use_type_backend
@@ -212,7 +259,7 @@ struct postgresql_vector_use_type_backend : details::vector_use_type_backend
     details::exchange_type type_;
     int position_;
     std::string name_;
-    std::vector<char *> buffers_;
+    postgresql_use_buffers buffers_;
 };
 
 struct postgresql_session_backend;
@@ -243,16 +290,70 @@ struct postgresql_statement_backend : details::statement_backend
     virtual postgresql_vector_into_type_backend * make_vector_into_type_backend();
     virtual postgresql_vector_use_type_backend * make_vector_use_type_backend();
 
+    virtual bool reset_for_reuse();
+    virtual void reuse_into_type_backend(
+        details::standard_into_type_backend * backEnd);
+    virtual void reuse_use_type_backend(
+        details::standard_use_type_backend * backEnd);
+
+    // Check whether the value of a use element bound at the given position
+    // or with the given name may be sent in the binary format of the given
+    // type, i.e. whether the server expects exactly this type for it.
+    bool use_binary_format(int position, std::string const & name,
+        unsigned long typeOid);
+
+    // format in which the results of the next execution are requested
+    int get_result_format();
+
+    // get the types of the parameters and of the results of the prepared
+    // statement from the server, if not done yet
+    details::postgresql_prepared_statement & describe_statement();
+
+    // append the i-th value of the given use element to the parameters
+    void add_param(postgresql_use_buffers const & buffers, int i);
+
+    // send the given number of rows of the use elements to the server for
+    // the "COPY ... FROM STDIN" statement
+    void copy_in(int number);
+
+    // start executing the query in single row mode and read its first rows
+    void send_query(int resultFormat);
+
+    // replace the rows consumed so far with up to the given number of the
+    // rows streamed from the server
+    void read_rows(int count);
+
+    // stop streaming the results, discarding the remaining rows
+    void finish_streaming();
+
     postgresql_session_backend & session_;
 
     details::postgresql_result result_;
     std::string query_;
     details::statement_type stType_;
     std::string statementName_;
+    // the statement managed by the session, NULL if not shared
+    details::postgresql_prepared_statement * sharedStatement_;
+    // description of the statement prepared for this backend only, used when
+    // it is not shared
+    details::postgresql_prepared_statement privateStatement_;
     std::vector<std::string> names_; // list of names for named binds
 
+    // "COPY ... FROM STDIN" statements are not executed with parameters,
+    // the values of the use elements are sent as the copied data instead
+    enum copy_format { copy_none, copy_text, copy_binary };
+    copy_format copyFormat_;
+    std::vector<char> copyData_; // data not sent to the server yet
+
+    // the parameters passed to libpq, kept here to avoid reallocating them
+    std::vector<char const *> paramValues_;
+    std::vector<int> paramLengths_;
+    std::vector<int> paramFormats_;
+
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
+    bool streaming_;    // more rows may still come from the server
+
     int numberOfRows_;  // number of rows retrieved from the server
     int currentRow_;    // "current" row number to consume in postFetch
     int rowsToConsume_; // number of rows to be consumed in postFetch
@@ -268,10 +369,10 @@ struct postgresql_statement_backend : details::statement_backend
     // the following maps are used for finding data buffers according to
     // use elements specified by the user
 
-    typedef std::map<int, char **> UseByPosBuffersMap;
+    typedef std::map<int, postgresql_use_buffers *> UseByPosBuffersMap;
     UseByPosBuffersMap useByPosBuffers_;
 
-    typedef std::map<std::string, char **> UseByNameBuffersMap;
+    typedef std::map<std::string, postgresql_use_buffers *> UseByNameBuffersMap;
     UseByNameBuffersMap useByNameBuffers_;
 };
 
@@ -329,8 +430,138 @@ struct postgresql_session_backend : details::session_backend
 
     std::string get_next_statement_name();
 
+    // whether the session time zone is UTC, in which case the timestamptz
+    // values are the same in the binary and the text formats
+    bool is_utc_time_zone() const;
+
+    // If the max_prepared_statements option is used, the statements prepared
+    // on the server are shared by all the statements using the same query.
+    // use_prepared_statement() returns NULL if the query wasn't prepared
+    // yet, add_prepared_statement() returns NULL if the statements are not
+    // shared and the caller remains responsible for deallocating it.
+    details::postgresql_prepared_statement * use_prepared_statement(
+        std::string const & query);
+    details::postgresql_prepared_statement * add_prepared_statement(
+        std::string const & query, std::string const & statementName);
+    void release_prepared_statement(std::string const & query);
+
     int statementCount_;
     PGconn * conn_;
+
+    // the most recently used prepared statements are at the front, the
+    // ones not used by any statement are deallocated in batches when there
+    // are more than maxPreparedStatements_ of them
+    typedef std::list<details::postgresql_prepared_statement>
+        PreparedStatementsList;
+    PreparedStatementsList preparedStatements_;
+    typedef std::map<std::string, PreparedStatementsList::iterator>
+        PreparedStatementsMap;
+    PreparedStatementsMap preparedStatementsByQuery_;
+    std::size_t maxPreparedStatements_;
+    std::size_t unusedPreparedStatements_;
+    std::vector<std::string> pendingDeallocations_;
+
+    // request the results in the binary format instead of the text one
+    bool binaryResults_;
+
+    // if not 0, the results of the queries are streamed from the server in
+    // single row mode and kept in memory by chunks of this many rows
+    int fetchChunkSize_;
+};
+
+// Statement executed without blocking the calling thread, so that the
+// queries of many sessions can be waited for by a single event loop. The
+// query is prepared on the server by its first execution and uses the
+// native placeholders ($1, $2...), all the values are exchanged as text.
+//
+// The session can't be used for anything else while the statement is
+// being executed.
+class SOCI_POSTGRESQL_DECL postgresql_async_statement
+{
+public:
+    // called by consume() or flush() when the execution is complete,
+    // successfully or not
+    typedef void (*callback)(postgresql_async_statement & st, void * arg);
+
+    postgresql_async_statement(session & sql, std::string const & query);
+
+    // Cancels the execution which is still in progress, if any and unless
+    // cancel() was already called, and blocks until it is complete before
+    // deallocating the prepared statement. To avoid blocking, call cancel()
+    // and consume() until is_done() before destroying the statement.
+    ~postgresql_async_statement();
+
+    // values of the parameters for the next execution
+    void set_param(int position, std::string const & value);
+    void set_null_param(int position);
+    void clear_params();
+
+    // Start the execution, the errors which prevent it from being started
+    // are thrown, all the other ones are reported when it is complete.
+    void execute(callback cb = NULL, void * arg = NULL);
+
+    // descriptor of the connection to wait on, for reading while the
+    // statement is being executed and also for writing if wants_write()
+    int get_socket() const;
+    bool wants_write() const { return wantsWrite_; }
+
+    // To be called when the descriptor is ready for reading or writing
+    // respectively, return true when the execution is complete.
+    bool consume();
+    bool flush();
+
+    bool is_done() const { return state_ == idle; }
+
+    // Ask the server to abandon the query, it then completes with an error.
+    // This blocks while the request is sent, PQcancel() opens a separate
+    // connection to the server for it.
+    void cancel();
+
+    // outcome of the last complete execution
+    bool failed() const { return failed_; }
+    std::string const & get_error_message() const { return error_; }
+    std::string const & get_sqlstate() const { return sqlstate_; }
+
+    int get_number_of_rows() const;
+    int get_number_of_columns() const;
+    std::string get_column_name(int column) const;
+    bool is_null(int row, int column) const;
+    std::string get_value(int row, int column) const;
+    long long get_affected_rows() const;
+
+private:
+    enum async_state { idle, preparing, executing };
+
+    void start_execution();
+    void complete(PGresult * result, char const * errMsg);
+    void fail(char const * msg);
+    void finish();
+    void check_done() const;
+
+    postgresql_session_backend & session_;
+    std::string query_;
+    std::string statementName_; // empty until prepared
+
+    std::vector<std::string> values_;
+    std::vector<bool> nulls_;
+    std::vector<char const *> paramValues_;
+
+    async_state state_;
+    bool wantsWrite_;
+    bool cancelled_; // cancel() was called during this execution
+    details::postgresql_result result_; // of the last execution
+    PGresult * pending_; // first result of the current command
+
+    callback callback_;
+    void * arg_;
+
+    bool failed_;
+    std::string error_;
+    std::string sqlstate_;
+
+    // noncopyable
+    postgresql_async_statement(postgresql_async_statement const &);
+    postgresql_async_statement & operator=(postgresql_async_statement const &);
 };
 
 
@@ -80,59 +80,89 @@ void postgresql_standard_into_type_backend::post_fetch(
             }
         }
 
-        // raw data, in text format
+        // raw data, in text or binary format
         char const * buf = PQgetvalue(statement_.result_,
             statement_.currentRow_, pos);
 
+        bool const binary = PQfformat(statement_.result_, pos) != 0;
+        unsigned long const typeOid = PQftype(statement_.result_, pos);
+        int const len = PQgetlength(statement_.result_,
+            statement_.currentRow_, pos);
+
         switch (type_)
         {
         case x_char:
             {
                 char * dest = static_cast<char *>(data_);
-                *dest = *buf;
+                *dest = binary ? binary_to_char(typeOid, buf, len) : *buf;
             }
             break;
         case x_stdstring:
             {
                 std::string * dest = static_cast<std::string *>(data_);
-                dest->assign(buf);
+                if (binary)
+                {
+                    binary_to_string(typeOid, buf, len, *dest);
+                }
+                else
+                {
+                    dest->assign(buf);
+                }
             }
             break;
         case x_short:
             {
                 short * dest = static_cast<short *>(data_);
-                *dest = string_to_integer<short>(buf);
+                *dest = binary
+                    ? binary_to_integer<short>(typeOid, buf, len)
+                    : string_to_integer<short>(buf);
             }
             break;
         case x_integer:
             {
                 int * dest = static_cast<int *>(data_);
-                *dest = string_to_integer<int>(buf);
+                *dest = binary
+                    ? binary_to_integer<int>(typeOid, buf, len)
+                    : string_to_integer<int>(buf);
             }
             break;
         case x_long_long:
             {
                 long long * dest = static_cast<long long *>(data_);
-                *dest = string_to_integer<long long>(buf);
+                *dest = binary
+                    ? binary_to_integer<long long>(typeOid, buf, len)
+                    : string_to_integer<long long>(buf);
             }
             break;
         case x_unsigned_long_long:
             {
                 unsigned long long * dest = static_cast<unsigned long long *>(data_);
-                *dest = string_to_unsigned_integer<unsigned long long>(buf);
+                *dest = binary
+                    ? binary_to_unsigned_integer<unsigned long long>(
+                        typeOid, buf, len)
+                    : string_to_unsigned_integer<unsigned long long>(buf);
             }
             break;
         case x_double:
             {
                 double * dest = static_cast<double *>(data_);
-                *dest = string_to_double(buf);
+                *dest = binary
+                    ? binary_to_double(typeOid, buf, len)
+                    : string_to_double(buf);
             }
             break;
         case x_stdtm:
             {
                 // attempt to parse the string and convert to std::tm
                 std::tm * dest = static_cast<std::tm *>(data_);
-                parse_std_tm(buf, *dest);
+                if (binary)
+                {
+                    binary_to_std_tm(typeOid, buf, len, *dest);
+                }
+                else
+                {
+                    parse_std_tm(buf, *dest);
+                }
             }
             break;
         case x_rowid:
@@ -144,13 +174,18 @@ void postgresql_standard_into_type_backend::post_fetch(
                     = static_cast<postgresql_rowid_backend *>(
                         rid->get_backend());
 
-                rbe->value_ = string_to_unsigned_integer<unsigned long>(buf);
+                rbe->value_ = binary
+                    ? binary_to_unsigned_integer<unsigned long>(
+                        typeOid, buf, len)
+                    : string_to_unsigned_integer<unsigned long>(buf);
             }
             break;
         case x_blob:
             {
-                unsigned long oid =
-                    string_to_unsigned_integer<unsigned long>(buf);
+                unsigned long oid = binary
+                    ? binary_to_unsigned_integer<unsigned long>(
+                        typeOid, buf, len)
+                    : string_to_unsigned_integer<unsigned long>(buf);
 
                 int fd = lo_open(statement_.session_.conn_, oid,
                     INV_READ | INV_WRITE);
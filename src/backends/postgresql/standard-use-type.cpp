@@ -10,6 +10,7 @@
 #include "blob.h"
 #include "rowid.h"
 #include <soci-platform.h>
+#include "common.h"
 #include <libpq/libpq-fs.h> // libpq
 #include <cctype>
 #include <cstdio>
@@ -31,6 +32,7 @@
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::postgresql;
 
 void postgresql_standard_use_type_backend::bind_by_pos(
     int & position, void * data, exchange_type type, bool /* readOnly */)
@@ -41,6 +43,7 @@ void postgresql_standard_use_type_backend::bind_by_pos(
     data_ = data;
     type_ = type;
     position_ = position++;
+    name_.clear();
 }
 
 void postgresql_standard_use_type_backend::bind_by_name(
@@ -51,90 +54,45 @@ void postgresql_standard_use_type_backend::bind_by_name(
 
     data_ = data;
     type_ = type;
+    position_ = 0;
     name_ = name;
 }
 
+void postgresql_use_buffers::resize(std::size_t count, std::size_t valueSize)
+{
+    // the vectors never shrink their capacity, so this only allocates when
+    // more values than ever before are needed
+    data_.resize(count * valueSize);
+    values_.resize(count);
+    lengths_.resize(count);
+}
+
 void postgresql_standard_use_type_backend::pre_use(indicator const * ind)
 {
+    buffers_.resize(1, use_value_size);
+    buffers_.format_ = 0;
+
     if (ind != NULL && *ind == i_null)
     {
-        // leave the working buffer as NULL
+        buffers_.values_[0] = NULL;
+        buffers_.lengths_[0] = 0;
     }
     else
     {
-        // allocate and fill the buffer with text-formatted client data
+        // fill the buffer with client data, formatted as text unless the
+        // server expects exactly the type of the binary representation
+        char * const buf = &buffers_.data_[0];
+        buffers_.values_[0] = buf;
+
         switch (type_)
         {
-        case x_char:
-            {
-                buf_ = new char[2];
-                buf_[0] = *static_cast<char *>(data_);
-                buf_[1] = '\0';
-            }
-            break;
         case x_stdstring:
             {
+                // the string itself is not going to change until the
+                // statement is executed, no need to copy it
                 std::string * s = static_cast<std::string *>(data_);
-                buf_ = new char[s->size() + 1];
-                std::strcpy(buf_, s->c_str());
-            }
-            break;
-        case x_short:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<short>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    static_cast<int>(*static_cast<short *>(data_)));
-            }
-            break;
-        case x_integer:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<int>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    *static_cast<int *>(data_));
-            }
-            break;
-        case x_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<long long>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "d",
-                    *static_cast<long long *>(data_));
-            }
-            break;
-        case x_unsigned_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long long>::digits10 + 2;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "u",
-                    *static_cast<unsigned long long *>(data_));
-            }
-            break;
-        case x_double:
-            {
-                // no need to overengineer it (KISS)...
-
-                std::size_t const bufSize = 100;
-                buf_ = new char[bufSize];
-
-                snprintf(buf_, bufSize, "%.20g",
-                    *static_cast<double *>(data_));
-            }
-            break;
-        case x_stdtm:
-            {
-                std::size_t const bufSize = 20;
-                buf_ = new char[bufSize];
-
-                std::tm * t = static_cast<std::tm *>(data_);
-                snprintf(buf_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                    t->tm_year + 1900, t->tm_mon + 1, t->tm_mday,
-                    t->tm_hour, t->tm_min, t->tm_sec);
+                buffers_.values_[0] = s->c_str();
+                buffers_.lengths_[0] = static_cast<int>(s->size());
             }
             break;
         case x_rowid:
@@ -146,11 +104,8 @@ void postgresql_standard_use_type_backend::pre_use(indicator const * ind)
                     = static_cast<postgresql_rowid_backend *>(
                         rid->get_backend());
 
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long>::digits10 + 2;
-                buf_ = new char[bufSize];
-
-                snprintf(buf_, bufSize, "%lu", rbe->value_);
+                buffers_.lengths_[0] = snprintf(buf, use_value_size,
+                    "%lu", rbe->value_);
             }
             break;
         case x_blob:
@@ -159,27 +114,33 @@ void postgresql_standard_use_type_backend::pre_use(indicator const * ind)
                 postgresql_blob_backend * bbe =
                     static_cast<postgresql_blob_backend *>(b->get_backend());
 
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long>::digits10 + 2;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%lu", bbe->oid_);
+                buffers_.lengths_[0] = snprintf(buf, use_value_size,
+                    "%lu", bbe->oid_);
             }
             break;
 
         default:
-            throw soci_error("Use element used with non-supported type.");
+            {
+                unsigned long const binaryType = use_binary_type(type_);
+                bool const binary = binaryType != 0 &&
+                    statement_.use_binary_format(position_, name_, binaryType);
+
+                buffers_.lengths_[0] =
+                    format_use_value(type_, data_, binary, buf);
+                buffers_.format_ = binary ? 1 : 0;
+            }
         }
     }
 
     if (position_ > 0)
     {
         // binding by position
-        statement_.useByPosBuffers_[position_] = &buf_;
+        statement_.useByPosBuffers_[position_] = &buffers_;
     }
     else
     {
         // binding by name
-        statement_.useByNameBuffers_[name_] = &buf_;
+        statement_.useByNameBuffers_[name_] = &buffers_;
     }
 }
 
@@ -191,16 +152,10 @@ void postgresql_standard_use_type_backend::post_use(
     // In particular, there is nothing to protect, because both const and non-const
     // objects will never be modified.
 
-    // clean up the working buffer, it might be allocated anew in
-    // the next run of preUse
-    clean_up();
+    // the working buffers are kept for the next run of pre_use
 }
 
 void postgresql_standard_use_type_backend::clean_up()
 {
-    if (buf_ != NULL)
-    {
-        delete [] buf_;
-        buf_ = NULL;
-    }
+    // nothing to do here, the buffers are freed together with this object
 }
@@ -8,6 +8,7 @@
 #define SOCI_POSTGRESQL_SOURCE
 #include "soci-postgresql.h"
 #include <soci-platform.h>
+#include "common.h"
 #include <libpq/libpq-fs.h> // libpq
 #include <cassert>
 #include <cctype>
@@ -30,10 +31,337 @@
 using namespace soci;
 using namespace soci::details;
 
+namespace // anonymous
+{
+
+// Splits the query in tokens: the keywords and the identifiers converted to
+// lower case, the quoted identifiers and strings with their quotes and the
+// other characters one by one.
+void tokenize(std::string const & query, std::vector<std::string> & tokens)
+{
+    std::string::size_type i = 0;
+    std::string::size_type const size = query.size();
+    while (i != size)
+    {
+        char const c = query[i];
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            ++i;
+        }
+        else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+        {
+            std::string word;
+            while (i != size &&
+                (std::isalnum(static_cast<unsigned char>(query[i])) ||
+                    query[i] == '_' || query[i] == '$'))
+            {
+                word += static_cast<char>(
+                    std::tolower(static_cast<unsigned char>(query[i])));
+                ++i;
+            }
+            tokens.push_back(word);
+        }
+        else if (c == '\'' || c == '"')
+        {
+            // the quotes are escaped by doubling them
+            std::string::size_type const begin = i++;
+            for (;;)
+            {
+                i = query.find(c, i);
+                if (i == std::string::npos)
+                {
+                    i = size;
+                    break;
+                }
+
+                ++i;
+                if (i == size || query[i] != c)
+                {
+                    break;
+                }
+                ++i;
+            }
+            tokens.push_back(query.substr(begin, i - begin));
+        }
+        else
+        {
+            tokens.push_back(std::string(1, c));
+            ++i;
+        }
+    }
+}
+
+void throw_unsupported_copy_option(std::string option)
+{
+    for (std::string::size_type i = 0; i != option.size(); ++i)
+    {
+        option[i] = static_cast<char>(
+            std::toupper(static_cast<unsigned char>(option[i])));
+    }
+
+    throw soci_error("COPY option " + option + " is not supported.");
+}
+
+// Returns the format of the data of the given query if it is a
+// "COPY ... FROM STDIN" statement, i.e. one of
+//
+//   COPY table [(column, ...)] FROM STDIN [[WITH] (option [value], ...)]
+//   COPY table [(column, ...)] FROM STDIN [[WITH] [BINARY] [OIDS] ...]
+//   COPY [BINARY] table [WITH OIDS] FROM STDIN
+//
+// Throws if the options change the text format in a way which is not
+// supported by the use elements.
+postgresql_statement_backend::copy_format get_copy_format(
+    std::string const & query)
+{
+    // don't tokenize the other queries
+    std::string::size_type const first = query.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos ||
+        (query[first] != 'c' && query[first] != 'C'))
+    {
+        return postgresql_statement_backend::copy_none;
+    }
+
+    std::vector<std::string> tokens;
+    tokenize(query, tokens);
+
+    // the empty token marks the end of the query
+    tokens.push_back(std::string());
+    std::size_t i = 0;
+
+    if (tokens[i] != "copy")
+    {
+        return postgresql_statement_backend::copy_none;
+    }
+    ++i;
+
+    bool binary = false;
+    if (tokens[i] == "binary")
+    {
+        binary = true;
+        ++i;
+    }
+
+    // the (qualified) name of the table, not a query which can only be
+    // copied to the client
+    if (tokens[i].empty() || tokens[i] == "(")
+    {
+        return postgresql_statement_backend::copy_none;
+    }
+    ++i;
+    while (tokens[i] == "." && tokens[i + 1].empty() == false)
+    {
+        i += 2;
+    }
+
+    // the names of the columns are not relevant
+    if (tokens[i] == "(")
+    {
+        while (tokens[i].empty() == false && tokens[i] != ")")
+        {
+            ++i;
+        }
+        if (tokens[i] == ")")
+        {
+            ++i;
+        }
+    }
+
+    if (tokens[i] == "with" && tokens[i + 1] == "oids")
+    {
+        i += 2;
+    }
+
+    if (tokens[i] != "from" || tokens[i + 1] != "stdin")
+    {
+        return postgresql_statement_backend::copy_none;
+    }
+    i += 2;
+
+    if (tokens[i] == "using" || tokens[i] == "delimiters")
+    {
+        throw_unsupported_copy_option("DELIMITERS");
+    }
+
+    if (tokens[i] == "with")
+    {
+        ++i;
+    }
+
+    if (tokens[i] == "(")
+    {
+        // the options separated by commas, each with an optional value
+        ++i;
+        while (tokens[i].empty() == false && tokens[i] != ")")
+        {
+            std::string const option = tokens[i++];
+            if (option == "format")
+            {
+                if (tokens[i] == "binary")
+                {
+                    binary = true;
+                }
+                else if (tokens[i] == "text")
+                {
+                    binary = false;
+                }
+                else
+                {
+                    throw_unsupported_copy_option("FORMAT " + tokens[i]);
+                }
+                ++i;
+            }
+            else if (option == "freeze" || option == "oids")
+            {
+                // don't change the format, may be followed by a boolean
+                while (tokens[i].empty() == false &&
+                    tokens[i] != "," && tokens[i] != ")")
+                {
+                    ++i;
+                }
+            }
+            else
+            {
+                throw_unsupported_copy_option(option);
+            }
+
+            if (tokens[i] == ",")
+            {
+                ++i;
+            }
+            else if (tokens[i] != ")")
+            {
+                throw soci_error("Cannot parse the options of COPY.");
+            }
+        }
+    }
+    else
+    {
+        // the options of the old syntax, separated by spaces
+        while (tokens[i].empty() == false && tokens[i] != ";")
+        {
+            std::string const option = tokens[i++];
+            if (option == "binary")
+            {
+                binary = true;
+            }
+            else if (option != "oids" && option != "freeze")
+            {
+                throw_unsupported_copy_option(option);
+            }
+        }
+    }
+
+    return binary
+        ? postgresql_statement_backend::copy_binary
+        : postgresql_statement_backend::copy_text;
+}
+
+// appends the value to the data sent by COPY in the text format
+void append_copy_text(std::vector<char> & data, char const * value, int len)
+{
+    if (value == NULL)
+    {
+        data.push_back('\\');
+        data.push_back('N');
+        return;
+    }
+
+    for (int i = 0; i != len; ++i)
+    {
+        char const c = value[i];
+        switch (c)
+        {
+        case '\\':
+            data.push_back('\\');
+            data.push_back('\\');
+            break;
+        case '\t':
+            data.push_back('\\');
+            data.push_back('t');
+            break;
+        case '\n':
+            data.push_back('\\');
+            data.push_back('n');
+            break;
+        case '\r':
+            data.push_back('\\');
+            data.push_back('r');
+            break;
+        default:
+            data.push_back(c);
+        }
+    }
+}
+
+// appends an integer in the network byte order
+void append_copy_integer(std::vector<char> & data, long long val, int len)
+{
+    char buf[8];
+    postgresql::integer_to_binary(val, len, buf);
+    data.insert(data.end(), buf, buf + len);
+}
+
+// appends the value to the data sent by COPY in the binary format
+void append_copy_binary(std::vector<char> & data, char const * value, int len)
+{
+    if (value == NULL)
+    {
+        append_copy_integer(data, -1, 4);
+        return;
+    }
+
+    append_copy_integer(data, len, 4);
+    data.insert(data.end(), value, value + len);
+}
+
+// appends a copy of the given row of one result to another one
+void copy_row(PGresult * dest, int destRow, PGresult const * src, int srcRow)
+{
+    int const fields = PQnfields(src);
+    for (int i = 0; i != fields; ++i)
+    {
+        int ok;
+        if (PQgetisnull(src, srcRow, i))
+        {
+            ok = PQsetvalue(dest, destRow, i, NULL, -1);
+        }
+        else
+        {
+            ok = PQsetvalue(dest, destRow, i, PQgetvalue(src, srcRow, i),
+                PQgetlength(src, srcRow, i));
+        }
+
+        if (ok == 0)
+        {
+            throw soci_error("Cannot store the fetched row.");
+        }
+    }
+}
+
+// sends the accumulated data to the server
+void put_copy_data(PGconn * conn, std::vector<char> & data)
+{
+    if (data.empty())
+    {
+        return;
+    }
+
+    if (PQputCopyData(conn, &data[0], static_cast<int>(data.size())) != 1)
+    {
+        throw soci_error(PQerrorMessage(conn));
+    }
+
+    data.clear();
+}
+
+} // namespace anonymous
+
 postgresql_statement_backend::postgresql_statement_backend(
     postgresql_session_backend &session)
      : session_(session)
-     , rowsAffectedBulk_(-1LL), justDescribed_(false)
+     , sharedStatement_(NULL), privateStatement_(), copyFormat_(copy_none)
+     , rowsAffectedBulk_(-1LL), streaming_(false), justDescribed_(false)
      , hasIntoElements_(false), hasVectorIntoElements_(false)
      , hasUseElements_(false), hasVectorUseElements_(false)
 {
@@ -41,11 +369,20 @@ postgresql_statement_backend::postgresql_statement_backend(
 
 postgresql_statement_backend::~postgresql_statement_backend()
 {
+    finish_streaming();
+
     if (statementName_.empty() == false)
     {
         try
         {
-            session_.deallocate_prepared_statement(statementName_);
+            if (sharedStatement_ != NULL)
+            {
+                session_.release_prepared_statement(query_);
+            }
+            else
+            {
+                session_.deallocate_prepared_statement(statementName_);
+            }
         }
         catch (...)
         {
@@ -67,8 +404,10 @@ void postgresql_statement_backend::clean_up()
     // 'reset' the value for a 
     // potential new execution.
     rowsAffectedBulk_ = -1;
-    
-    // nothing to do here
+
+    // the connection can't be used for anything else before all the
+    // streamed results are consumed
+    finish_streaming();
 }
 
 void postgresql_statement_backend::prepare(std::string const & query,
@@ -177,23 +516,39 @@ void postgresql_statement_backend::prepare(std::string const & query,
 
 #endif // SOCI_POSTGRESQL_NOBINDBYNAME
 
+    // COPY can't be prepared, it is always executed as a one-time query
+    copyFormat_ = get_copy_format(query_);
+
 #ifndef SOCI_POSTGRESQL_NOPREPARE
 
-    if (stType == st_repeatable_query)
+    if (stType == st_repeatable_query && copyFormat_ == copy_none)
     {
-        assert(statementName_.empty());
+        // the same query may already be prepared for another statement
+        sharedStatement_ = session_.use_prepared_statement(query_);
+        if (sharedStatement_ != NULL)
+        {
+            statementName_ = sharedStatement_->name_;
+        }
+        else
+        {
+            assert(statementName_.empty());
 
-        // Holding the name temporarily in this var because
-        // if it fails to prepare it we can't DEALLOCATE it. 
-        std::string statementName = session_.get_next_statement_name();
+            // Holding the name temporarily in this var because
+            // if it fails to prepare it we can't DEALLOCATE it. 
+            std::string statementName = session_.get_next_statement_name();
 
-        postgresql_result result(
-            PQprepare(session_.conn_, statementName.c_str(),
-              query_.c_str(), static_cast<int>(names_.size()), NULL));
-        result.check_for_errors("Cannot prepare statement.");
+            postgresql_result result(
+                PQprepare(session_.conn_, statementName.c_str(),
+                  query_.c_str(), static_cast<int>(names_.size()), NULL));
+            result.check_for_errors("Cannot prepare statement.");
 
-        // Now it's safe to save this info.
-        statementName_ = statementName;
+            // Now it's safe to save this info.
+            statementName_ = statementName;
+
+            sharedStatement_ = session_.add_prepared_statement(
+                query_, statementName_);
+            privateStatement_.described_ = false;
+        }
     }
 
     stType_ = stType;
@@ -201,6 +556,319 @@ void postgresql_statement_backend::prepare(std::string const & query,
 #endif // SOCI_POSTGRESQL_NOPREPARE
 }
 
+int postgresql_statement_backend::get_result_format()
+{
+    // the binary format can only be requested for all the columns at once,
+    // so the text one is used unless the statement is known to return only
+    // the values which are decoded in the same way from both of them
+    if (session_.binaryResults_ == false || statementName_.empty())
+    {
+        return 0;
+    }
+
+    postgresql_prepared_statement const & described = describe_statement();
+    if (described.textResults_)
+    {
+        return 0;
+    }
+
+    // the binary timestamptz values are always in UTC
+    if (described.zonedResults_ && session_.is_utc_time_zone() == false)
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+postgresql_prepared_statement &
+postgresql_statement_backend::describe_statement()
+{
+    postgresql_prepared_statement & ps =
+        sharedStatement_ != NULL ? *sharedStatement_ : privateStatement_;
+    if (ps.described_)
+    {
+        return ps;
+    }
+
+    postgresql_result description(
+        PQdescribePrepared(session_.conn_, statementName_.c_str()));
+    description.check_for_errors("Cannot describe prepared statement.");
+
+    int const paramsCount = PQnparams(description);
+    std::vector<Oid> paramTypes(paramsCount);
+    for (int i = 0; i != paramsCount; ++i)
+    {
+        paramTypes[i] = PQparamtype(description, i);
+    }
+
+    bool zonedResults = false;
+    bool textResults = false;
+    int const fieldsCount = PQnfields(description);
+    for (int i = 0; i != fieldsCount; ++i)
+    {
+        Oid const type = PQftype(description, i);
+        if (type == postgresql::oid_timestamptz)
+        {
+            zonedResults = true;
+        }
+        else if (postgresql::is_binary_result_type(type) == false)
+        {
+            textResults = true;
+        }
+    }
+
+    ps.paramTypes_.swap(paramTypes);
+    ps.zonedResults_ = zonedResults;
+    ps.textResults_ = textResults;
+    ps.described_ = true;
+
+    return ps;
+}
+
+void postgresql_statement_backend::add_param(
+    postgresql_use_buffers const & buffers, int i)
+{
+    paramValues_.push_back(buffers.values_[i]);
+    paramLengths_.push_back(buffers.lengths_[i]);
+    paramFormats_.push_back(buffers.format_);
+}
+
+void postgresql_statement_backend::copy_in(int number)
+{
+    if (useByNameBuffers_.empty() == false)
+    {
+        throw soci_error("COPY can only be used with use elements "
+            "bound by position.");
+    }
+
+    // without any use elements there is simply nothing to copy
+    std::size_t const rows = useByPosBuffers_.empty()
+        ? 0 : (number > 0 ? number : 1);
+    for (UseByPosBuffersMap::iterator it = useByPosBuffers_.begin(),
+             end = useByPosBuffers_.end(); it != end; ++it)
+    {
+        if (it->second->values_.size() < rows)
+        {
+            throw soci_error("Bulk and single use elements can't be mixed "
+                "in COPY.");
+        }
+    }
+
+    result_.reset(PQexec(session_.conn_, query_.c_str()));
+    if (PQresultStatus(result_) != PGRES_COPY_IN)
+    {
+        result_.check_for_errors("Cannot start COPY.");
+        throw soci_error("Cannot start COPY, unexpected result status.");
+    }
+
+    // the data is sent in chunks of roughly this size
+    std::size_t const chunkSize = 65536;
+
+    try
+    {
+        copyData_.clear();
+
+        if (copyFormat_ == copy_binary)
+        {
+            // signature, flags and the header extension length
+            static char const header[] = "PGCOPY\n\377\r\n";
+            copyData_.insert(copyData_.end(), header, header + sizeof(header));
+            append_copy_integer(copyData_, 0, 4);
+            append_copy_integer(copyData_, 0, 4);
+        }
+
+        for (std::size_t i = 0; i != rows; ++i)
+        {
+            if (copyFormat_ == copy_binary)
+            {
+                append_copy_integer(copyData_,
+                    static_cast<long long>(useByPosBuffers_.size()), 2);
+            }
+
+            for (UseByPosBuffersMap::iterator it = useByPosBuffers_.begin(),
+                     end = useByPosBuffers_.end(); it != end; ++it)
+            {
+                postgresql_use_buffers const & buffers = *it->second;
+                if (copyFormat_ == copy_binary)
+                {
+                    append_copy_binary(copyData_,
+                        buffers.values_[i], buffers.lengths_[i]);
+                }
+                else
+                {
+                    if (it != useByPosBuffers_.begin())
+                    {
+                        copyData_.push_back('\t');
+                    }
+                    append_copy_text(copyData_,
+                        buffers.values_[i], buffers.lengths_[i]);
+                }
+            }
+
+            if (copyFormat_ == copy_text)
+            {
+                copyData_.push_back('\n');
+            }
+
+            if (copyData_.size() >= chunkSize)
+            {
+                put_copy_data(session_.conn_, copyData_);
+            }
+        }
+
+        if (copyFormat_ == copy_binary)
+        {
+            // file trailer
+            append_copy_integer(copyData_, -1, 2);
+        }
+
+        put_copy_data(session_.conn_, copyData_);
+    }
+    catch (...)
+    {
+        // abort the COPY, the server must be told about it
+        PQputCopyEnd(session_.conn_, "Cannot send COPY data.");
+        while (PGresult * res = PQgetResult(session_.conn_))
+        {
+            PQclear(res);
+        }
+        result_.reset();
+        throw;
+    }
+
+    if (PQputCopyEnd(session_.conn_, NULL) != 1)
+    {
+        throw soci_error(PQerrorMessage(session_.conn_));
+    }
+
+    // the final result of the COPY command holds the number of copied rows
+    result_.reset(PQgetResult(session_.conn_));
+    while (PGresult * res = PQgetResult(session_.conn_))
+    {
+        PQclear(res);
+    }
+
+    result_.check_for_errors("Cannot execute COPY.");
+}
+
+void postgresql_statement_backend::send_query(int resultFormat)
+{
+    int const paramsCount = static_cast<int>(paramValues_.size());
+    char const * const * values = paramsCount != 0 ? &paramValues_[0] : NULL;
+    int const * lengths = paramsCount != 0 ? &paramLengths_[0] : NULL;
+    int const * formats = paramsCount != 0 ? &paramFormats_[0] : NULL;
+
+    int sent;
+    if (statementName_.empty() == false)
+    {
+        // this query was separately prepared
+        sent = PQsendQueryPrepared(session_.conn_, statementName_.c_str(),
+            paramsCount, values, lengths, formats, resultFormat);
+    }
+    else
+    {
+        sent = PQsendQueryParams(session_.conn_, query_.c_str(),
+            paramsCount, NULL, values, lengths, formats, resultFormat);
+    }
+
+    if (sent != 1)
+    {
+        throw soci_error(PQerrorMessage(session_.conn_));
+    }
+
+    streaming_ = true;
+
+    if (PQsetSingleRowMode(session_.conn_) != 1)
+    {
+        finish_streaming();
+        throw soci_error("Cannot switch to single row mode.");
+    }
+
+    result_.reset();
+    numberOfRows_ = 0;
+    currentRow_ = 0;
+    rowsToConsume_ = 0;
+
+    read_rows(session_.fetchChunkSize_);
+}
+
+void postgresql_statement_backend::read_rows(int count)
+{
+    postgresql_result chunk;
+    int rows = 0;
+
+    if (currentRow_ < numberOfRows_)
+    {
+        // keep the rows which were not consumed yet
+        chunk.reset(PQcopyResult(result_, PG_COPYRES_ATTRS));
+        for (int row = currentRow_; row != numberOfRows_; ++row)
+        {
+            copy_row(chunk.get_result(), rows++, result_, row);
+        }
+    }
+
+    while (rows < count)
+    {
+        postgresql_result next(PQgetResult(session_.conn_));
+        if (PQresultStatus(next) != PGRES_SINGLE_TUPLE)
+        {
+            // this is the final result of the query, all the rows were
+            // received or an error occurred
+            streaming_ = false;
+            while (PGresult * res = PQgetResult(session_.conn_))
+            {
+                PQclear(res);
+            }
+
+            next.check_for_data("Cannot execute query.");
+            if (chunk.get_result() == NULL)
+            {
+                chunk.reset(next.get_result());
+                next.release();
+            }
+            break;
+        }
+
+        if (chunk.get_result() == NULL)
+        {
+            // the first row is simply kept in its own result
+            chunk.reset(next.get_result());
+            next.release();
+            rows = 1;
+        }
+        else
+        {
+            copy_row(chunk.get_result(), rows++, next, 0);
+        }
+    }
+
+    result_.reset(chunk.get_result());
+    chunk.release();
+
+    numberOfRows_ = PQntuples(result_);
+    currentRow_ = 0;
+    rowsToConsume_ = 0;
+}
+
+void postgresql_statement_backend::finish_streaming()
+{
+    if (streaming_ == false)
+    {
+        return;
+    }
+
+    streaming_ = false;
+
+    // the remaining rows are read and discarded: cancelling the query
+    // instead would abort the transaction it is part of, if any, and the
+    // transaction status can't be checked while the query is still active
+    while (PGresult * res = PQgetResult(session_.conn_))
+    {
+        PQclear(res);
+    }
+}
+
 statement_backend::exec_fetch_result
 postgresql_statement_backend::execute(int number)
 {
@@ -230,12 +898,25 @@ postgresql_statement_backend::execute(int number)
         // specifies the size of vectors (into/use), but 'numberOfExecutions'
         // specifies the number of loops that need to be performed.
 
+        if (copyFormat_ != copy_none)
+        {
+            copy_in(number);
+            return ef_no_data;
+        }
+
+        // the format applies to all the result columns
+        int const resultFormat = get_result_format();
+
         int numberOfExecutions = 1;
         if (number > 0)
         {
              numberOfExecutions = hasUseElements_ ? 1 : number;
         }
 
+        // the results of a single execution can be streamed
+        bool const stream =
+            session_.fetchChunkSize_ > 0 && numberOfExecutions == 1;
+
         if ((useByPosBuffers_.empty() == false) ||
             (useByNameBuffers_.empty() == false))
         {
@@ -249,7 +930,9 @@ postgresql_statement_backend::execute(int number)
             long long rowsAffectedBulkTemp = 0;
             for (int i = 0; i != numberOfExecutions; ++i)
             {
-                std::vector<char *> paramValues;
+                paramValues_.clear();
+                paramLengths_.clear();
+                paramFormats_.clear();
 
                 if (useByPosBuffers_.empty() == false)
                 {
@@ -262,8 +945,7 @@ postgresql_statement_backend::execute(int number)
                              end = useByPosBuffers_.end();
                          it != end; ++it)
                     {
-                        char ** buffers = it->second;
-                        paramValues.push_back(buffers[i]);
+                        add_param(*it->second, i);
                     }
                 }
                 else
@@ -284,8 +966,7 @@ postgresql_statement_backend::execute(int number)
                             msg += ").";
                             throw soci_error(msg);
                         }
-                        char ** buffers = b->second;
-                        paramValues.push_back(buffers[i]);
+                        add_param(*b->second, i);
                     }
                 }
 
@@ -295,20 +976,29 @@ postgresql_statement_backend::execute(int number)
 
 #else
 
+                if (stream)
+                {
+                    // only the first rows are retrieved here
+                    send_query(resultFormat);
+                }
 #ifdef SOCI_POSTGRESQL_NOPREPARE
-
-                result_.reset(PQexecParams(session_.conn_, query_.c_str(),
-                    static_cast<int>(paramValues.size()),
-                    NULL, &paramValues[0], NULL, NULL, 0));
+                else
+                {
+                    result_.reset(PQexecParams(session_.conn_, query_.c_str(),
+                        static_cast<int>(paramValues_.size()),
+                        NULL, &paramValues_[0], &paramLengths_[0],
+                        &paramFormats_[0], resultFormat));
+                }
 #else
-                if (stType_ == st_repeatable_query)
+                else if (stType_ == st_repeatable_query)
                 {
                     // this query was separately prepared
 
                     result_.reset(PQexecPrepared(session_.conn_,
                         statementName_.c_str(),
-                        static_cast<int>(paramValues.size()),
-                        &paramValues[0], NULL, NULL, 0));
+                        static_cast<int>(paramValues_.size()),
+                        &paramValues_[0], &paramLengths_[0],
+                        &paramFormats_[0], resultFormat));
                 }
                 else // stType_ == st_one_time_query
                 {
@@ -316,8 +1006,9 @@ postgresql_statement_backend::execute(int number)
                     // be executed as a one-time query
 
                     result_.reset(PQexecParams(session_.conn_, query_.c_str(),
-                        static_cast<int>(paramValues.size()),
-                        NULL, &paramValues[0], NULL, NULL, 0));
+                        static_cast<int>(paramValues_.size()),
+                        NULL, &paramValues_[0], &paramLengths_[0],
+                        &paramFormats_[0], resultFormat));
                 }
 
 #endif // SOCI_POSTGRESQL_NOPREPARE
@@ -352,16 +1043,40 @@ postgresql_statement_backend::execute(int number)
             // there are no use elements
             // - execute the query without parameter information
 
-#ifdef SOCI_POSTGRESQL_NOPREPARE
+            paramValues_.clear();
+            paramLengths_.clear();
+            paramFormats_.clear();
 
-            result_.reset(PQexec(session_.conn_, query_.c_str()));
+            if (stream)
+            {
+                // only the first rows are retrieved here
+                send_query(resultFormat);
+            }
+#ifdef SOCI_POSTGRESQL_NOPREPARE
+            else if (resultFormat != 0)
+            {
+                // PQexec() can only return the results in the text format
+                result_.reset(PQexecParams(session_.conn_, query_.c_str(),
+                    0, NULL, NULL, NULL, NULL, resultFormat));
+            }
+            else
+            {
+                result_.reset(PQexec(session_.conn_, query_.c_str()));
+            }
 #else
-            if (stType_ == st_repeatable_query)
+            else if (stType_ == st_repeatable_query)
             {
                 // this query was separately prepared
 
                 result_.reset(PQexecPrepared(session_.conn_,
-                    statementName_.c_str(), 0, NULL, NULL, NULL, 0));
+                    statementName_.c_str(), 0, NULL, NULL, NULL,
+                    resultFormat));
+            }
+            else if (resultFormat != 0)
+            {
+                // PQexec() can only return the results in the text format
+                result_.reset(PQexecParams(session_.conn_, query_.c_str(),
+                    0, NULL, NULL, NULL, NULL, resultFormat));
             }
             else // stType_ == st_one_time_query
             {
@@ -422,6 +1137,14 @@ postgresql_statement_backend::fetch(int number)
 
     // forward the "cursor" from the last fetch
     currentRow_ += rowsToConsume_;
+    rowsToConsume_ = 0;
+
+    if (streaming_ && numberOfRows_ - currentRow_ < number)
+    {
+        // not enough rows in memory, get more of them from the server
+        read_rows(number > session_.fetchChunkSize_
+            ? number : session_.fetchChunkSize_);
+    }
 
     if (currentRow_ >= numberOfRows_)
     {
@@ -562,6 +1285,82 @@ void postgresql_statement_backend::describe_column(int colNum, data_type & type,
     columnName = PQfname(result_, pos);
 }
 
+bool postgresql_statement_backend::use_binary_format(int position,
+    std::string const & name, unsigned long typeOid)
+{
+    if (copyFormat_ != copy_none)
+    {
+        // the types of the columns are not known, the user is responsible
+        // for using the matching ones
+        return copyFormat_ == copy_binary;
+    }
+
+    // the types of the parameters are only asked from the server, at the
+    // cost of a round trip, once for the statements shared by the session
+    if (sharedStatement_ == NULL || names_.empty())
+    {
+        return false;
+    }
+
+    std::vector<Oid> const & paramTypes = describe_statement().paramTypes_;
+
+    if (position > 0)
+    {
+        return static_cast<std::size_t>(position) <= paramTypes.size() &&
+            paramTypes[position - 1] == typeOid;
+    }
+
+    // the same name can be used for several parameters, all of them must
+    // be of the same type
+    bool found = false;
+    for (std::size_t i = 0; i != names_.size(); ++i)
+    {
+        if (names_[i] == name)
+        {
+            if (i >= paramTypes.size() || paramTypes[i] != typeOid)
+            {
+                return false;
+            }
+
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+bool postgresql_statement_backend::reset_for_reuse()
+{
+    // the query was already rewritten and prepared on the server, only
+    // forget about the results and the buffers of the old use elements
+    finish_streaming();
+    result_.reset();
+    rowsAffectedBulk_ = -1;
+    justDescribed_ = false;
+
+    hasIntoElements_ = false;
+    hasVectorIntoElements_ = false;
+    hasUseElements_ = false;
+    hasVectorUseElements_ = false;
+
+    useByPosBuffers_.clear();
+    useByNameBuffers_.clear();
+
+    return true;
+}
+
+void postgresql_statement_backend::reuse_into_type_backend(
+    details::standard_into_type_backend * /* backEnd */)
+{
+    hasIntoElements_ = true;
+}
+
+void postgresql_statement_backend::reuse_use_type_backend(
+    details::standard_use_type_backend * /* backEnd */)
+{
+    hasUseElements_ = true;
+}
+
 postgresql_standard_into_type_backend *
 postgresql_statement_backend::make_into_type_backend()
 {
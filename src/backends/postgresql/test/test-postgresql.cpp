@@ -17,6 +17,10 @@
 #include <ctime>
 #include <cstdlib>
 
+#ifndef _WIN32
+#include <poll.h>
+#endif
+
 using namespace soci;
 using namespace soci::tests;
 
@@ -704,6 +708,783 @@ void test_orm_cast()
     sql << "select :a::int", use(v); // Must not throw an exception!
 }
 
+struct table_creator_binary : public table_creator_base
+{
+    table_creator_binary(session& sql) : table_creator_base(sql)
+    {
+        sql << "drop table if exists soci_test;";
+        sql << "create table soci_test(sh int2, i int4, ll int8, d float8, "
+               "n numeric(20, 3), dt date, tm timestamp, b bytea, "
+               "s varchar(20), f boolean)";
+    }
+};
+
+// Test the results received in the binary format
+void test_binary_results()
+{
+    {
+        session sql(backEnd, connectString + " binary_results=1");
+        table_creator_binary tableCreator(sql);
+
+        // only the prepared statements can be described to find out if
+        // their results can be received in the binary format
+        sql.set_statement_cache_size(10);
+
+        sql << "insert into soci_test values(-7, 123456, 9876543210, 3.25, "
+               "-12345.678, '2014-03-15', '1999-12-31 23:59:58.5', "
+               "'\\x0d0c0b0a', 'abc', true)";
+
+        short sh;
+        int i;
+        long long ll;
+        double d;
+        std::string n;
+        std::tm dt;
+        std::tm tm;
+        std::string b;
+        std::string s;
+        int f;
+        sql << "select sh, i, ll, d, n, dt, tm, b, s, f from soci_test",
+            into(sh), into(i), into(ll), into(d), into(n), into(dt), into(tm),
+            into(b), into(s), into(f);
+
+        assert(sh == -7);
+        assert(i == 123456);
+        assert(ll == 9876543210LL);
+        assert(equal_approx(d, 3.25));
+        assert(n == "-12345.678");
+        assert(dt.tm_year == 114 && dt.tm_mon == 2 && dt.tm_mday == 15);
+        assert(tm.tm_year == 99 && tm.tm_mon == 11 && tm.tm_mday == 31);
+        assert(tm.tm_hour == 23 && tm.tm_min == 59 && tm.tm_sec == 58);
+        assert(b == std::string("\x0d\x0c\x0b\x0a", 4));
+        assert(s == "abc");
+        assert(f == 1);
+
+        // the numeric types can still be converted to each other and to text
+        std::string str;
+        sql << "select i from soci_test", into(str);
+        assert(str == "123456");
+        sql << "select n from soci_test", into(d);
+        assert(equal_approx(d, -12345.678));
+        sql << "select ll from soci_test", into(d);
+        assert(equal_approx(d, 9876543210.0));
+
+        // the same for the vectors and the dynamic rows
+        sql << "insert into soci_test(i, tm) values(-1, '2000-01-01')";
+
+        std::vector<int> iv(10);
+        std::vector<std::tm> tv(10);
+        sql << "select i, tm from soci_test order by i", into(iv), into(tv);
+        assert(iv.size() == 2);
+        assert(iv[0] == -1 && iv[1] == 123456);
+        assert(tv[0].tm_year == 100 && tv[0].tm_mon == 0 && tv[0].tm_mday == 1);
+        assert(tv[1].tm_year == 99 && tv[1].tm_sec == 58);
+
+        row r;
+        sql << "select ll, d, s from soci_test where i = 123456", into(r);
+        assert(r.get<long long>(0) == 9876543210LL);
+        assert(equal_approx(r.get<double>(1), 3.25));
+        assert(r.get<std::string>(2) == "abc");
+
+        // a boolean read into char is the same in both formats
+        char c = '\0';
+        sql << "select f from soci_test where i = 123456", into(c);
+        assert(c == 't');
+
+        // the values of the types without a binary decoder are received as
+        // text, together with all the other columns of the same result
+        std::string u;
+        sql << "select i, 'a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11'::uuid "
+               "from soci_test where i = 123456", into(i), into(u);
+        assert(i == 123456);
+        assert(u == "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11");
+        sql << "select interval '1 day 02:03:04'", into(u);
+        assert(u == "1 day 02:03:04");
+        sql << "select array[1, 2, 3]", into(u);
+        assert(u == "{1,2,3}");
+        sql << "select f from soci_test where i = 123456", into(c);
+        assert(c == 't');
+
+        row ru;
+        sql << "select '{\"a\": 1}'::json", into(ru);
+        assert(ru.get<std::string>(0) == "{\"a\": 1}");
+    }
+
+    // the timestamptz values are in the session time zone in both formats
+    {
+        session text(backEnd, connectString);
+        session binary(backEnd,
+            connectString + " binary_results=1 max_prepared_statements=10");
+
+        char const * const zones[] = { "UTC", "America/New_York", "Asia/Kolkata" };
+        for (int i = 0; i != 3; ++i)
+        {
+            std::string const setZone =
+                std::string("set timezone to '") + zones[i] + "'";
+            text << setZone;
+            binary << setZone;
+
+            std::string const query =
+                "select timestamptz '2014-07-01 12:34:56+00'";
+
+            std::tm t1, t2;
+            text << query, into(t1);
+            binary << query, into(t2);
+            assert(t1.tm_mday == t2.tm_mday && t1.tm_hour == t2.tm_hour &&
+                t1.tm_min == t2.tm_min && t1.tm_sec == t2.tm_sec);
+
+            std::string s1, s2;
+            text << query, into(s1);
+            binary << query, into(s2);
+            assert(s1 == s2);
+
+            std::tm t3;
+            statement st = (binary.prepare << query, into(t3));
+            st.execute(true);
+            assert(t3.tm_mday == t1.tm_mday && t3.tm_hour == t1.tm_hour &&
+                t3.tm_min == t1.tm_min);
+
+            row r;
+            binary << query, into(r);
+            assert(r.get<std::tm>(0).tm_hour == t1.tm_hour);
+        }
+
+        // the other shared prepared statements still use the binary format
+        binary << "set timezone to 'America/New_York'";
+        int i = 0;
+        statement st = (binary.prepare << "select 42", into(i));
+        st.execute(true);
+        assert(i == 42);
+
+        postgresql_statement_backend * const stb =
+            static_cast<postgresql_statement_backend *>(st.get_backend());
+        assert(PQfformat(stb->result_, 0) == 1);
+    }
+
+    {
+        bool caught = false;
+        try
+        {
+            session sql(backEnd, connectString + " binary_results=maybe");
+        }
+        catch (soci_error const &)
+        {
+            caught = true;
+        }
+        assert(caught);
+    }
+
+    std::cout << "test binary results passed" << std::endl;
+}
+
+struct table_creator_params : public table_creator_base
+{
+    table_creator_params(session& sql) : table_creator_base(sql)
+    {
+        sql << "drop table if exists soci_test;";
+        sql << "create table soci_test(sh int2, i int4, ll int8, d float8, "
+               "n numeric(10, 2), tm timestamp, s varchar(20))";
+    }
+};
+
+// Test the parameters sent in the binary format by the prepared statements
+void test_binary_params()
+{
+    {
+        // the types of the parameters are only known for the shared statements
+        session sql(backEnd, connectString + " max_prepared_statements=10");
+        table_creator_params tableCreator(sql);
+
+        short sh;
+        int i;
+        long long ll;
+        double d;
+        std::tm tm = std::tm();
+        int s;
+
+        // the value of i is also used as text and d as numeric, for which
+        // the text format must be used
+        statement st = (sql.prepare <<
+            "insert into soci_test values(:sh, :i, :ll, :d, :d, :tm, :s)",
+            use(sh, "sh"), use(i, "i"), use(ll, "ll"), use(d, "d"),
+            use(tm, "tm"), use(s, "s"));
+
+        for (int k = 0; k != 3; ++k)
+        {
+            sh = static_cast<short>(-k);
+            i = 100000 * k;
+            ll = 10000000000LL * k;
+            d = 1.25 * k;
+            tm.tm_year = 100 + k;
+            tm.tm_mon = k;
+            tm.tm_mday = 10 + k;
+            tm.tm_hour = k;
+            tm.tm_min = 2 * k;
+            tm.tm_sec = 3 * k;
+            s = -k;
+            st.execute(true);
+        }
+
+        std::vector<short> shv(10);
+        std::vector<int> iv(10);
+        std::vector<long long> llv(10);
+        std::vector<double> dv(10);
+        std::vector<std::string> nv(10);
+        std::vector<std::tm> tmv(10);
+        std::vector<std::string> sv(10);
+        sql << "select sh, i, ll, d, n, tm, s from soci_test order by i",
+            into(shv), into(iv), into(llv), into(dv), into(nv), into(tmv),
+            into(sv);
+
+        assert(iv.size() == 3);
+        for (int k = 0; k != 3; ++k)
+        {
+            assert(shv[k] == -k);
+            assert(iv[k] == 100000 * k);
+            assert(llv[k] == 10000000000LL * k);
+            assert(equal_approx(dv[k], 1.25 * k));
+            assert(tmv[k].tm_year == 100 + k);
+            assert(tmv[k].tm_mon == k);
+            assert(tmv[k].tm_mday == 10 + k);
+            assert(tmv[k].tm_hour == k);
+            assert(tmv[k].tm_min == 2 * k);
+            assert(tmv[k].tm_sec == 3 * k);
+        }
+        assert(nv[2] == "2.50");
+        assert(sv[1] == "-1");
+
+        // bulk operations use the same buffers for all the rows
+        std::vector<int> ins;
+        std::vector<indicator> inds;
+        for (int k = 0; k != 5; ++k)
+        {
+            ins.push_back(k + 1);
+            inds.push_back(k == 2 ? i_null : i_ok);
+        }
+
+        statement bulk = (sql.prepare <<
+            "insert into soci_test(i) values(:i)", use(ins, inds));
+        bulk.execute(true);
+        bulk.execute(true);
+
+        int count;
+        sql << "select count(*) from soci_test where i between 1 and 5",
+            into(count);
+        assert(count == 8);
+        sql << "select count(*) from soci_test where sh is null and i is null",
+            into(count);
+        assert(count == 2);
+
+        // the statements are only described when a value can go binary
+        std::string str("abc");
+        statement text = (sql.prepare <<
+            "select count(*) from soci_test where s = :s",
+            use(str), into(count));
+        text.execute(true);
+
+        postgresql_statement_backend * const stb =
+            static_cast<postgresql_statement_backend *>(text.get_backend());
+        assert(stb->sharedStatement_ != NULL);
+        assert(stb->sharedStatement_->described_ == false);
+    }
+
+    std::cout << "test binary params passed" << std::endl;
+}
+
+struct table_creator_copy : public table_creator_base
+{
+    table_creator_copy(session& sql) : table_creator_base(sql)
+    {
+        sql << "drop table if exists soci_test;";
+        sql << "create table soci_test(id int4, d float8, tm timestamp, "
+               "s text)";
+    }
+};
+
+// Test bulk loading with COPY FROM STDIN
+void test_copy()
+{
+    {
+        session sql(backEnd, connectString);
+        table_creator_copy tableCreator(sql);
+
+        std::vector<int> ids;
+        std::vector<double> ds;
+        std::vector<std::tm> tms;
+        std::vector<std::string> strs;
+        std::vector<indicator> inds;
+        for (int i = 0; i != 1000; ++i)
+        {
+            ids.push_back(i);
+            ds.push_back(i / 4.0);
+
+            std::tm t = std::tm();
+            t.tm_year = 110;
+            t.tm_mon = 5;
+            t.tm_mday = 1 + i % 28;
+            t.tm_hour = i % 24;
+            tms.push_back(t);
+
+            // the special characters must be escaped in the text format
+            std::ostringstream oss;
+            oss << "row\t" << i << "\\\n";
+            strs.push_back(oss.str());
+            inds.push_back(i % 10 == 0 ? i_null : i_ok);
+        }
+
+        statement text = (sql.prepare <<
+            "copy soci_test(id, d, tm, s) from stdin",
+            use(ids), use(ds), use(tms), use(strs, inds));
+        text.execute(true);
+        assert(text.get_affected_rows() == 1000);
+
+        // the same data again, but in binary format and in a second batch
+        // which reports its own number of rows
+        statement binary = (sql.prepare <<
+            "copy soci_test(id, d, tm, s) from stdin with (format binary)",
+            use(ids), use(ds), use(tms), use(strs, inds));
+        binary.execute(true);
+        assert(binary.get_affected_rows() == 1000);
+
+        ids.resize(10);
+        ds.resize(10);
+        tms.resize(10);
+        strs.resize(10);
+        inds.resize(10);
+        binary.execute(true);
+        assert(binary.get_affected_rows() == 10);
+
+        int count;
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 2010);
+        sql << "select count(*) from soci_test where s is null", into(count);
+        assert(count == 201);
+
+        std::string s;
+        double d;
+        std::tm tm;
+        sql << "select s, d, tm from soci_test where id = 7 limit 1",
+            into(s), into(d), into(tm);
+        assert(s == "row\t7\\\n");
+        assert(equal_approx(d, 1.75));
+        assert(tm.tm_mday == 8 && tm.tm_hour == 7);
+
+        sql << "select count(distinct s) from soci_test where id = 7",
+            into(count);
+        assert(count == 1);
+
+        // the names of the columns are not options
+        sql << "alter table soci_test add column \"binary\" int4";
+        std::vector<int> values(1, 12);
+        sql << "copy soci_test(\"binary\") from stdin", use(values);
+        sql << "select count(*) from soci_test where \"binary\" = 12",
+            into(count);
+        assert(count == 1);
+
+        // the old syntax of the options
+        sql << "copy soci_test(id) from stdin with binary", use(values);
+        sql << "select count(*) from soci_test where id = 12", into(count);
+        assert(count == 3);
+
+        // the options changing the text format are not supported
+        char const * const unsupported[] = {
+            "with (format csv)",
+            "with (delimiter ',')",
+            "(format text, null 'x')",
+            "csv header",
+            "with delimiter as ','",
+            "null ''"
+        };
+        for (int i = 0; i != 6; ++i)
+        {
+            try
+            {
+                sql << "copy soci_test(id) from stdin " << unsupported[i],
+                    use(values);
+                assert(false);
+            }
+            catch (soci_error const & e)
+            {
+                std::string const msg(e.what());
+                assert(msg.find("COPY option") != std::string::npos);
+            }
+        }
+    }
+
+    std::cout << "test copy passed" << std::endl;
+}
+
+struct table_creator_streaming : public table_creator_base
+{
+    table_creator_streaming(session& sql) : table_creator_base(sql)
+    {
+        sql << "drop table if exists soci_test;";
+        sql << "create table soci_test(val integer)";
+    }
+};
+
+// Test streaming the results in chunks
+void test_streaming()
+{
+    {
+        session sql(backEnd, connectString + " fetch_chunk_size=3");
+        table_creator_streaming tableCreator(sql);
+
+        for (int i = 0; i != 10; ++i)
+        {
+            sql << "insert into soci_test(val) values(:val)", use(i);
+        }
+
+        // bulk fetches spanning several chunks
+        std::vector<int> vals(4);
+        statement st = (sql.prepare <<
+            "select val from soci_test order by val", into(vals));
+        st.execute();
+        int expected = 0;
+        while (st.fetch())
+        {
+            for (std::size_t i = 0; i != vals.size(); ++i)
+            {
+                assert(vals[i] == expected++);
+            }
+        }
+        assert(expected == 10);
+
+        // dynamic rows and rowsets
+        expected = 0;
+        rowset<row> rs = (sql.prepare << "select val from soci_test order by val");
+        for (rowset<row>::const_iterator it = rs.begin(); it != rs.end(); ++it)
+        {
+            assert(it->get<int>(0) == expected++);
+        }
+        assert(expected == 10);
+
+        // abandoning a query in the middle leaves the session usable
+        {
+            int val;
+            statement partial = (sql.prepare <<
+                "select val from soci_test order by val", into(val));
+            partial.execute(true);
+            assert(val == 0);
+        }
+
+        int count;
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 10);
+
+        // and doesn't abort the transaction it is part of
+        {
+            transaction tr(sql);
+
+            int val;
+            statement partial = (sql.prepare <<
+                "select val from soci_test order by val", into(val));
+            partial.execute(true);
+            assert(val == 0);
+            partial.execute(true);
+            assert(val == 0);
+
+            sql << "insert into soci_test(val) values(10)";
+            tr.commit();
+        }
+
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 11);
+
+        // errors are still reported
+        bool caught = false;
+        try
+        {
+            std::vector<int> all(11);
+            sql << "select 1 / (val - 5) from soci_test", into(all);
+        }
+        catch (soci_error const &)
+        {
+            caught = true;
+        }
+        assert(caught);
+
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 11);
+    }
+
+    std::cout << "test streaming passed" << std::endl;
+}
+
+// Test sharing the server-side prepared statements
+void test_shared_prepared_statements()
+{
+    {
+        session sql(backEnd, connectString + " max_prepared_statements=2");
+
+        int count;
+        for (int i = 0; i != 3; ++i)
+        {
+            int val;
+            statement st = (sql.prepare << "select :i::int + 1",
+                use(i), into(val));
+            st.execute(true);
+            assert(val == i + 1);
+        }
+
+        sql << "select count(*) from pg_prepared_statements", into(count);
+        assert(count == 1);
+
+        // two statements alive at the same time can use the same one
+        {
+            int i = 1, j = 2, val1, val2;
+            statement st1 = (sql.prepare << "select :i::int + 1",
+                use(i), into(val1));
+            statement st2 = (sql.prepare << "select :i::int + 1",
+                use(j), into(val2));
+            st1.execute(true);
+            st2.execute(true);
+            assert(val1 == 2 && val2 == 3);
+        }
+
+        // the statements in use don't count against the limit
+        {
+            int val;
+            statement st1 = (sql.prepare << "select 101", into(val));
+            statement st2 = (sql.prepare << "select 102", into(val));
+            std::string name;
+            {
+                statement st3 = (sql.prepare << "select 103", into(val));
+                name = static_cast<postgresql_statement_backend *>(
+                    st3.get_backend())->statementName_;
+            }
+
+            statement st4 = (sql.prepare << "select 103", into(val));
+            assert(static_cast<postgresql_statement_backend *>(
+                st4.get_backend())->statementName_ == name);
+        }
+
+        // the statements are not deallocated inside a transaction, even
+        // a failed one
+        {
+            int val;
+            std::vector<statement> statements;
+            for (int i = 0; i != 20; ++i)
+            {
+                std::ostringstream oss;
+                oss << "select " << 300 + i;
+                statements.push_back((sql.prepare << oss.str(), into(val)));
+            }
+
+            transaction tr(sql);
+            statements.clear();
+            sql << "select count(*) from pg_prepared_statements", into(count);
+            assert(count >= 20);
+            tr.commit();
+        }
+        {
+            int val;
+            std::vector<statement> statements;
+            for (int i = 0; i != 20; ++i)
+            {
+                std::ostringstream oss;
+                oss << "select " << 200 + i;
+                statements.push_back((sql.prepare << oss.str(), into(val)));
+            }
+
+            transaction tr(sql);
+            try
+            {
+                sql << "select 1 / 0", into(count);
+                assert(false);
+            }
+            catch (soci_error const &)
+            {
+            }
+
+            statements.clear();
+            tr.rollback();
+        }
+
+        // the least recently used ones are eventually deallocated
+        for (int i = 0; i != 40; ++i)
+        {
+            std::ostringstream oss;
+            oss << "select " << i;
+            int val;
+            statement st = (sql.prepare << oss.str(), into(val));
+            st.execute(true);
+            assert(val == i);
+        }
+
+        sql << "select count(*) from pg_prepared_statements", into(count);
+        assert(count <= 2 + 16);
+    }
+
+    std::cout << "test shared prepared statements passed" << std::endl;
+}
+
+#ifndef _WIN32
+
+// non-blocking statements, waited for with poll() as an event loop would
+void async_completed(postgresql_async_statement &, void * arg)
+{
+    ++*static_cast<int *>(arg);
+}
+
+void wait_for(postgresql_async_statement & st)
+{
+    while (st.is_done() == false)
+    {
+        pollfd fd;
+        fd.fd = st.get_socket();
+        fd.events = POLLIN;
+        if (st.wants_write())
+        {
+            fd.events |= POLLOUT;
+        }
+        assert(poll(&fd, 1, 10000) == 1);
+
+        if (fd.revents & POLLOUT)
+        {
+            st.flush();
+        }
+        if (fd.revents & ~POLLOUT)
+        {
+            st.consume();
+        }
+    }
+}
+
+void test_async_statements()
+{
+    {
+        int const count = 4;
+        session sql[count];
+        postgresql_async_statement * st[count];
+
+        int completed = 0;
+        for (int i = 0; i != count; ++i)
+        {
+            sql[i].open(backEnd, connectString);
+            st[i] = new postgresql_async_statement(sql[i],
+                "select $1::int * 2 from pg_sleep(0.1)");
+
+            std::ostringstream oss;
+            oss << i;
+            st[i]->set_param(1, oss.str());
+            st[i]->execute(async_completed, &completed);
+            assert(st[i]->is_done() == false);
+        }
+
+        // all the queries are executed at the same time by a single thread
+        while (completed != count)
+        {
+            pollfd fds[count];
+            int indexes[count];
+            int n = 0;
+            for (int i = 0; i != count; ++i)
+            {
+                if (st[i]->is_done() == false)
+                {
+                    fds[n].fd = st[i]->get_socket();
+                    fds[n].events = POLLIN;
+                    if (st[i]->wants_write())
+                    {
+                        fds[n].events |= POLLOUT;
+                    }
+                    indexes[n++] = i;
+                }
+            }
+
+            assert(poll(fds, n, 10000) > 0);
+
+            for (int j = 0; j != n; ++j)
+            {
+                if (fds[j].revents & POLLOUT)
+                {
+                    st[indexes[j]]->flush();
+                }
+                if (fds[j].revents & ~POLLOUT)
+                {
+                    st[indexes[j]]->consume();
+                }
+            }
+        }
+
+        for (int i = 0; i != count; ++i)
+        {
+            assert(st[i]->failed() == false);
+            assert(st[i]->get_number_of_rows() == 1);
+            assert(st[i]->get_number_of_columns() == 1);
+
+            std::ostringstream oss;
+            oss << i * 2;
+            assert(st[i]->get_value(0, 0) == oss.str());
+        }
+
+        // the statement stays prepared for the next executions
+        st[0]->set_null_param(1);
+        st[0]->execute();
+        wait_for(*st[0]);
+        assert(st[0]->failed() == false);
+        assert(st[0]->is_null(0, 0));
+
+        // the errors are reported when the execution is complete
+        {
+            postgresql_async_statement div(sql[1], "select 1 / $1::int");
+            div.set_param(1, "0");
+            div.execute();
+            wait_for(div);
+            assert(div.failed());
+            assert(div.get_sqlstate() == "22012");
+
+            div.set_param(1, "1");
+            div.execute();
+            wait_for(div);
+            assert(div.failed() == false);
+            assert(div.get_value(0, 0) == "1");
+        }
+
+        {
+            postgresql_async_statement bad(sql[2], "select * from no_such_table");
+            bad.execute();
+            wait_for(bad);
+            assert(bad.failed());
+        }
+
+        // cancelling and waiting for the completion before the destruction
+        {
+            postgresql_async_statement slow(sql[2], "select pg_sleep(60)");
+            slow.execute();
+            slow.cancel();
+            wait_for(slow);
+            assert(slow.failed());
+            assert(slow.get_sqlstate() == "57014");
+        }
+
+        // the statements being executed are cancelled by the destructor
+        st[3]->execute();
+        delete st[3];
+
+        for (int i = 0; i != count - 1; ++i)
+        {
+            delete st[i];
+        }
+
+        // the sessions can be used in the usual way again
+        for (int i = 0; i != count; ++i)
+        {
+            int val = 0;
+            sql[i] << "select 5", into(val);
+            assert(val == 5);
+        }
+
+        int prepared = -1;
+        sql[0] << "select count(*) from pg_prepared_statements", into(prepared);
+        assert(prepared == 0);
+    }
+
+    std::cout << "test async statements passed" << std::endl;
+}
+
+#endif // _WIN32
+
 //
 // Support for soci Common Tests
 //
@@ -834,6 +1615,14 @@ int main(int argc, char** argv)
         test_json();
         test_statement_prepare_failure();
         test_orm_cast();
+        test_binary_results();
+        test_binary_params();
+        test_copy();
+        test_streaming();
+        test_shared_prepared_statements();
+#ifndef _WIN32
+        test_async_statements();
+#endif
 
         std::cout << "\nOK, all tests passed.\n\n";
 
@@ -68,6 +68,9 @@ void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * i
 
         int const endRow = statement_.currentRow_ + statement_.rowsToConsume_;
 
+        bool const binary = PQfformat(statement_.result_, pos) != 0;
+        unsigned long const typeOid = PQftype(statement_.result_, pos);
+
         for (int curRow = statement_.currentRow_, i = 0;
              curRow != endRow; ++curRow, ++i)
         {
@@ -93,45 +96,67 @@ void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * i
                 }
             }
 
-            // buffer with data retrieved from server, in text format
+            // buffer with data retrieved from server, in text or binary format
             char * buf = PQgetvalue(statement_.result_, curRow, pos);
+            int const len = binary
+                ? PQgetlength(statement_.result_, curRow, pos) : 0;
 
             switch (type_)
             {
             case x_char:
-                set_invector_(data_, i, *buf);
+                set_invector_(data_, i,
+                    binary ? binary_to_char(typeOid, buf, len) : *buf);
                 break;
             case x_stdstring:
-                set_invector_<std::string>(data_, i, buf);
+                if (binary)
+                {
+                    std::vector<std::string> & v =
+                        *static_cast<std::vector<std::string> *>(data_);
+                    binary_to_string(typeOid, buf, len, v[i]);
+                }
+                else
+                {
+                    set_invector_<std::string>(data_, i, buf);
+                }
                 break;
             case x_short:
                 {
-                    short const val = string_to_integer<short>(buf);
+                    short const val = binary
+                        ? binary_to_integer<short>(typeOid, buf, len)
+                        : string_to_integer<short>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_integer:
                 {
-                    int const val = string_to_integer<int>(buf);
+                    int const val = binary
+                        ? binary_to_integer<int>(typeOid, buf, len)
+                        : string_to_integer<int>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_long_long:
                 {
-                    long long const val = string_to_integer<long long>(buf);
+                    long long const val = binary
+                        ? binary_to_integer<long long>(typeOid, buf, len)
+                        : string_to_integer<long long>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_unsigned_long_long:
                 {
-                    unsigned long long const val =
-                        string_to_unsigned_integer<unsigned long long>(buf);
+                    unsigned long long const val = binary
+                        ? binary_to_unsigned_integer<unsigned long long>(
+                            typeOid, buf, len)
+                        : string_to_unsigned_integer<unsigned long long>(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
             case x_double:
                 {
-                    double const val = string_to_double(buf);
+                    double const val = binary
+                        ? binary_to_double(typeOid, buf, len)
+                        : string_to_double(buf);
                     set_invector_(data_, i, val);
                 }
                 break;
@@ -139,7 +164,14 @@ void postgresql_vector_into_type_backend::post_fetch(bool gotData, indicator * i
                 {
                     // attempt to parse the string and convert to std::tm
                     std::tm t;
-                    parse_std_tm(buf, t);
+                    if (binary)
+                    {
+                        binary_to_std_tm(typeOid, buf, len, t);
+                    }
+                    else
+                    {
+                        parse_std_tm(buf, t);
+                    }
 
                     set_invector_(data_, i, t);
                 }
@@ -49,139 +49,103 @@ void postgresql_vector_use_type_backend::bind_by_name(
     name_ = name;
 }
 
+namespace // anonymous
+{
+
+template <typename T>
+char const * get_vector_data(void * p, std::size_t & elementSize)
+{
+    std::vector<T> * v = static_cast<std::vector<T> *>(p);
+    elementSize = sizeof(T);
+    return reinterpret_cast<char const *>(&(*v)[0]);
+}
+
+} // namespace anonymous
+
 void postgresql_vector_use_type_backend::pre_use(indicator const * ind)
 {
     std::size_t const vsize = size();
-    for (size_t i = 0; i != vsize; ++i)
+    if (vsize == 0)
+    {
+        throw soci_error("Vectors of size 0 are not allowed.");
+    }
+
+    bool const strings = type_ == x_stdstring;
+    buffers_.resize(vsize, strings ? 0 : use_value_size);
+
+    // all the values are formatted as text unless the server expects
+    // exactly the type of their binary representation
+    unsigned long const binaryType = use_binary_type(type_);
+    bool const binary = binaryType != 0 &&
+        statement_.use_binary_format(position_, name_, binaryType);
+    buffers_.format_ = binary ? 1 : 0;
+
+    char const * values = NULL;
+    std::size_t elementSize = 0;
+    switch (type_)
     {
-        char * buf;
+    case x_char:
+        values = get_vector_data<char>(data_, elementSize);
+        break;
+    case x_short:
+        values = get_vector_data<short>(data_, elementSize);
+        break;
+    case x_integer:
+        values = get_vector_data<int>(data_, elementSize);
+        break;
+    case x_long_long:
+        values = get_vector_data<long long>(data_, elementSize);
+        break;
+    case x_unsigned_long_long:
+        values = get_vector_data<unsigned long long>(data_, elementSize);
+        break;
+    case x_double:
+        values = get_vector_data<double>(data_, elementSize);
+        break;
+    case x_stdtm:
+        values = get_vector_data<std::tm>(data_, elementSize);
+        break;
+    default:
+        // strings are handled separately below
+        break;
+    }
 
+    for (std::size_t i = 0; i != vsize; ++i)
+    {
         // the data in vector can be either i_ok or i_null
         if (ind != NULL && ind[i] == i_null)
         {
-            buf = NULL;
+            buffers_.values_[i] = NULL;
+            buffers_.lengths_[i] = 0;
+        }
+        else if (strings)
+        {
+            // the strings are not going to change until the statement
+            // is executed, no need to copy them
+            std::vector<std::string> & v =
+                *static_cast<std::vector<std::string> *>(data_);
+
+            buffers_.values_[i] = v[i].c_str();
+            buffers_.lengths_[i] = static_cast<int>(v[i].size());
         }
         else
         {
-            // allocate and fill the buffer with text-formatted client data
-            switch (type_)
-            {
-            case x_char:
-                {
-                    std::vector<char> * pv
-                        = static_cast<std::vector<char> *>(data_);
-                    std::vector<char> & v = *pv;
-
-                    buf = new char[2];
-                    buf[0] = v[i];
-                    buf[1] = '\0';
-                }
-                break;
-            case x_stdstring:
-                {
-                    std::vector<std::string> * pv
-                        = static_cast<std::vector<std::string> *>(data_);
-                    std::vector<std::string> & v = *pv;
-
-                    buf = new char[v[i].size() + 1];
-                    std::strcpy(buf, v[i].c_str());
-                }
-                break;
-            case x_short:
-                {
-                    std::vector<short> * pv
-                        = static_cast<std::vector<short> *>(data_);
-                    std::vector<short> & v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<short>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", static_cast<int>(v[i]));
-                }
-                break;
-            case x_integer:
-                {
-                    std::vector<int> * pv
-                        = static_cast<std::vector<int> *>(data_);
-                    std::vector<int> & v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<int>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", v[i]);
-                }
-                break;
-            case x_long_long:
-                {
-                    std::vector<long long>* pv
-                        = static_cast<std::vector<long long>*>(data_);
-                    std::vector<long long>& v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<long long>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "d", v[i]);
-                }
-                break;
-            case x_unsigned_long_long:
-                {
-                    std::vector<unsigned long long>* pv
-                        = static_cast<std::vector<unsigned long long>*>(data_);
-                    std::vector<unsigned long long>& v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<unsigned long long>::digits10 + 2;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "u", v[i]);
-                }
-                break;
-            case x_double:
-                {
-                    // no need to overengineer it (KISS)...
-
-                    std::vector<double> * pv
-                        = static_cast<std::vector<double> *>(data_);
-                    std::vector<double> & v = *pv;
-
-                    std::size_t const bufSize = 100;
-                    buf = new char[bufSize];
-
-                    snprintf(buf, bufSize, "%.20g", v[i]);
-                }
-                break;
-            case x_stdtm:
-                {
-                    std::vector<std::tm> * pv
-                        = static_cast<std::vector<std::tm> *>(data_);
-                    std::vector<std::tm> & v = *pv;
-
-                    std::size_t const bufSize = 20;
-                    buf = new char[bufSize];
-
-                    snprintf(buf, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                        v[i].tm_year + 1900, v[i].tm_mon + 1, v[i].tm_mday,
-                        v[i].tm_hour, v[i].tm_min, v[i].tm_sec);
-                }
-                break;
-
-            default:
-                throw soci_error(
-                    "Use vector element used with non-supported type.");
-            }
+            char * const buf = &buffers_.data_[i * use_value_size];
+            buffers_.values_[i] = buf;
+            buffers_.lengths_[i] = format_use_value(type_,
+                values + i * elementSize, binary, buf);
         }
-
-        buffers_.push_back(buf);
     }
 
     if (position_ > 0)
     {
         // binding by position
-        statement_.useByPosBuffers_[position_] = &buffers_[0];
+        statement_.useByPosBuffers_[position_] = &buffers_;
     }
     else
     {
         // binding by name
-        statement_.useByNameBuffers_[name_] = &buffers_[0];
+        statement_.useByNameBuffers_[name_] = &buffers_;
     }
 }
 
@@ -224,9 +188,5 @@ std::size_t postgresql_vector_use_type_backend::size()
 
 void postgresql_vector_use_type_backend::clean_up()
 {
-    std::size_t const bsize = buffers_.size();
-    for (std::size_t i = 0; i != bsize; ++i)
-    {
-        delete [] buffers_[i];
-    }
+    // nothing to do here, the buffers are freed together with this object
 }
@@ -7,44 +7,62 @@
 
 #include "soci-sqlite3.h"
 #include <cstring>
+#include <sstream>
 
 using namespace soci;
+using namespace sqlite_api;
 
 sqlite3_blob_backend::sqlite3_blob_backend(sqlite3_session_backend &session)
-    : session_(session), buf_(0), len_(0)
+    : session_(session), blob_(0)
 {
 }
 
 sqlite3_blob_backend::~sqlite3_blob_backend()
 {
-    if (buf_)
-    {
-        delete [] buf_;
-        buf_ = 0;
-        len_ = 0;
-    }
+    close();
 }
 
 std::size_t sqlite3_blob_backend::get_len()
 {
-    return len_;
+    if (blob_)
+    {
+        return static_cast<std::size_t>(sqlite3_blob_bytes(blob_));
+    }
+
+    return buf_.size();
 }
 
 std::size_t sqlite3_blob_backend::read(
     std::size_t offset, char * buf, std::size_t toRead)
 {
-    size_t r = toRead;
+    std::size_t const len = get_len();
 
     // make sure that we don't try to read
     // past the end of the data
-    if (r > len_ - offset)
+    if (offset >= len)
+    {
+        return 0;
+    }
+    if (toRead > len - offset)
     {
-        r = len_ - offset;
+        toRead = len - offset;
     }
 
-    memcpy(buf, buf_ + offset, r);
+    if (blob_)
+    {
+        int const res = sqlite3_blob_read(blob_, buf,
+            static_cast<int>(toRead), static_cast<int>(offset));
+        if (res != SQLITE_OK)
+        {
+            throw soci_error("Cannot read from BLOB.");
+        }
+    }
+    else
+    {
+        std::memcpy(buf, &buf_[offset], toRead);
+    }
 
-    return r;
+    return toRead;
 }
 
 
@@ -52,64 +70,125 @@ std::size_t sqlite3_blob_backend::write(
     std::size_t offset, char const * buf,
     std::size_t toWrite)
 {
-    const char* oldBuf = buf_;
-    std::size_t oldLen = len_;
-    len_ = (std::max)(len_, offset + toWrite);
-
-    buf_ = new char[len_];
+    if (blob_)
+    {
+        if (offset + toWrite > get_len())
+        {
+            throw soci_error("Cannot enlarge BLOB opened for incremental I/O.");
+        }
+
+        int const res = sqlite3_blob_write(blob_, buf,
+            static_cast<int>(toWrite), static_cast<int>(offset));
+        if (res != SQLITE_OK)
+        {
+            throw soci_error("Cannot write to BLOB.");
+        }
+
+        return get_len();
+    }
 
-    if (oldBuf)
+    // the buffer grows geometrically, so that writing the blob in chunks
+    // doesn't copy the whole data every time
+    if (offset + toWrite > buf_.size())
+    {
+        buf_.resize(offset + toWrite);
+    }
+    if (toWrite != 0)
     {
-        // we need to copy both old and new buffers
-        // it is possible that the new does not
-        // completely cover the old
-        memcpy(buf_, oldBuf, oldLen);
-        delete [] oldBuf;
+        std::memcpy(&buf_[offset], buf, toWrite);
     }
-    memcpy(buf_ + offset, buf, toWrite);
 
-    return len_;
+    return buf_.size();
 }
 
 
 std::size_t sqlite3_blob_backend::append(
     char const * buf, std::size_t toWrite)
 {
-    const char* oldBuf = buf_;
-
-    buf_ = new char[len_ + toWrite];
+    if (blob_)
+    {
+        throw soci_error("Cannot enlarge BLOB opened for incremental I/O.");
+    }
 
-    memcpy(buf_, oldBuf, len_);
+    buf_.insert(buf_.end(), buf, buf + toWrite);
 
-    memcpy(buf_ + len_, buf, toWrite);
+    return buf_.size();
+}
 
-    delete [] oldBuf;
 
-    len_ += toWrite;
+void sqlite3_blob_backend::trim(std::size_t newLen)
+{
+    if (blob_)
+    {
+        if (newLen != get_len())
+        {
+            throw soci_error("Cannot trim BLOB opened for incremental I/O.");
+        }
+        return;
+    }
 
-    return len_;
+    if (newLen < buf_.size())
+    {
+        buf_.resize(newLen);
+    }
 }
 
+std::size_t sqlite3_blob_backend::set_data(char const *buf, std::size_t toWrite)
+{
+    close();
 
-void sqlite3_blob_backend::trim(std::size_t newLen)
+    buf_.assign(buf, buf + toWrite);
+
+    return buf_.size();
+}
+
+void sqlite3_blob_backend::open(std::string const &table,
+    std::string const &column, long long rowId, bool readOnly,
+    std::string const &database)
 {
-    const char* oldBuf = buf_;
-    len_ = newLen;
+    close();
+
+    int const res = sqlite3_blob_open(session_.conn_, database.c_str(),
+        table.c_str(), column.c_str(), rowId, readOnly ? 0 : 1, &blob_);
+    if (res != SQLITE_OK)
+    {
+        // the handle is set to NULL on errors
+        std::ostringstream ss;
+        ss << "Cannot open BLOB. " << sqlite3_errmsg(session_.conn_);
+        throw soci_error(ss.str());
+    }
 
-    buf_ = new char[len_];
+    // the data of the blob is in the database now
+    std::vector<char>().swap(buf_);
+}
 
-    memcpy(buf_, oldBuf, len_);
+void sqlite3_blob_backend::reopen(long long rowId)
+{
+    if (blob_ == 0)
+    {
+        throw soci_error("BLOB is not opened for incremental I/O.");
+    }
 
-    delete [] oldBuf;
+    int const res = sqlite3_blob_reopen(blob_, rowId);
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << "Cannot reopen BLOB. " << sqlite3_errmsg(session_.conn_);
+        throw soci_error(ss.str());
+    }
 }
 
-std::size_t sqlite3_blob_backend::set_data(char const *buf, std::size_t toWrite)
+void sqlite3_blob_backend::close()
 {
-    if (buf_)
+    if (blob_)
     {
-        delete [] buf_;
-        buf_ = 0;
-        len_ = 0;
+        sqlite3_blob_close(blob_);
+        blob_ = 0;
     }
-    return write(0, buf, toWrite);
+}
+
+char const * sqlite3_blob_backend::get_buffer() const
+{
+    // an empty blob is still not a null value
+    return buf_.empty() ? "" : &buf_[0];
 }
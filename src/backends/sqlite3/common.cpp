@@ -9,8 +9,16 @@
 #include "common.h"
 #include "soci-backend.h"
 // std
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#ifdef _MSC_VER
+#define snprintf _snprintf // TODO: use soci-platform.h
+#endif
 
 
 namespace // anonymous
@@ -65,3 +73,96 @@ void soci::details::sqlite3::parse_std_tm(char const *buf, std::tm &t)
     std::mktime(&t);
 }
 
+void soci::details::sqlite3::execute_hardcoded(sqlite_api::sqlite3 *conn,
+    char const *query, char const *errMsg)
+{
+    char *zErrMsg = 0;
+    int const res = sqlite_api::sqlite3_exec(conn, query, 0, 0, &zErrMsg);
+    if (res != SQLITE_OK)
+    {
+        std::ostringstream ss;
+        ss << errMsg << " " << zErrMsg;
+        sqlite_api::sqlite3_free(zErrMsg);
+        throw soci_error(ss.str());
+    }
+}
+
+void soci::details::sqlite3::set_use_value(sqlite3_column &col,
+    exchange_type type, void *data)
+{
+    col.isNull_ = false;
+    col.blobBuf_ = 0;
+    col.blobSize_ = 0;
+
+    switch (type)
+    {
+    case x_char:
+        {
+            // the text is bound directly from the user's variable
+            char *c = static_cast<char *>(data);
+            col.type_ = SQLITE_TEXT;
+            col.blobBuf_ = c;
+            col.blobSize_ = *c != '\0' ? 1 : 0;
+        }
+        break;
+    case x_stdstring:
+        {
+            std::string *s = static_cast<std::string *>(data);
+            col.type_ = SQLITE_TEXT;
+            col.blobBuf_ = const_cast<char *>(s->data());
+            col.blobSize_ = s->size();
+        }
+        break;
+    case x_short:
+        col.type_ = SQLITE_INTEGER;
+        col.int64_ = *static_cast<short *>(data);
+        break;
+    case x_integer:
+        col.type_ = SQLITE_INTEGER;
+        col.int64_ = *static_cast<int *>(data);
+        break;
+    case x_long_long:
+        col.type_ = SQLITE_INTEGER;
+        col.int64_ = *static_cast<long long *>(data);
+        break;
+    case x_unsigned_long_long:
+        {
+            unsigned long long const v
+                = *static_cast<unsigned long long *>(data);
+            if (v <= static_cast<unsigned long long>(
+                    (std::numeric_limits<long long>::max)()))
+            {
+                col.type_ = SQLITE_INTEGER;
+                col.int64_ = static_cast<long long>(v);
+            }
+            else
+            {
+                // SQLite integers can't hold such values
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%" LL_FMT_FLAGS "u", v);
+                col.type_ = SQLITE_TEXT;
+                col.data_ = buf;
+            }
+        }
+        break;
+    case x_double:
+        col.type_ = SQLITE_FLOAT;
+        col.double_ = *static_cast<double *>(data);
+        break;
+    case x_stdtm:
+        {
+            // SQLite has no date type, the dates are stored as text
+            char buf[20];
+            std::tm *t = static_cast<std::tm *>(data);
+            snprintf(buf, sizeof(buf), "%d-%02d-%02d %02d:%02d:%02d",
+                t->tm_year + 1900, t->tm_mon + 1, t->tm_mday,
+                t->tm_hour, t->tm_min, t->tm_sec);
+            col.type_ = SQLITE_TEXT;
+            col.data_ = buf;
+        }
+        break;
+    default:
+        throw soci_error("Use element used with non-supported type.");
+    }
+}
+
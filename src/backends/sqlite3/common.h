@@ -8,6 +8,7 @@
 #ifndef SOCI_SQLITE3_COMMON_H_INCLUDED
 #define SOCI_SQLITE3_COMMON_H_INCLUDED
 
+#include "soci-sqlite3.h"
 #include <error.h>
 #include <cstddef>
 #include <cstdio>
@@ -21,6 +22,14 @@ namespace soci { namespace details { namespace sqlite3 {
 // helper function for parsing datetime values
 void parse_std_tm(char const *buf, std::tm &t);
 
+// helper function for hardcoded queries
+void execute_hardcoded(sqlite_api::sqlite3 *conn, char const *query,
+    char const *errMsg);
+
+// helper function setting the parameter value of a use element, which is
+// bound in its native type
+void set_use_value(sqlite3_column &col, exchange_type type, void *data);
+
 // helper for vector operations
 template <typename T>
 std::size_t get_vector_size(void *p)
@@ -36,6 +45,21 @@ void resize_vector(void *p, std::size_t sz)
     v->resize(sz);
 }
 
+// helper function for narrowing integers
+template <typename T>
+T integer_cast(long long t)
+{
+    const T max = (std::numeric_limits<T>::max)();
+    const T min = (std::numeric_limits<T>::min)();
+    if (t <= static_cast<long long>(max) &&
+        t >= static_cast<long long>(min))
+    {
+        return static_cast<T>(t);
+    }
+
+    throw soci_error("Cannot convert data.");
+}
+
 // helper function for parsing integers
 template <typename T>
 T string_to_integer(char const * buf)
@@ -48,13 +72,7 @@ T string_to_integer(char const * buf)
         // successfully converted to long long
         // and no other characters were found in the buffer
 
-        const T max = (std::numeric_limits<T>::max)();
-        const T min = (std::numeric_limits<T>::min)();
-        if (t <= static_cast<long long>(max) &&
-            t >= static_cast<long long>(min))
-        {
-            return static_cast<T>(t);
-        }
+        return integer_cast<T>(t);
     }
 
     throw soci_error("Cannot convert data.");
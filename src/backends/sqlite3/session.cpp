@@ -7,6 +7,8 @@
 
 
 #include "soci-sqlite3.h"
+#include <soci-platform.h>
+#include "common.h"
 
 #include <connection-parameters.h>
 
@@ -19,33 +21,30 @@
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::sqlite3;
 using namespace sqlite_api;
 
 namespace // anonymous
 {
 
-// helper function for hardcoded queries
-void execude_hardcoded(sqlite_api::sqlite3* conn, char const* const query, char const* const errMsg)
+void check_sqlite_err(sqlite_api::sqlite3* conn, int res, char const* const errMsg)
 {
-    char *zErrMsg = 0;
-    int const res = sqlite3_exec(conn, query, 0, 0, &zErrMsg);
-    if (res != SQLITE_OK)
+    if (SQLITE_OK != res)
     {
+        const char *zErrMsg = sqlite3_errmsg(conn);
         std::ostringstream ss;
-        ss << errMsg << " " << zErrMsg;
-        sqlite3_free(zErrMsg);
+        ss << errMsg << zErrMsg;
         throw soci_error(ss.str());
     }
 }
 
-void check_sqlite_err(sqlite_api::sqlite3* conn, int res, char const* const errMsg)
+void set_pragma(sqlite_api::sqlite3* conn, char const* const name, std::string const& value)
 {
-    if (SQLITE_OK != res)
+    if (!value.empty())
     {
-        const char *zErrMsg = sqlite3_errmsg(conn);
-        std::ostringstream ss;
-        ss << errMsg << zErrMsg;
-        throw soci_error(ss.str());
+        std::string const query("pragma " + std::string(name) + "=" + value);
+        std::string const errMsg("Query failed: " + query);
+        execute_hardcoded(conn, query.c_str(), errMsg.c_str());
     }
 }
 
@@ -54,10 +53,13 @@ void check_sqlite_err(sqlite_api::sqlite3* conn, int res, char const* const errM
 
 sqlite3_session_backend::sqlite3_session_backend(
     connection_parameters const & parameters)
+    : bulkTransaction_(false)
 {
     int timeout = 0;
+    int busyTimeout = -1;
     int connection_flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE;
-    std::string synchronous;
+    std::string synchronous, journalMode, lockingMode, tempStore;
+    std::string pageSize, cacheSize, mmapSize;
     std::string const & connectString = parameters.get_connect_string();
     std::string dbname(connectString);
     std::stringstream ssconn(connectString);
@@ -95,28 +97,98 @@ sqlite3_session_backend::sqlite3_session_backend(
             std::istringstream converter(val);
             converter >> timeout;
         }
+        else if ("busy_timeout" == key)
+        {
+            std::istringstream converter(val);
+            converter >> busyTimeout;
+        }
         else if ("synchronous" == key)
         {
             synchronous = val;
         }
+        else if ("journal_mode" == key)
+        {
+            journalMode = val;
+        }
+        else if ("locking_mode" == key)
+        {
+            lockingMode = val;
+        }
+        else if ("temp_store" == key)
+        {
+            tempStore = val;
+        }
+        else if ("page_size" == key)
+        {
+            pageSize = val;
+        }
+        else if ("cache_size" == key)
+        {
+            cacheSize = val;
+        }
+        else if ("mmap_size" == key)
+        {
+            mmapSize = val;
+        }
         else if ("shared_cache" == key && "true" == val)
         {
             connection_flags |=  SQLITE_OPEN_SHAREDCACHE;
         }
+        else if ("readonly" == key && "true" == val)
+        {
+            connection_flags &= ~(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+            connection_flags |= SQLITE_OPEN_READONLY;
+        }
+        else if ("uri" == key && "true" == val)
+        {
+            connection_flags |= SQLITE_OPEN_URI;
+        }
+        else if ("nomutex" == key && "true" == val)
+        {
+            connection_flags |= SQLITE_OPEN_NOMUTEX;
+        }
+        else if ("fullmutex" == key && "true" == val)
+        {
+            connection_flags |= SQLITE_OPEN_FULLMUTEX;
+        }
+        else if ("bulk_transaction" == key)
+        {
+            bulkTransaction_ = "true" == val;
+        }
     }
 
     int res = sqlite3_open_v2(dbname.c_str(), &conn_, connection_flags, NULL);
-    check_sqlite_err(conn_, res, "Cannot establish connection to the database. ");
 
-    if (!synchronous.empty())
+    // the connection is closed if it can't be set up as requested, even
+    // the one which failed to open must be released
+    try
     {
-        std::string const query("pragma synchronous=" + synchronous);
-        std::string const errMsg("Query failed: " + query);
-        execude_hardcoded(conn_, query.c_str(), errMsg.c_str());
-    }
+        check_sqlite_err(conn_, res, "Cannot establish connection to the database. ");
 
-    res = sqlite3_busy_timeout(conn_, timeout * 1000);
-    check_sqlite_err(conn_, res, "Failed to set busy timeout for connection. ");
+        // the busy timeout is set first, as setting the journal mode may need
+        // to wait for the database lock
+        if (busyTimeout < 0)
+        {
+            busyTimeout = timeout * 1000;
+        }
+        res = sqlite3_busy_timeout(conn_, busyTimeout);
+        check_sqlite_err(conn_, res, "Failed to set busy timeout for connection. ");
+
+        // the page size can only be changed before the database is created and
+        // it can't be changed at all once it is in WAL mode
+        set_pragma(conn_, "page_size", pageSize);
+        set_pragma(conn_, "locking_mode", lockingMode);
+        set_pragma(conn_, "journal_mode", journalMode);
+        set_pragma(conn_, "synchronous", synchronous);
+        set_pragma(conn_, "cache_size", cacheSize);
+        set_pragma(conn_, "mmap_size", mmapSize);
+        set_pragma(conn_, "temp_store", tempStore);
+    }
+    catch (...)
+    {
+        sqlite3_close(conn_);
+        throw;
+    }
 
 }
 
@@ -127,17 +199,17 @@ sqlite3_session_backend::~sqlite3_session_backend()
 
 void sqlite3_session_backend::begin()
 {
-    execude_hardcoded(conn_, "BEGIN", "Cannot begin transaction.");
+    execute_hardcoded(conn_, "BEGIN", "Cannot begin transaction.");
 }
 
 void sqlite3_session_backend::commit()
 {
-    execude_hardcoded(conn_, "COMMIT", "Cannot commit transaction.");
+    execute_hardcoded(conn_, "COMMIT", "Cannot commit transaction.");
 }
 
 void sqlite3_session_backend::rollback()
 {
-    execude_hardcoded(conn_, "ROLLBACK", "Cannot rollback transaction.");
+    execute_hardcoded(conn_, "ROLLBACK", "Cannot rollback transaction.");
 }
 
 void sqlite3_session_backend::clean_up()
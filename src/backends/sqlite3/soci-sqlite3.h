@@ -48,6 +48,8 @@ typedef void (*sqlite3_destructor_type)(void*);
 
 #undef SQLITE_STATIC
 #define SQLITE_STATIC ((sqlite_api::sqlite3_destructor_type)0)
+#undef SQLITE_TRANSIENT
+#define SQLITE_TRANSIENT ((sqlite_api::sqlite3_destructor_type)-1)
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -152,8 +154,17 @@ struct sqlite3_column
 {
     std::string data_;
     bool isNull_;
+
+    // Not owned buffer bound to a parameter, this is used for the blobs and
+    // for the text of the use elements, which is not copied into data_.
     char * blobBuf_;
     std::size_t blobSize_;
+
+    // The values are kept with their SQLite storage class (SQLITE_INTEGER,
+    // SQLITE_FLOAT, ...), only the text and blob values are kept in data_.
+    int type_;
+    long long int64_;
+    double double_;
 };
 
 typedef std::vector<sqlite3_column> sqlite3_row;
@@ -187,6 +198,8 @@ struct sqlite3_statement_backend : details::statement_backend
     virtual sqlite3_vector_into_type_backend * make_vector_into_type_backend();
     virtual sqlite3_vector_use_type_backend * make_vector_use_type_backend();
 
+    virtual bool reset_for_reuse();
+
     sqlite3_session_backend &session_;
     sqlite_api::sqlite3_stmt *stmt_;
     sqlite3_recordset dataCache_;
@@ -197,10 +210,28 @@ struct sqlite3_statement_backend : details::statement_backend
 
     long long rowsAffectedBulk_; // number of rows affected by the last bulk operation
 
+    // When enabled, the bulk operations are executed inside a single
+    // transaction (or a savepoint if a transaction is already active)
+    // instead of having each row committed on its own. The default comes
+    // from the "bulk_transaction" option of the session and is restored
+    // when the statement is reused.
+    void set_bulk_transaction(bool enable);
+
+    // types of the columns, found by the first describe of the statement
+    std::vector<data_type> columnTypes_;
+
 private:
+    bool bulkTransaction_;
+
+    // commit the transaction of a bulk operation or release its savepoint,
+    // rolling it back if this fails
+    void end_bulk_transaction(bool savepoint);
+
+    void describe_columns(int colCount);
     exec_fetch_result load_rowset(int totalRows);
     exec_fetch_result load_one();
     exec_fetch_result bind_and_execute(int number);
+    exec_fetch_result bind_and_execute_rows(int number);
 };
 
 struct sqlite3_rowid_backend : details::rowid_backend
@@ -230,9 +261,24 @@ struct sqlite3_blob_backend : details::blob_backend
 
     std::size_t set_data(char const *buf, std::size_t toWrite);
 
+    // The data of the blob is kept in memory, unless the blob is opened for
+    // the incremental I/O, in which case it is read and written directly in
+    // the database. The size of the blob can't be changed in this mode, the
+    // row must be created with the final size, e.g. using zeroblob(n).
+    void open(std::string const &table, std::string const &column,
+        long long rowId, bool readOnly = false,
+        std::string const &database = "main");
+    void reopen(long long rowId);
+    void close();
+    bool is_open() const { return blob_ != 0; }
+
+    // the data kept in memory, used for binding it without a copy
+    char const * get_buffer() const;
+
+    sqlite_api::sqlite3_blob *blob_;
+
 private:
-    char *buf_;
-    size_t len_;
+    std::vector<char> buf_;
 };
 
 struct sqlite3_session_backend : details::session_backend
@@ -254,6 +300,9 @@ struct sqlite3_session_backend : details::session_backend
     virtual sqlite3_blob_backend * make_blob_backend();
 
     sqlite_api::sqlite3 *conn_;
+
+    // default for the statements, set with the "bulk_transaction" option
+    bool bulkTransaction_;
 };
 
 struct sqlite3_backend_factory : backend_factory
@@ -68,66 +68,78 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
             }
         }
 
-        const char *buf = reinterpret_cast<const char*>(
-            sqlite3_column_text(statement_.stmt_,pos));
-
-        if (buf == NULL)
-        {
-            buf = "";
-        }
-
+        // the values are read in the type matching the exchange type, only
+        // the values which need parsing are read as text
         switch (type_)
         {
         case x_char:
             {
+                char const *buf = reinterpret_cast<char const*>(
+                    sqlite3_column_text(statement_.stmt_, pos));
                 char *dest = static_cast<char*>(data_);
-                *dest = *buf;
+                *dest = buf != NULL ? *buf : '\0';
             }
             break;
         case x_stdstring:
             {
+                char const *buf = reinterpret_cast<char const*>(
+                    sqlite3_column_text(statement_.stmt_, pos));
                 std::string *dest = static_cast<std::string *>(data_);
-                dest->assign(buf);
+                dest->assign(buf != NULL ? buf : "",
+                    sqlite3_column_bytes(statement_.stmt_, pos));
             }
             break;
         case x_short:
             {
                 short *dest = static_cast<short*>(data_);
-                long val = std::strtol(buf, NULL, 10);
-                *dest = static_cast<short>(val);
+                *dest = static_cast<short>(
+                    sqlite3_column_int64(statement_.stmt_, pos));
             }
             break;
         case x_integer:
             {
                 int *dest = static_cast<int*>(data_);
-                long val = std::strtol(buf, NULL, 10);
-                *dest = static_cast<int>(val);
+                *dest = static_cast<int>(
+                    sqlite3_column_int64(statement_.stmt_, pos));
             }
             break;
         case x_long_long:
             {
                 long long* dest = static_cast<long long*>(data_);
-                *dest = std::strtoll(buf, NULL, 10);
+                *dest = sqlite3_column_int64(statement_.stmt_, pos);
             }
             break;
         case x_unsigned_long_long:
             {
                 unsigned long long* dest = static_cast<unsigned long long*>(data_);
-                *dest = string_to_unsigned_integer<unsigned long long>(buf);
+                if (sqlite3_column_type(statement_.stmt_, pos) == SQLITE_INTEGER)
+                {
+                    *dest = static_cast<unsigned long long>(
+                        sqlite3_column_int64(statement_.stmt_, pos));
+                }
+                else
+                {
+                    // the values above the range of long long are stored
+                    // as text
+                    *dest = string_to_unsigned_integer<unsigned long long>(
+                        reinterpret_cast<char const*>(
+                            sqlite3_column_text(statement_.stmt_, pos)));
+                }
             }
             break;
         case x_double:
             {
                 double *dest = static_cast<double*>(data_);
-                double val = strtod(buf, NULL);
-                *dest = static_cast<double>(val);
+                *dest = sqlite3_column_double(statement_.stmt_, pos);
             }
             break;
         case x_stdtm:
             {
                 // attempt to parse the string and convert to std::tm
+                char const *buf = reinterpret_cast<char const*>(
+                    sqlite3_column_text(statement_.stmt_, pos));
                 std::tm *dest = static_cast<std::tm *>(data_);
-                parse_std_tm(buf, *dest);
+                parse_std_tm(buf != NULL ? buf : "", *dest);
             }
             break;
         case x_rowid:
@@ -136,7 +148,7 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
 
                 rowid *rid = static_cast<rowid *>(data_);
                 sqlite3_rowid_backend *rbe = static_cast<sqlite3_rowid_backend *>(rid->get_backend());
-                long long val = std::strtoll(buf, NULL, 10);
+                long long val = sqlite3_column_int64(statement_.stmt_, pos);
                 rbe->value_ = static_cast<unsigned long>(val);
             }
             break;
@@ -146,7 +158,7 @@ void sqlite3_standard_into_type_backend::post_fetch(bool gotData,
                 sqlite3_blob_backend *bbe =
                     static_cast<sqlite3_blob_backend *>(b->get_backend());
 
-                buf = reinterpret_cast<const char*>(sqlite3_column_blob(
+                char const *buf = reinterpret_cast<const char*>(sqlite3_column_blob(
                     statement_.stmt_,
                     pos));
 
@@ -9,22 +9,18 @@
 #include <soci-platform.h>
 #include "rowid.h"
 #include "blob.h"
+#include "common.h"
 // std
-#include <cstdio>
-#include <cstdlib>
-#include <cstring>
-#include <ctime>
-#include <limits>
 #include <sstream>
 #include <string>
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355 4996)
-#define snprintf _snprintf // TODO: use soci-platform.h
 #endif
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::sqlite3;
 
 void sqlite3_standard_use_type_backend::bind_by_pos(int& position, void* data,
     exchange_type type, bool /*readOnly*/)
@@ -77,90 +73,20 @@ void sqlite3_standard_use_type_backend::pre_use(indicator const * ind)
         statement_.useData_[0].resize(position_);
     }
 
+    sqlite3_column &col = statement_.useData_[0][pos];
+
     if (ind != NULL && *ind == i_null)
     {
-        statement_.useData_[0][pos].isNull_ = true;
-        statement_.useData_[0][pos].data_ = "";
-        statement_.useData_[0][pos].blobBuf_ = 0;
-        statement_.useData_[0][pos].blobSize_ = 0;
+        col.type_ = SQLITE_NULL;
+        col.isNull_ = true;
+        col.data_ = "";
+        col.blobBuf_ = 0;
+        col.blobSize_ = 0;
     }
     else
     {
-        // allocate and fill the buffer with text-formatted client data
         switch (type_)
         {
-        case x_char:
-            {
-                buf_ = new char[2];
-                buf_[0] = *static_cast<char*>(data_);
-                buf_[1] = '\0';
-            }
-            break;
-        case x_stdstring:
-            {
-                std::string *s = static_cast<std::string *>(data_);
-                buf_ = new char[s->size() + 1];
-                std::strcpy(buf_, s->c_str());
-            }
-            break;
-        case x_short:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<short>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    static_cast<int>(*static_cast<short*>(data_)));
-            }
-            break;
-        case x_integer:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<int>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%d",
-                    *static_cast<int*>(data_));
-            }
-            break;
-        case x_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<long long>::digits10 + 3;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "d",
-                    *static_cast<long long *>(data_));
-            }
-            break;
-        case x_unsigned_long_long:
-            {
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long long>::digits10 + 2;
-                buf_ = new char[bufSize];
-                snprintf(buf_, bufSize, "%" LL_FMT_FLAGS "u",
-                    *static_cast<unsigned long long *>(data_));
-            }
-            break;
-        case x_double:
-            {
-                // no need to overengineer it (KISS)...
-
-                std::size_t const bufSize = 100;
-                buf_ = new char[bufSize];
-
-                snprintf(buf_, bufSize, "%.20g",
-                    *static_cast<double*>(data_));
-            }
-            break;
-        case x_stdtm:
-            {
-                std::size_t const bufSize = 20;
-                buf_ = new char[bufSize];
-
-                std::tm *t = static_cast<std::tm *>(data_);
-                snprintf(buf_, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                    t->tm_year + 1900, t->tm_mon + 1, t->tm_mday,
-                    t->tm_hour, t->tm_min, t->tm_sec);
-            }
-            break;
         case x_rowid:
             {
                 // RowID is internally identical to unsigned long
@@ -169,11 +95,11 @@ void sqlite3_standard_use_type_backend::pre_use(indicator const * ind)
                 sqlite3_rowid_backend *rbe = 
 static_cast<sqlite3_rowid_backend *>(rid->get_backend());
 
-                std::size_t const bufSize
-                    = std::numeric_limits<unsigned long>::digits10 + 2;
-                buf_ = new char[bufSize];
-
-                snprintf(buf_, bufSize, "%lu", rbe->value_);
+                col.type_ = SQLITE_INTEGER;
+                col.int64_ = static_cast<long long>(rbe->value_);
+                col.isNull_ = false;
+                col.blobBuf_ = 0;
+                col.blobSize_ = 0;
             }
             break;
         case x_blob:
@@ -183,22 +109,27 @@ static_cast<sqlite3_rowid_backend *>(rid->get_backend());
                     static_cast<sqlite3_blob_backend *>(b->get_backend());
 
                 std::size_t len = bbe->get_len();
-                buf_ = new char[len];
-                bbe->read(0, buf_, len);
-                statement_.useData_[0][pos].blobBuf_ = buf_;
-                statement_.useData_[0][pos].blobSize_ = len;
+                if (bbe->is_open())
+                {
+                    buf_ = new char[len];
+                    bbe->read(0, buf_, len);
+                    col.blobBuf_ = buf_;
+                }
+                else
+                {
+                    // the data kept in memory is bound without copying it
+                    col.blobBuf_ = const_cast<char *>(bbe->get_buffer());
+                }
+
+                col.type_ = SQLITE_BLOB;
+                col.isNull_ = false;
+                col.blobSize_ = len;
             }
             break;
         default:
-            throw soci_error("Use element used with non-supported type.");
-        }
-
-        statement_.useData_[0][pos].isNull_ = false;
-        if (type_ != x_blob)
-        {
-            statement_.useData_[0][pos].blobBuf_ = 0;
-            statement_.useData_[0][pos].blobSize_ = 0;
-            statement_.useData_[0][pos].data_ = buf_;
+            // the other values are bound directly from the user's variable
+            set_use_value(col, type_, data_);
+            break;
         }
     }
 }
@@ -5,6 +5,8 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 //
 #include "soci-sqlite3.h"
+#include <soci-platform.h>
+#include "common.h"
 // std
 #include <algorithm>
 #include <sstream>
@@ -16,8 +18,85 @@
 
 using namespace soci;
 using namespace soci::details;
+using namespace soci::details::sqlite3;
 using namespace sqlite_api;
 
+namespace // anonymous
+{
+
+// This is a hack, but the sqlite3 type system does not
+// have a date or time field.  Also it does not reliably
+// id other data types.  It has a tendency to see everything
+// as text.  sqlite3_column_decltype returns the text that is
+// used in the create table statement
+bool decl_type_to_data_type(char const* declType, data_type & type)
+{
+    bool typeFound = false;
+
+    if ( declType == NULL )
+    {
+        static char const* s_char = "char";
+        declType = s_char;
+    }
+
+    std::string dt = declType;
+
+    // do all comparisons in lower case
+    std::transform(dt.begin(), dt.end(), dt.begin(), tolower);
+
+    if (dt.find("time", 0) != std::string::npos)
+    {
+        type = dt_date;
+        typeFound = true;
+    }
+    if (dt.find("date", 0) != std::string::npos)
+    {
+        type = dt_date;
+        typeFound = true;
+    }
+
+    if (dt.find("int8", 0) != std::string::npos || dt.find("bigint", 0) != std::string::npos)
+    {
+        type = dt_long_long;
+        typeFound = true;
+    }
+    else if (dt.find("unsigned big int", 0) != std::string::npos)
+    {
+        type = dt_unsigned_long_long;
+        typeFound = true;
+    }
+    else if (dt.find("int", 0) != std::string::npos)
+    {
+        type = dt_integer;
+        typeFound = true;
+    }
+
+    if (dt.find("float", 0) != std::string::npos || dt.find("double", 0) != std::string::npos)
+    {
+        type = dt_double;
+        typeFound = true;
+    }
+    if (dt.find("text", 0) != std::string::npos)
+    {
+        type = dt_string;
+        typeFound = true;
+    }
+    if (dt.find("char", 0) != std::string::npos)
+    {
+        type = dt_string;
+        typeFound = true;
+    }
+    if (dt.find("boolean", 0) != std::string::npos)
+    {
+        type = dt_integer;
+        typeFound = true;
+    }
+
+    return typeFound;
+}
+
+} // namespace anonymous
+
 sqlite3_statement_backend::sqlite3_statement_backend(
     sqlite3_session_backend &session)
     : session_(session)
@@ -28,6 +107,7 @@ sqlite3_statement_backend::sqlite3_statement_backend(
     , boundByName_(false)
     , boundByPos_(false)
     , rowsAffectedBulk_(-1LL)
+    , bulkTransaction_(session.bulkTransaction_)
 {
 }
 
@@ -39,6 +119,7 @@ void sqlite3_statement_backend::alloc()
 void sqlite3_statement_backend::clean_up()
 {
     rowsAffectedBulk_ = -1LL;
+    columnTypes_.clear();
 
     if (stmt_)
     {
@@ -126,16 +207,30 @@ sqlite3_statement_backend::load_rowset(int totalRows)
                 }
                 for (int c = 0; c < numCols; ++c)
                 {
-                    char const* buf =
-                        reinterpret_cast<char const*>(sqlite3_column_text(stmt_, c));
-                    bool isNull = false;
-                    if (0 == buf)
+                    // the values are kept in their native types, only the
+                    // text and blob values are copied into strings
+                    sqlite3_column &col = dataCache_[i][c];
+                    col.type_ = sqlite3_column_type(stmt_, c);
+                    col.isNull_ = SQLITE_NULL == col.type_;
+                    switch (col.type_)
                     {
-                        isNull = true;
-                        buf = "";
+                    case SQLITE_INTEGER:
+                        col.int64_ = sqlite3_column_int64(stmt_, c);
+                        break;
+                    case SQLITE_FLOAT:
+                        col.double_ = sqlite3_column_double(stmt_, c);
+                        break;
+                    case SQLITE_NULL:
+                        break;
+                    default:
+                        {
+                            char const* buf = reinterpret_cast<char const*>(
+                                sqlite3_column_text(stmt_, c));
+                            col.data_.assign(buf != 0 ? buf : "",
+                                sqlite3_column_bytes(stmt_, c));
+                        }
+                        break;
                     }
-                    dataCache_[i][c].data_ = buf;
-                    dataCache_[i][c].isNull_ = isNull;
                 }
             }
             else
@@ -186,14 +281,91 @@ sqlite3_statement_backend::load_one()
     return retVal;
 }
 
-// Execute statements once for every row of useData
+// Execute the bulk operation in a single transaction, if requested
 statement_backend::exec_fetch_result
 sqlite3_statement_backend::bind_and_execute(int number)
+{
+    // a single row is executed in its own implicit transaction anyhow
+    if (bulkTransaction_ == false || useData_.size() < 2)
+    {
+        return bind_and_execute_rows(number);
+    }
+
+    // a savepoint is used when a transaction was already started by the user,
+    // it is released without being committed
+    bool const savepoint = sqlite3_get_autocommit(session_.conn_) == 0;
+
+    execute_hardcoded(session_.conn_,
+        savepoint ? "SAVEPOINT soci_bulk" : "BEGIN",
+        "Cannot begin bulk operation.");
+
+    statement_backend::exec_fetch_result retVal = ef_no_data;
+    try
+    {
+        retVal = bind_and_execute_rows(number);
+    }
+    catch (...)
+    {
+        // the rows executed before the failing one are kept, as they would be
+        // without the transaction, unless SQLite has already rolled it back
+        if (sqlite3_get_autocommit(session_.conn_) == 0)
+        {
+            try
+            {
+                end_bulk_transaction(savepoint);
+            }
+            catch (soci_error const &)
+            {
+                // the original error is more relevant
+            }
+        }
+        throw;
+    }
+
+    end_bulk_transaction(savepoint);
+
+    return retVal;
+}
+
+void sqlite3_statement_backend::end_bulk_transaction(bool savepoint)
+{
+    try
+    {
+        execute_hardcoded(session_.conn_,
+            savepoint ? "RELEASE soci_bulk" : "COMMIT",
+            "Cannot complete bulk operation.");
+    }
+    catch (soci_error const &)
+    {
+        // don't leave the transaction open, e.g. if the database is busy
+        char const * const rollback = savepoint
+            ? "ROLLBACK TO soci_bulk; RELEASE soci_bulk" : "ROLLBACK";
+        sqlite3_exec(session_.conn_, rollback, 0, 0, 0);
+        rowsAffectedBulk_ = 0;
+        throw;
+    }
+}
+
+void sqlite3_statement_backend::set_bulk_transaction(bool enable)
+{
+    bulkTransaction_ = enable;
+}
+
+// Execute statements once for every row of useData
+statement_backend::exec_fetch_result
+sqlite3_statement_backend::bind_and_execute_rows(int number)
 {
     statement_backend::exec_fetch_result retVal = ef_no_data;
 
     long long rowsAffectedBulkTemp = 0;
 
+    // SQLite reads the bound text and blobs again by each sqlite3_step(),
+    // so they are only bound without copying them for the statements which
+    // don't return rows, the use elements may change while the rows of the
+    // other ones are fetched
+    sqlite_api::sqlite3_destructor_type const bindMode =
+        sqlite3_column_count(stmt_) == 0 ? SQLITE_STATIC : SQLITE_TRANSIENT;
+
     int const rows = static_cast<int>(useData_.size());
     for (int row = 0; row < rows; ++row)
     {
@@ -208,19 +380,42 @@ sqlite3_statement_backend::bind_and_execute(int number)
             {
                 bindRes = sqlite3_bind_null(stmt_, pos);
             }
-            else if (curCol.blobBuf_)
-            {
-                bindRes = sqlite3_bind_blob(stmt_, pos,
-                                            curCol.blobBuf_,
-                                            static_cast<int>(curCol.blobSize_),
-                                            SQLITE_STATIC);
-            }
             else
             {
-                bindRes = sqlite3_bind_text(stmt_, pos,
-                                            curCol.data_.c_str(),
-                                            static_cast<int>(curCol.data_.length()),
-                                            SQLITE_STATIC);
+                // the values are bound in their native types
+                switch (curCol.type_)
+                {
+                case SQLITE_INTEGER:
+                    bindRes = sqlite3_bind_int64(stmt_, pos,
+                                                 curCol.int64_);
+                    break;
+                case SQLITE_FLOAT:
+                    bindRes = sqlite3_bind_double(stmt_, pos,
+                                                  curCol.double_);
+                    break;
+                case SQLITE_BLOB:
+                    bindRes = sqlite3_bind_blob(stmt_, pos,
+                                                curCol.blobBuf_,
+                                                static_cast<int>(curCol.blobSize_),
+                                                bindMode);
+                    break;
+                default:
+                    if (curCol.blobBuf_)
+                    {
+                        bindRes = sqlite3_bind_text(stmt_, pos,
+                                                    curCol.blobBuf_,
+                                                    static_cast<int>(curCol.blobSize_),
+                                                    bindMode);
+                    }
+                    else
+                    {
+                        bindRes = sqlite3_bind_text(stmt_, pos,
+                                                    curCol.data_.c_str(),
+                                                    static_cast<int>(curCol.data_.length()),
+                                                    bindMode);
+                    }
+                    break;
+                }
             }
 
             if (SQLITE_OK != bindRes)
@@ -305,112 +500,102 @@ std::string sqlite3_statement_backend::rewrite_for_procedure_call(
 
 int sqlite3_statement_backend::prepare_for_describe()
 {
-    return sqlite3_column_count(stmt_);
+    int const colCount = sqlite3_column_count(stmt_);
+
+    // the types only depend on the prepared statement, so they are found
+    // once and reused by the later executions of the same statement
+    if (columnTypes_.size() != static_cast<std::size_t>(colCount))
+    {
+        describe_columns(colCount);
+    }
+
+    return colCount;
 }
 
 void sqlite3_statement_backend::describe_column(int colNum, data_type & type,
                                                 std::string & columnName)
 {
-    columnName = sqlite3_column_name(stmt_, colNum-1);
-
-    // This is a hack, but the sqlite3 type system does not
-    // have a date or time field.  Also it does not reliably
-    // id other data types.  It has a tendency to see everything
-    // as text.  sqlite3_column_decltype returns the text that is
-    // used in the create table statement
-    bool typeFound = false;
-
-    char const* declType = sqlite3_column_decltype(stmt_, colNum-1);
-
-    if ( declType == NULL )
+    if (columnTypes_.empty())
     {
-        static char const* s_char = "char";
-        declType = s_char;
+        prepare_for_describe();
     }
 
-    std::string dt = declType;
-
-    // do all comparisons in lower case
-    std::transform(dt.begin(), dt.end(), dt.begin(), tolower);
-
-    if (dt.find("time", 0) != std::string::npos)
-    {
-        type = dt_date;
-        typeFound = true;
-    }
-    if (dt.find("date", 0) != std::string::npos)
-    {
-        type = dt_date;
-        typeFound = true;
-    }
+    columnName = sqlite3_column_name(stmt_, colNum-1);
+    type = columnTypes_[colNum-1];
+}
 
-    if (dt.find("int8", 0) != std::string::npos || dt.find("bigint", 0) != std::string::npos)
-    {
-        type = dt_long_long;
-        typeFound = true;
-    }
-    else if (dt.find("unsigned big int", 0) != std::string::npos)
-    {
-        type = dt_unsigned_long_long;
-        typeFound = true;
-    }
-    else if (dt.find("int", 0) != std::string::npos)
-    {
-        type = dt_integer;
-        typeFound = true;
-    }
+void sqlite3_statement_backend::describe_columns(int colCount)
+{
+    columnTypes_.resize(colCount);
 
-    if (dt.find("float", 0) != std::string::npos || dt.find("double", 0) != std::string::npos)
-    {
-        type = dt_double;
-        typeFound = true;
-    }
-    if (dt.find("text", 0) != std::string::npos)
-    {
-        type = dt_string;
-        typeFound = true;
-    }
-    if (dt.find("char", 0) != std::string::npos)
-    {
-        type = dt_string;
-        typeFound = true;
-    }
-    if (dt.find("boolean", 0) != std::string::npos)
+    std::vector<int> unknownCols;
+    for (int i = 0; i != colCount; ++i)
     {
-        type = dt_integer;
-        typeFound = true;
+        if (decl_type_to_data_type(sqlite3_column_decltype(stmt_, i),
+                columnTypes_[i]) == false)
+        {
+            unknownCols.push_back(i);
+        }
     }
 
-    if (typeFound)
+    if (unknownCols.empty())
     {
         return;
     }
 
     // try to get it from the weak ass type system
 
-    // total hack - execute the statment once to get the column types
-    // then clear so it can be executed again
+    // total hack - execute the statment once to get the types of all the
+    // remaining columns then clear so it can be executed again
+    sqlite3_reset(stmt_);
     sqlite3_step(stmt_);
 
-    int const sqlite3_type = sqlite3_column_type(stmt_, colNum-1);
-    switch (sqlite3_type)
+    for (std::size_t i = 0; i != unknownCols.size(); ++i)
     {
-    case SQLITE_INTEGER:
-        type = dt_integer;
-        break;
-    case SQLITE_FLOAT:
-        type = dt_double;
-        break;
-    case SQLITE_BLOB:
-    case SQLITE_TEXT:
-        type = dt_string;
-        break;
-    default:
-        type = dt_string;
-        break;
+        data_type & type = columnTypes_[unknownCols[i]];
+
+        int const sqlite3_type = sqlite3_column_type(stmt_, unknownCols[i]);
+        switch (sqlite3_type)
+        {
+        case SQLITE_INTEGER:
+            type = dt_integer;
+            break;
+        case SQLITE_FLOAT:
+            type = dt_double;
+            break;
+        case SQLITE_BLOB:
+        case SQLITE_TEXT:
+            type = dt_string;
+            break;
+        default:
+            type = dt_string;
+            break;
+        }
     }
 
     sqlite3_reset(stmt_);
+    databaseReady_ = true;
+}
+
+bool sqlite3_statement_backend::reset_for_reuse()
+{
+    // the statement is finalized on errors and can't be reused then
+    if (stmt_ == 0)
+    {
+        return false;
+    }
+
+    sqlite3_reset(stmt_);
+    databaseReady_ = true;
+
+    dataCache_.clear();
+    useData_.clear();
+    boundByName_ = false;
+    boundByPos_ = false;
+    rowsAffectedBulk_ = -1LL;
+    bulkTransaction_ = session_.bulkTransaction_;
+
+    return true;
 }
 
 sqlite3_standard_into_type_backend *
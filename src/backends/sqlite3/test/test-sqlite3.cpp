@@ -13,8 +13,10 @@
 #include <string>
 #include <cassert>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <ctime>
+#include <limits>
 
 using namespace soci;
 using namespace soci::tests;
@@ -258,6 +260,561 @@ void test5()
     std::cout << "test 5 passed" << std::endl;
 }
 
+struct test6_table_creator : table_creator_base
+{
+    test6_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, d real, s text, "
+            "u unsigned big int, x)";
+    }
+};
+
+// typed access to the column values
+void test6()
+{
+    {
+        session sql(backEnd, connectString);
+
+        test6_table_creator tableCreator(sql);
+
+        sql << "insert into soci_test(id, d, s, u, x) "
+            "values(1, 0.1, '18446744073709551615', 9223372036854775807, 12)";
+        sql << "insert into soci_test(id, d, s, u, x) "
+            "values(2, 2.5, '123', 7, 'text')";
+        sql << "insert into soci_test(id, d, s, u, x) "
+            "values(3, 100000, 'xyz', 8, 3.5)";
+
+        // doubles keep all of their precision
+        double const third = 1.0 / 3;
+        sql << "update soci_test set d = :d where id = 1", use(third);
+
+        double d = 0.0;
+        sql << "select d from soci_test where id = 1", into(d);
+        assert(std::fabs(d - third) < std::numeric_limits<double>::epsilon() / 2);
+
+        unsigned long long u = 0;
+        sql << "select u from soci_test where id = 1", into(u);
+        assert(u == 9223372036854775807ULL);
+
+        // the values which don't fit into long long can only be kept as text
+        sql << "select s from soci_test where id = 1", into(u);
+        assert(u == 18446744073709551615ULL);
+
+        std::string str;
+        sql << "select x from soci_test where id = 1", into(str);
+        assert(str == "12");
+
+        std::vector<int> ids(10);
+        std::vector<double> ds(10);
+        std::vector<std::string> ss(10);
+        std::vector<unsigned long long> us(10);
+        std::vector<std::string> xs(10);
+        sql << "select id, d, s, u, x from soci_test order by id",
+            into(ids), into(ds), into(ss), into(us), into(xs);
+        assert(ids.size() == 3);
+        assert(ids[0] == 1 && ids[1] == 2 && ids[2] == 3);
+        assert(std::fabs(ds[0] - third) < std::numeric_limits<double>::epsilon() / 2);
+        assert(equal_approx(ds[1], 2.5));
+        assert(equal_approx(ds[2], 100000.0));
+        assert(ss[0] == "18446744073709551615");
+        assert(ss[1] == "123");
+        assert(us[0] == 9223372036854775807ULL);
+        assert(us[1] == 7);
+        assert(xs[0] == "12");
+        assert(xs[1] == "text");
+        assert(xs[2] == "3.5");
+
+        // the numbers are formatted like SQLite does it
+        std::vector<std::string> dstr(10);
+        sql << "select d from soci_test order by id", into(dstr);
+        assert(dstr.size() == 3);
+        assert(dstr[1] == "2.5");
+        assert(dstr[2] == "100000.0");
+
+        // text values are converted as before
+        std::vector<int> is(10);
+        sql << "select s from soci_test where id = 2", into(is);
+        assert(is.size() == 1);
+        assert(is[0] == 123);
+
+        try
+        {
+            std::vector<short> sh(10);
+            sql << "select u from soci_test where id = 1", into(sh);
+            assert(false);
+        }
+        catch (soci_error const &e)
+        {
+            assert(std::string(e.what()) == "Cannot convert data.");
+        }
+    }
+
+    std::cout << "test 6 passed" << std::endl;
+}
+
+struct test7_table_creator : table_creator_base
+{
+    test7_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer, v)";
+    }
+};
+
+// use elements are bound in their native types
+void test7()
+{
+    {
+        session sql(backEnd, connectString);
+
+        test7_table_creator tableCreator(sql);
+
+        int i = 123;
+        long long ll = 9223372036854775807LL;
+        unsigned long long ull = 18446744073709551615ULL;
+        double const third = 1.0 / 3;
+        std::string str("Ala\0ma", 6);
+        char c = 'x';
+        sql << "insert into soci_test(id, v) values(1, :v)", use(i);
+        sql << "insert into soci_test(id, v) values(2, :v)", use(ll);
+        sql << "insert into soci_test(id, v) values(3, :v)", use(ull);
+        sql << "insert into soci_test(id, v) values(4, :v)", use(third);
+        sql << "insert into soci_test(id, v) values(5, :v)", use(str);
+        sql << "insert into soci_test(id, v) values(6, :v)", use(c);
+
+        int const nullId = 7;
+        indicator ind = i_null;
+        sql << "insert into soci_test(id, v) values(:id, :v)",
+            use(nullId), use(i, ind);
+
+        std::vector<std::string> types(10);
+        sql << "select typeof(v) from soci_test order by id", into(types);
+        assert(types.size() == 7);
+        assert(types[0] == "integer");
+        assert(types[1] == "integer");
+        assert(types[2] == "text");
+        assert(types[3] == "real");
+        assert(types[4] == "text");
+        assert(types[5] == "text");
+        assert(types[6] == "null");
+
+        long long ll2 = 0;
+        sql << "select v from soci_test where id = 2", into(ll2);
+        assert(ll2 == ll);
+
+        unsigned long long ull2 = 0;
+        sql << "select v from soci_test where id = 3", into(ull2);
+        assert(ull2 == ull);
+
+        double d = 0.0;
+        sql << "select v from soci_test where id = 4", into(d);
+        assert(std::fabs(d - third) < std::numeric_limits<double>::epsilon() / 2);
+
+        // the strings are bound with their whole length
+        int len = 0;
+        sql << "select length(cast(v as blob)) from soci_test where id = 5",
+            into(len);
+        assert(len == 6);
+
+        std::string str2;
+        sql << "select v from soci_test where id = 6", into(str2);
+        assert(str2 == "x");
+
+        sql << "delete from soci_test";
+
+        std::vector<int> ids;
+        std::vector<double> ds;
+        std::vector<indicator> inds;
+        ids.push_back(1);
+        ds.push_back(0.5);
+        inds.push_back(i_ok);
+        ids.push_back(2);
+        ds.push_back(third);
+        inds.push_back(i_ok);
+        ids.push_back(3);
+        ds.push_back(0.0);
+        inds.push_back(i_null);
+        sql << "insert into soci_test(id, v) values(:id, :v)",
+            use(ids), use(ds, inds);
+
+        std::vector<std::string> names;
+        names.push_back("one");
+        names.push_back(std::string());
+        sql << "insert into soci_test(id, v) values(4, :v)", use(names);
+
+        sql << "select typeof(v) from soci_test order by id, v", into(types);
+        assert(types.size() == 5);
+        assert(types[0] == "real");
+        assert(types[1] == "real");
+        assert(types[2] == "null");
+        assert(types[3] == "text");
+        assert(types[4] == "text");
+
+        sql << "select v from soci_test where id = 2", into(d);
+        assert(std::fabs(d - third) < std::numeric_limits<double>::epsilon() / 2);
+
+        std::vector<std::string> names2(10);
+        sql << "select v from soci_test where id = 4 order by v",
+            into(names2);
+        assert(names2.size() == 2);
+        assert(names2[0].empty());
+        assert(names2[1] == "one");
+    }
+
+    std::cout << "test 7 passed" << std::endl;
+}
+
+struct test8_table_creator : table_creator_base
+{
+    test8_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(id integer primary key, name text)";
+    }
+};
+
+// bulk operations executed in a single transaction
+void test8()
+{
+    {
+        std::string connStr(connectString);
+        if (connStr.find('=') == std::string::npos)
+        {
+            connStr = "db=" + connStr;
+        }
+        connStr += " bulk_transaction=true";
+
+        session sql(backEnd, connStr);
+        sqlite_api::sqlite3 *conn
+            = static_cast<sqlite3_session_backend *>(sql.get_backend())->conn_;
+
+        test8_table_creator tableCreator(sql);
+
+        std::vector<int> ids;
+        std::vector<std::string> names;
+        for (int i = 1; i <= 100; ++i)
+        {
+            std::ostringstream ss;
+            ss << "name" << i;
+            ids.push_back(i);
+            names.push_back(ss.str());
+        }
+
+        sql << "insert into soci_test(id, name) values(:id, :name)",
+            use(ids), use(names);
+        assert(sqlite_api::sqlite3_get_autocommit(conn) != 0);
+
+        int count = 0;
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 100);
+
+        // the rows preceding the failing one are kept
+        std::vector<int> ids2;
+        ids2.push_back(101);
+        ids2.push_back(102);
+        ids2.push_back(1);
+        ids2.push_back(103);
+        try
+        {
+            sql << "insert into soci_test(id) values(:id)", use(ids2);
+            assert(false);
+        }
+        catch (soci_error const &)
+        {
+        }
+        assert(sqlite_api::sqlite3_get_autocommit(conn) != 0);
+
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 102);
+
+        // inside a user transaction a savepoint is used instead
+        sql.begin();
+        std::vector<int> ids3;
+        ids3.push_back(201);
+        ids3.push_back(202);
+        sql << "insert into soci_test(id) values(:id)", use(ids3);
+        assert(sqlite_api::sqlite3_get_autocommit(conn) == 0);
+        sql.rollback();
+
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 102);
+
+        // the option can be changed for a single statement
+        statement st = (sql.prepare <<
+            "insert into soci_test(id) values(:id)", use(ids3));
+        static_cast<sqlite3_statement_backend *>(
+            st.get_backend())->set_bulk_transaction(false);
+        st.execute(true);
+
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 104);
+
+        // the transaction is rolled back if it can't be committed, here
+        // because of a deferred foreign key violation
+        sql << "pragma foreign_keys = on";
+        sql << "create table soci_test_ref(id integer references "
+            "soci_test(id) deferrable initially deferred)";
+        std::vector<int> refs;
+        refs.push_back(1);
+        refs.push_back(1000);
+        try
+        {
+            sql << "insert into soci_test_ref(id) values(:id)", use(refs);
+            assert(false);
+        }
+        catch (soci_error const &)
+        {
+        }
+        assert(sqlite_api::sqlite3_get_autocommit(conn) != 0);
+
+        sql << "select count(*) from soci_test_ref", into(count);
+        assert(count == 0);
+        sql << "drop table soci_test_ref";
+        sql << "pragma foreign_keys = off";
+    }
+
+    std::cout << "test 8 passed" << std::endl;
+}
+
+// incremental blob I/O
+void test9()
+{
+    {
+        session sql(backEnd, connectString);
+
+        blob_table_creator tableCreator(sql);
+
+        // the blob is written in chunks in memory
+        char const chunk[] = "0123456789";
+        {
+            blob b(sql);
+            for (int i = 0; i != 1000; ++i)
+            {
+                b.append(chunk, 10);
+            }
+            assert(b.get_len() == 10000);
+            sql << "insert into soci_test(id, img) values(1, :img)", use(b);
+        }
+
+        sql << "insert into soci_test(id, img) values(2, zeroblob(20))";
+
+        long long rowId1 = 0;
+        long long rowId2 = 0;
+        sql << "select rowid from soci_test where id = 1", into(rowId1);
+        sql << "select rowid from soci_test where id = 2", into(rowId2);
+
+        {
+            blob b(sql);
+            sqlite3_blob_backend *bbe
+                = static_cast<sqlite3_blob_backend *>(b.get_backend());
+
+            bbe->open("soci_test", "img", rowId1, true);
+            assert(bbe->is_open());
+            assert(b.get_len() == 10000);
+
+            char buf[10];
+            assert(b.read(9995, buf, 10) == 5);
+            assert(std::strncmp(buf, "56789", 5) == 0);
+
+            // the blob opened for reading only can't be modified
+            try
+            {
+                b.write(0, chunk, 10);
+                assert(false);
+            }
+            catch (soci_error const &)
+            {
+            }
+
+            bbe->open("soci_test", "img", rowId2);
+            assert(b.get_len() == 20);
+            b.write(5, chunk, 10);
+
+            // the size of the blob opened in the database is fixed
+            try
+            {
+                b.append(chunk, 10);
+                assert(false);
+            }
+            catch (soci_error const &)
+            {
+            }
+
+            bbe->reopen(rowId1);
+            assert(b.get_len() == 10000);
+            bbe->close();
+            assert(b.get_len() == 0);
+        }
+
+        std::string img;
+        sql << "select hex(img) from soci_test where id = 2", into(img);
+        assert(img == "0000000000" "30313233343536373839" "0000000000");
+    }
+
+    std::cout << "test 9 passed" << std::endl;
+}
+
+// connection options
+void test10()
+{
+    char const *dbFile = "soci-sqlite3-test10.db";
+    std::remove(dbFile);
+
+    {
+        session sql(backEnd, std::string("db=") + dbFile +
+            " page_size=8192 journal_mode=wal synchronous=normal"
+            " cache_size=-4000 mmap_size=1048576 temp_store=memory"
+            " busy_timeout=2500 nomutex=true");
+
+        sql << "create table soci_test(id integer)";
+
+        int pageSize = 0;
+        sql << "pragma page_size", into(pageSize);
+        assert(pageSize == 8192);
+
+        std::string journalMode;
+        sql << "pragma journal_mode", into(journalMode);
+        assert(journalMode == "wal");
+
+        int synchronous = 0;
+        sql << "pragma synchronous", into(synchronous);
+        assert(synchronous == 1);
+
+        int cacheSize = 0;
+        sql << "pragma cache_size", into(cacheSize);
+        assert(cacheSize == -4000);
+
+        int tempStore = 0;
+        sql << "pragma temp_store", into(tempStore);
+        assert(tempStore == 2);
+
+        int busyTimeout = 0;
+        sql << "pragma busy_timeout", into(busyTimeout);
+        assert(busyTimeout == 2500);
+    }
+
+    {
+        session sql(backEnd, std::string("db=") + dbFile + " readonly=true");
+
+        int count = -1;
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 0);
+
+        try
+        {
+            sql << "insert into soci_test(id) values(1)";
+            assert(false);
+        }
+        catch (soci_error const &)
+        {
+        }
+    }
+
+    {
+        // the connection can also be given as URI
+        session sql(backEnd, std::string("db=file:") + dbFile +
+            "?mode=ro uri=true");
+
+        int count = -1;
+        sql << "select count(*) from soci_test", into(count);
+        assert(count == 0);
+    }
+
+    std::remove(dbFile);
+    std::remove((std::string(dbFile) + "-wal").c_str());
+    std::remove((std::string(dbFile) + "-shm").c_str());
+
+    std::cout << "test 10 passed" << std::endl;
+}
+
+struct test11_table_creator : table_creator_base
+{
+    test11_table_creator(session & sql)
+        : table_creator_base(sql)
+    {
+        sql << "create table soci_test(r real, n numeric, b blob)";
+    }
+};
+
+int test11_steps = 0;
+
+extern "C" void test11_count_step(sqlite_api::sqlite3_context *ctx,
+    int /* argc */, sqlite_api::sqlite3_value ** /* argv */)
+{
+    ++test11_steps;
+    sqlite_api::sqlite3_result_int(ctx, 1);
+}
+
+// the columns of unknown types are described with a single step
+void test11()
+{
+    {
+        session sql(backEnd, connectString);
+        sql.set_statement_cache_size(10);
+
+        test11_table_creator tableCreator(sql);
+
+        sql << "insert into soci_test(r, n, b) values(1.5, 7, 'abc')";
+
+        sqlite_api::sqlite3 *conn
+            = static_cast<sqlite3_session_backend *>(sql.get_backend())->conn_;
+        sqlite_api::sqlite3_create_function(conn, "soci_count_step", 0,
+            SQLITE_UTF8, 0, test11_count_step, 0, 0);
+
+        std::string const query
+            = "select r, n, b from soci_test where soci_count_step()";
+
+        row r;
+        sql << query, into(r);
+        assert(r.size() == 3);
+        assert(r.get_properties(0).get_data_type() == dt_double);
+        assert(r.get_properties(1).get_data_type() == dt_integer);
+        assert(r.get_properties(2).get_data_type() == dt_string);
+        assert(equal_approx(r.get<double>(0), 1.5));
+        assert(r.get<int>(1) == 7);
+        assert(r.get<std::string>(2) == "abc");
+
+        // one step to describe the columns and one to fetch the row
+        assert(test11_steps == 2);
+
+        // the types are not found again for the cached statement
+        row r2;
+        sql << query, into(r2);
+        assert(r2.get_properties(0).get_data_type() == dt_double);
+        assert(test11_steps == 3);
+    }
+
+    std::cout << "test 11 passed" << std::endl;
+}
+
+// the text used by a query returning rows can change while they are fetched
+void test12()
+{
+    {
+        session sql(backEnd, connectString);
+
+        std::string prefix("a");
+        std::string val;
+        statement st = (sql.prepare <<
+            "with recursive r(n) as "
+            "(select 1 union all select n + 1 from r where n < 3) "
+            "select :prefix || n from r",
+            use(prefix), into(val));
+        st.execute(true);
+        assert(val == "a1");
+
+        prefix = std::string(100, 'b');
+        assert(st.fetch());
+        assert(val == "a2");
+        assert(st.fetch());
+        assert(val == "a3");
+        assert(st.fetch() == false);
+    }
+
+    std::cout << "test 12 passed" << std::endl;
+}
+
 // DDL Creation objects for common tests
 struct table_creator_one : public table_creator_base
 {
@@ -377,6 +934,13 @@ int main(int argc, char** argv)
         test3();
         test4();
         test5();
+        test6();
+        test7();
+        test8();
+        test9();
+        test10();
+        test11();
+        test12();
 
         std::cout << "\nOK, all tests passed.\n\n";
 
@@ -11,6 +11,7 @@
 // std
 #include <cassert>
 #include <cstddef>
+#include <cstdio>
 #include <cstdlib>
 #include <ctime>
 #include <string>
@@ -46,6 +47,32 @@ void set_in_vector(void* p, int indx, T const& val)
     v[indx] = val;
 }
 
+// The text form of a cached value, the numbers are formatted like SQLite
+// itself does it. This is only needed when converting them to the types
+// other than the numeric ones.
+char const* column_text(sqlite3_column const& col, std::string& tmp)
+{
+    char buf[32];
+    switch (col.type_)
+    {
+    case SQLITE_INTEGER:
+        snprintf(buf, sizeof(buf), "%" LL_FMT_FLAGS "d", col.int64_);
+        break;
+    case SQLITE_FLOAT:
+        snprintf(buf, sizeof(buf), "%.15g", col.double_);
+        if (std::strpbrk(buf, ".eni") == NULL)
+        {
+            std::strcat(buf, ".0");
+        }
+        break;
+    default:
+        return col.data_.c_str();
+    }
+
+    tmp = buf;
+    return tmp.c_str();
+}
+
 } // namespace anonymous
 
 void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
@@ -56,6 +83,8 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
         return;
     }
 
+    std::string tmp;
+
     int const endRow = static_cast<int>(statement_.dataCache_.size());
     for (int i = 0; i < endRow; ++i)
     {
@@ -82,50 +111,73 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
             }
         }
 
-        const char * buf = curCol.data_.c_str();
-
-        // set buf to a null string if a null pointer is returned
-        if (buf == NULL)
-        {
-            buf = "";
-        }
-
         switch (type_)
         {
         case x_char:
-            set_in_vector(data_, i, *buf);
+            set_in_vector(data_, i, *column_text(curCol, tmp));
             break;
         case x_stdstring:
-            set_in_vector<std::string>(data_, i, buf);
+            {
+                std::vector<std::string>& v =
+                    *static_cast<std::vector<std::string>*>(data_);
+                if (curCol.type_ == SQLITE_TEXT || curCol.type_ == SQLITE_BLOB)
+                {
+                    v[i] = curCol.data_;
+                }
+                else
+                {
+                    v[i] = column_text(curCol, tmp);
+                }
+            }
             break;
         case x_short:
             {
-                short const val = string_to_integer<short>(buf);
+                short const val = curCol.type_ == SQLITE_INTEGER
+                    ? integer_cast<short>(curCol.int64_)
+                    : string_to_integer<short>(column_text(curCol, tmp));
                 set_in_vector(data_, i, val);
             }
             break;
         case x_integer:
             {
-                int const val = string_to_integer<int>(buf);
+                int const val = curCol.type_ == SQLITE_INTEGER
+                    ? integer_cast<int>(curCol.int64_)
+                    : string_to_integer<int>(column_text(curCol, tmp));
                 set_in_vector(data_, i, val);
             }
             break;
         case x_long_long:
             {
-                long long const val = string_to_integer<long long>(buf);
+                long long const val = curCol.type_ == SQLITE_INTEGER
+                    ? curCol.int64_
+                    : string_to_integer<long long>(column_text(curCol, tmp));
                 set_in_vector(data_, i, val);
             }
             break;
         case x_unsigned_long_long:
             {
-                unsigned long long const val
-                    = string_to_unsigned_integer<unsigned long long>(buf);
+                unsigned long long const val = curCol.type_ == SQLITE_INTEGER
+                    ? static_cast<unsigned long long>(curCol.int64_)
+                    : string_to_unsigned_integer<unsigned long long>(
+                        column_text(curCol, tmp));
                 set_in_vector(data_, i, val);
             }
             break;
         case x_double:
             {
-                double const val = strtod(buf, NULL);
+                double val;
+                switch (curCol.type_)
+                {
+                case SQLITE_INTEGER:
+                    val = static_cast<double>(curCol.int64_);
+                    break;
+                case SQLITE_FLOAT:
+                    val = curCol.double_;
+                    break;
+                default:
+                    val = strtod(curCol.data_.c_str(), NULL);
+                    break;
+                }
                 set_in_vector(data_, i, val);
             }
             break;
@@ -133,7 +185,7 @@ void sqlite3_vector_into_type_backend::post_fetch(bool gotData, indicator * ind)
             {
                 // attempt to parse the string and convert to std::tm
                 std::tm t;
-                parse_std_tm(buf, t);
+                parse_std_tm(column_text(curCol, tmp), t);
 
                 set_in_vector(data_, i, t);
             }
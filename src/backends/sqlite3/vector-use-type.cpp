@@ -9,15 +9,13 @@
 #include <soci-platform.h>
 #include "common.h"
 // std
-#include <cstdio>
-#include <cstdlib>
-#include <cstring>
-#include <limits>
+#include <ctime>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(disable:4355 4996)
-#define snprintf _snprintf // TODO: use soci-platform.h
 #endif
 
 using namespace soci;
@@ -81,138 +79,60 @@ void sqlite3_vector_use_type_backend::pre_use(indicator const * ind)
 
     for (size_t i = 0; i != vsize; ++i)
     {
-        char *buf = 0;
-
         // make sure that each row can accomodate the number of columns
         if (statement_.useData_[i].size() < static_cast<std::size_t>(position_))
         {
             statement_.useData_[i].resize(position_);
         }
 
+        sqlite3_column &col = statement_.useData_[i][pos];
+
         // the data in vector can be either i_ok or i_null
         if (ind != NULL && ind[i] == i_null)
         {
-            statement_.useData_[i][pos].isNull_ = true;
-            statement_.useData_[i][pos].data_ = "";
-            statement_.useData_[i][pos].blobBuf_ = 0;
-            statement_.useData_[i][pos].blobSize_ = 0;
+            col.type_ = SQLITE_NULL;
+            col.isNull_ = true;
+            col.data_ = "";
+            col.blobBuf_ = 0;
+            col.blobSize_ = 0;
         }
         else
         {
-            // allocate and fill the buffer with text-formatted client data
+            // the elements are bound directly from the user's vector
+            void *elem = 0;
             switch (type_)
             {
             case x_char:
-                {
-                    std::vector<char> *pv
-                        = static_cast<std::vector<char> *>(data_);
-                    std::vector<char> &v = *pv;
-
-                    buf = new char[2];
-                    buf[0] = v[i];
-                    buf[1] = '\0';
-                }
+                elem = &(*static_cast<std::vector<char> *>(data_))[i];
                 break;
             case x_stdstring:
-                {
-                    std::vector<std::string> *pv
-                        = static_cast<std::vector<std::string> *>(data_);
-                    std::vector<std::string> &v = *pv;
-
-                    buf = new char[v[i].size() + 1];
-                    std::strcpy(buf, v[i].c_str());
-                }
+                elem = &(*static_cast<std::vector<std::string> *>(data_))[i];
                 break;
             case x_short:
-                {
-                    std::vector<short> *pv
-                        = static_cast<std::vector<short> *>(data_);
-                    std::vector<short> &v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<short>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", static_cast<int>(v[i]));
-                }
+                elem = &(*static_cast<std::vector<short> *>(data_))[i];
                 break;
             case x_integer:
-                {
-                    std::vector<int> *pv
-                        = static_cast<std::vector<int> *>(data_);
-                    std::vector<int> &v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<int>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%d", v[i]);
-                }
+                elem = &(*static_cast<std::vector<int> *>(data_))[i];
                 break;
             case x_long_long:
-                {
-                    std::vector<long long> *pv
-                        = static_cast<std::vector<long long> *>(data_);
-                    std::vector<long long> &v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<long long>::digits10 + 3;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "d", v[i]);
-                }
+                elem = &(*static_cast<std::vector<long long> *>(data_))[i];
                 break;
             case x_unsigned_long_long:
-                {
-                    std::vector<unsigned long long>* pv
-                        = static_cast<std::vector<unsigned long long>*>(data_);
-                    std::vector<unsigned long long>& v = *pv;
-
-                    std::size_t const bufSize
-                        = std::numeric_limits<unsigned long long>::digits10 + 2;
-                    buf = new char[bufSize];
-                    snprintf(buf, bufSize, "%" LL_FMT_FLAGS "u", v[i]);
-                }
+                elem = &(*static_cast<std::vector<unsigned long long> *>(
+                    data_))[i];
                 break;
             case x_double:
-                {
-                    // no need to overengineer it (KISS)...
-
-                    std::vector<double> *pv
-                        = static_cast<std::vector<double> *>(data_);
-                    std::vector<double> &v = *pv;
-
-                    std::size_t const bufSize = 100;
-                    buf = new char[bufSize];
-
-                    snprintf(buf, bufSize, "%.20g", v[i]);
-                }
+                elem = &(*static_cast<std::vector<double> *>(data_))[i];
                 break;
             case x_stdtm:
-                {
-                    std::vector<std::tm> *pv
-                        = static_cast<std::vector<std::tm> *>(data_);
-                    std::vector<std::tm> &v = *pv;
-
-                    std::size_t const bufSize = 20;
-                    buf = new char[bufSize];
-
-                    snprintf(buf, bufSize, "%d-%02d-%02d %02d:%02d:%02d",
-                        v[i].tm_year + 1900, v[i].tm_mon + 1, v[i].tm_mday,
-                        v[i].tm_hour, v[i].tm_min, v[i].tm_sec);
-                }
+                elem = &(*static_cast<std::vector<std::tm> *>(data_))[i];
                 break;
             default:
                 throw soci_error(
                     "Use vector element used with non-supported type.");
             }
 
-            statement_.useData_[i][pos].isNull_ = false;
-            statement_.useData_[i][pos].data_ = buf;
-            statement_.useData_[i][pos].blobBuf_ = 0;
-            statement_.useData_[i][pos].blobSize_ = 0;
-        }
-
-        if (buf)
-        {
-            delete [] buf;
+            set_use_value(col, type_, elem);
         }
     }
 }
@@ -7,207 +7,784 @@
 
 #define SOCI_SOURCE
 #include "connection-pool.h"
+#include "connection-parameters.h"
 #include "error.h"
 #include "session.h"
-#include <vector>
+#include "thread-support.h"
+#include <deque>
+#include <list>
+#include <string>
 #include <utility>
-
-#ifndef _WIN32
-// POSIX implementation
-
-#include <pthread.h>
-#include <sys/time.h>
-#include <errno.h>
+#include <vector>
 
 using namespace soci;
+using namespace soci::details;
 
-struct connection_pool::connection_pool_impl
+namespace // anonymous
 {
-    bool find_free(std::size_t & pos)
+
+// Opens one session of the pool, possibly in its own thread.
+struct pool_opener
+{
+    static void run(void * p)
     {
-        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        pool_opener * const o = static_cast<pool_opener *>(p);
+        try
         {
-            if (sessions_[i].first)
-            {
-                pos = i;
-                return true;
-            }
+            o->session_->open(*o->parameters_);
+        }
+        catch (std::exception const & e)
+        {
+            o->failed_ = true;
+            o->error_ = e.what();
         }
-
-        return false;
     }
 
-    // by convention, first == true means the entry is free (not used)
-    std::vector<std::pair<bool, session *> > sessions_;
-    pthread_mutex_t mtx_;
-    pthread_cond_t cond_;
+    session * session_;
+    connection_parameters const * parameters_;
+    bool failed_;
+    std::string error_;
+    pool_thread thread_;
 };
 
-connection_pool::connection_pool(std::size_t size)
+// Add the time (in microseconds) to the histogram, see
+// connection_pool_stats.
+void add_time(long long * histogram, long long us)
 {
-    if (size == 0)
+    std::size_t i = 0;
+    while (us > 0 && i + 1 != connection_pool_stats::histogram_size)
     {
-        throw soci_error("Invalid pool size");
+        us >>= 1;
+        ++i;
     }
 
-    pimpl_ = new connection_pool_impl();
-    pimpl_->sessions_.resize(size);
-    for (std::size_t i = 0; i != size; ++i)
-    {
-        pimpl_->sessions_[i] = std::make_pair(true, new session());
-    }
+    ++histogram[i];
+}
 
-    int cc = pthread_mutex_init(&(pimpl_->mtx_), NULL);
-    if (cc != 0)
+// One session of the pool with its state.
+//
+// In the thread affinity mode, used_, listed_ and lastUsed_ are protected by
+// the mutex of the slot, so that a thread can take again the session which
+// it used last without locking the whole pool. Otherwise everything is
+// protected by the pool mutex and the slot mutex is not used.
+struct pool_slot
+{
+    pool_slot()
+        : session_(NULL), used_(false), listed_(false), opened_(false),
+          lastUsed_(0), leasedAt_(-1), leases_(0)
     {
-        throw soci_error("Synchronization error");
+        for (std::size_t i = 0; i != connection_pool_stats::histogram_size; ++i)
+        {
+            waitTime_[i] = 0;
+            holdTime_[i] = 0;
+        }
     }
 
-    cc = pthread_cond_init(&(pimpl_->cond_), NULL);
-    if (cc != 0)
+    session * session_;
+
+    // true if the session is leased
+    bool used_;
+
+    // true if the position is in one of the free lists, in the thread
+    // affinity mode it can stay there while the session is used, such stale
+    // entries are dropped when they are found
+    bool listed_;
+
+    // true if the session is connected (or is being connected by its user)
+    // in an elastic pool
+    bool opened_;
+
+    long long lastUsed_;
+
+    // statistics, protected like used_, leasedAt_ is negative when the
+    // session is not leased by a user
+    long long leasedAt_;
+    long long leases_;
+    long long waitTime_[connection_pool_stats::histogram_size];
+    long long holdTime_[connection_pool_stats::histogram_size];
+
+    pool_mutex mtx_;
+};
+
+// Lock of a slot, which is only taken in the thread affinity mode.
+class pool_slot_lock
+{
+public:
+    pool_slot_lock(pool_slot & slot, bool enabled)
+        : mtx_(enabled ? &slot.mtx_ : NULL)
     {
-        throw soci_error("Synchronization error");
+        if (mtx_ != NULL)
+        {
+            mtx_->lock();
+        }
     }
-}
 
-connection_pool::~connection_pool()
-{
-    for (std::size_t i = 0; i != pimpl_->sessions_.size(); ++i)
+    ~pool_slot_lock()
     {
-        delete pimpl_->sessions_[i].second;
+        if (mtx_ != NULL)
+        {
+            mtx_->unlock();
+        }
     }
 
-    pthread_mutex_destroy(&(pimpl_->mtx_));
-    pthread_cond_destroy(&(pimpl_->cond_));
+private:
+    pool_mutex * mtx_;
 
-    delete pimpl_;
-}
+    // noncopyable
+    pool_slot_lock(pool_slot_lock const &);
+    pool_slot_lock & operator=(pool_slot_lock const &);
+};
 
-session & connection_pool::at(std::size_t pos)
+} // namespace anonymous
+
+struct connection_pool::connection_pool_impl
 {
-    if (pos >= pimpl_->sessions_.size())
+    explicit connection_pool_impl(std::size_t size)
+        : size_(size), slots_(new pool_slot[size]), affine_(NULL),
+          timeouts_(0), elastic_(false), minSize_(0), maxIdleTime_(-1), openCount_(0),
+          stopping_(false), reaperWaiting_(false)
     {
-        throw soci_error("Invalid pool position");
+        try
+        {
+            for (std::size_t i = 0; i != size; ++i)
+            {
+                slots_[i].session_ = new session();
+            }
+        }
+        catch (...)
+        {
+            destroy();
+            throw;
+        }
     }
 
-    return *(pimpl_->sessions_[pos].second);
-}
+    ~connection_pool_impl()
+    {
+        stop_reaper();
+        destroy();
+    }
 
-std::size_t connection_pool::lease()
-{
-    std::size_t pos;
+    void destroy()
+    {
+        for (std::size_t i = 0; i != size_; ++i)
+        {
+            delete slots_[i].session_;
+        }
+        delete [] slots_;
+        delete affine_;
+    }
 
-    // no timeout
-    bool const success = try_lease(pos, -1);
-    assert(success);
+    // Thread waiting for a free session. The waiters are queued by
+    // priority, then in the order of their arrival, and a session given
+    // back is handed over directly to the first of them, so that nobody can
+    // take it in between and no waiter is starved by the ones with the same
+    // or a lower priority.
+    struct waiter
+    {
+        pool_signal signal_;
+        std::size_t pos_;
+        bool served_;
+        long long start_;
+        int priority_;
+    };
+
+    typedef std::list<waiter *> waiters_type;
+
+    // the functions below must be called with the pool mutex locked, unless
+    // noted otherwise, the slot mutex is always taken after the pool one
+
+    // Lease the session to the user who started to wait for it at start
+    // (negative if it didn't wait), must be called with the slot mutex
+    // locked too.
+    void claim(pool_slot & slot, long long start)
+    {
+        slot.used_ = true;
 
-    return pos;
-}
+        long long const now = now_us();
+        slot.leasedAt_ = now;
+        ++slot.leases_;
+        add_time(slot.waitTime_, start < 0 ? 0 : now - start);
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
-{
-    struct timespec tm;
-    if (timeout >= 0)
+        // the session is opened by its new user if needed
+        if (elastic_ && slot.opened_ == false)
+        {
+            slot.opened_ = true;
+            ++openCount_;
+            wake_reaper();
+        }
+    }
+
+    // Wake the reaper up if it waits without a deadline while there may now
+    // be sessions to close, must be called with the pool mutex locked.
+    void wake_reaper()
     {
-        // timeout is relative in milliseconds
+        if (reaperWaiting_ && openCount_ > minSize_)
+        {
+            reaperWaiting_ = false;
+            reaperSignal_.signal();
+        }
+    }
 
-        struct timeval tmv;
-        gettimeofday(&tmv, NULL);
+    // number of sessions which can't be leased with the given priority
+    std::size_t reserved_for(int priority) const
+    {
+        std::size_t count = 0;
+        for (std::size_t i = 0; i != reserved_.size(); ++i)
+        {
+            if (reserved_[i].first > priority && reserved_[i].second > count)
+            {
+                count = reserved_[i].second;
+            }
+        }
+        return count;
+    }
 
-        tm.tv_sec = tmv.tv_sec + timeout / 1000;
-        tm.tv_nsec = tmv.tv_usec * 1000 + (timeout % 1000) * 1000 * 1000;
+    // Check if a session can be leased with the given priority, when there
+    // are extra free sessions besides the ones in the free lists. The free
+    // lists don't have stale entries when there are reservations, as the
+    // sessions are then never taken directly in the thread affinity mode.
+    bool may_take(int priority, std::size_t extra) const
+    {
+        return reserved_.empty() ||
+            freeOpen_.size() + freeClosed_.size() + extra >
+                reserved_for(priority);
     }
 
-    int cc = pthread_mutex_lock(&(pimpl_->mtx_));
-    if (cc != 0)
+    bool take_free(std::size_t & pos, long long start, int priority)
     {
-        throw soci_error("Synchronization error");
+        if (may_take(priority, 0) == false)
+        {
+            return false;
+        }
+
+        for (;;)
+        {
+            // the most recently given back session is reused first, it is
+            // the most likely to have its connection and caches still warm,
+            // the closed sessions of an elastic pool are only used when
+            // there are no open ones left
+            if (freeOpen_.empty() == false)
+            {
+                pos = freeOpen_.back();
+                freeOpen_.pop_back();
+            }
+            else if (freeClosed_.empty() == false)
+            {
+                pos = freeClosed_.back();
+                freeClosed_.pop_back();
+            }
+            else
+            {
+                return false;
+            }
+
+            pool_slot & slot = slots_[pos];
+            pool_slot_lock lock(slot, affine_ != NULL);
+
+            slot.listed_ = false;
+            if (slot.used_)
+            {
+                // stale entry, the session was taken again directly by the
+                // thread which used it last
+                continue;
+            }
+
+            claim(slot, start);
+            return true;
+        }
     }
 
-    while (pimpl_->find_free(pos) == false)
+    // Make the session available to the others, when it was given back and
+    // its listed_ flag was set while it was not in the free lists.
+    void put_free(std::size_t pos)
     {
-        if (timeout < 0)
+        pool_slot & slot = slots_[pos];
+        pool_slot_lock lock(slot, affine_ != NULL);
+
+        if (slot.used_)
+        {
+            // it was taken again directly by the thread which used it last
+            // in the meantime, it will be listed when given back again
+            slot.listed_ = false;
+            return;
+        }
+
+        // the first waiter has the highest priority, so if it can't take
+        // the session, none of the others can
+        if (waiters_.empty() == false &&
+            may_take(waiters_.front()->priority_, 1))
         {
-            // no timeout, allow unlimited blocking
-            cc = pthread_cond_wait(&(pimpl_->cond_), &(pimpl_->mtx_));
+            waiter * const w = waiters_.front();
+            waiters_.pop_front();
+
+            slot.listed_ = false;
+            claim(slot, w->start_);
+            w->pos_ = pos;
+            w->served_ = true;
+
+            // signalled under the lock, the waiter destroys its signal as
+            // soon as it sees that it was served
+            w->signal_.signal();
+            return;
+        }
+
+        if (elastic_ == false || slot.opened_)
+        {
+            freeOpen_.push_back(pos);
+            wake_reaper();
         }
         else
         {
-            // wait with timeout
-            cc = pthread_cond_timedwait(
-                &(pimpl_->cond_), &(pimpl_->mtx_), &tm);
+            freeClosed_.push_back(pos);
         }
+    }
 
-        if (cc == ETIMEDOUT)
+    // Mark the session as free and return true if it has to be put in the
+    // free lists, must be called with the slot mutex locked.
+    bool release(pool_slot & slot)
+    {
+        if (slot.used_ == false)
         {
-            break;
+            throw soci_error("Cannot release pool entry (already free)");
+        }
+
+        slot.used_ = false;
+        if (maxIdleTime_ >= 0)
+        {
+            slot.lastUsed_ = now_ms();
         }
+
+        if (slot.leasedAt_ >= 0)
+        {
+            add_time(slot.holdTime_, now_us() - slot.leasedAt_);
+            slot.leasedAt_ = -1;
+        }
+
+        bool const listed = slot.listed_;
+        slot.listed_ = true;
+        return listed == false;
     }
 
-    if (cc == 0)
+    void set_closed(pool_slot & slot)
     {
-        pimpl_->sessions_[pos].first = false;
+        if (slot.opened_)
+        {
+            slot.opened_ = false;
+            --openCount_;
+        }
     }
 
-    pthread_mutex_unlock(&(pimpl_->mtx_));
+    // Take the session given back last by the calling thread, if it is
+    // still free, called without any lock in the thread affinity mode.
+    bool lease_affine(std::size_t & pos)
+    {
+        std::size_t const last = affine_->get();
+        if (last == 0 || last > size_)
+        {
+            return false;
+        }
 
-    return cc == 0;
-}
+        pool_slot & slot = slots_[last - 1];
+        pool_lock lock(slot.mtx_);
 
-void connection_pool::give_back(std::size_t pos)
-{
-    if (pos >= pimpl_->sessions_.size())
+        // the sessions which need to be opened are taken the usual way
+        if (slot.used_ || slot.session_->get_backend() == NULL)
+        {
+            return false;
+        }
+
+        // its entry in the free lists is dropped by the next one who finds it
+        slot.used_ = true;
+        pos = last - 1;
+
+        // there is nothing to wait for here
+        slot.leasedAt_ = now_us();
+        ++slot.leases_;
+        ++slot.waitTime_[0];
+        return true;
+    }
+
+    // called without any lock
+    bool lease(std::size_t & pos, int timeout, int priority)
     {
-        throw soci_error("Invalid pool position");
+        if (affine_ != NULL && reserved_.empty() && lease_affine(pos))
+        {
+            return true;
+        }
+
+        pool_lock lock(mtx_);
+
+        // there are no free sessions for this priority when somebody with
+        // the same or a higher one is already waiting
+        if (take_free(pos, -1, priority))
+        {
+            return true;
+        }
+
+        if (timeout == 0)
+        {
+            ++timeouts_;
+            return false;
+        }
+
+        // timeout is relative in milliseconds
+        long long const deadline = timeout > 0 ? now_ms() + timeout : -1;
+
+        waiter w;
+        w.served_ = false;
+        w.start_ = now_us();
+        w.priority_ = priority;
+
+        // after the waiters with the same or a higher priority
+        waiters_type::iterator next = waiters_.end();
+        while (next != waiters_.begin())
+        {
+            waiters_type::iterator prev = next;
+            --prev;
+            if ((*prev)->priority_ >= priority)
+            {
+                break;
+            }
+            next = prev;
+        }
+
+        waiters_type::iterator const it = waiters_.insert(next, &w);
+
+        try
+        {
+            while (w.served_ == false)
+            {
+                if (w.signal_.wait(mtx_, deadline) == false)
+                {
+                    break;
+                }
+            }
+        }
+        catch (...)
+        {
+            if (w.served_)
+            {
+                give_back_locked(w.pos_, false);
+            }
+            else
+            {
+                waiters_.erase(it);
+            }
+            throw;
+        }
+
+        // the session could have been handed over just when the wait timed out
+        if (w.served_)
+        {
+            pos = w.pos_;
+            return true;
+        }
+
+        waiters_.erase(it);
+        ++timeouts_;
+        return false;
     }
 
-    int cc = pthread_mutex_lock(&(pimpl_->mtx_));
-    if (cc != 0)
+    void give_back_locked(std::size_t pos, bool closed)
     {
-        throw soci_error("Synchronization error");
+        pool_slot & slot = slots_[pos];
+
+        bool unlisted;
+        {
+            pool_slot_lock lock(slot, affine_ != NULL);
+
+            unlisted = release(slot);
+            if (closed)
+            {
+                set_closed(slot);
+            }
+        }
+
+        if (unlisted)
+        {
+            put_free(pos);
+        }
     }
 
-    if (pimpl_->sessions_[pos].first)
+    // called without any lock
+    void give_back(std::size_t pos, bool closed)
     {
-        pthread_mutex_unlock(&(pimpl_->mtx_));
-        throw soci_error("Cannot release pool entry (already free)");
+        if (affine_ != NULL)
+        {
+            affine_->set(pos + 1);
+
+            if (closed == false)
+            {
+                // the session stays in the free lists while it is used by
+                // the thread which had it last, so there is nothing else to
+                // do if it is there, and then nobody is waiting for it
+                pool_slot & slot = slots_[pos];
+                bool unlisted;
+                {
+                    pool_lock lock(slot.mtx_);
+                    unlisted = release(slot);
+                }
+
+                if (unlisted)
+                {
+                    pool_lock lock(mtx_);
+                    put_free(pos);
+                }
+                return;
+            }
+        }
+
+        pool_lock lock(mtx_);
+        give_back_locked(pos, closed);
     }
 
-    pimpl_->sessions_[pos].first = true;
+    // Open the sessions of an elastic pool which are used right from the
+    // start, each one in its own thread, as opening the connections usually
+    // takes more time waiting for the server than doing anything.
+    void warm_up()
+    {
+        std::vector<pool_opener> openers(minSize_);
+        for (std::size_t i = 0; i != minSize_; ++i)
+        {
+            pool_opener & o = openers[i];
+            o.session_ = slots_[i].session_;
+            o.parameters_ = &parameters_;
+            o.failed_ = false;
 
-    pthread_mutex_unlock(&(pimpl_->mtx_));
+            if (minSize_ == 1 || o.thread_.start(pool_opener::run, &o) == false)
+            {
+                pool_opener::run(&o);
+            }
+        }
 
-    pthread_cond_signal(&(pimpl_->cond_));
-}
+        for (std::size_t i = 0; i != minSize_; ++i)
+        {
+            openers[i].thread_.join();
+        }
+
+        for (std::size_t i = 0; i != minSize_; ++i)
+        {
+            if (openers[i].failed_)
+            {
+                throw soci_error(openers[i].error_);
+            }
+        }
 
-#else
-// Windows implementation
+        long long const now = now_ms();
 
-#include <Windows.h>
+        // the first session ends at the top of the stack
+        for (std::size_t i = size_; i != minSize_; --i)
+        {
+            slots_[i - 1].listed_ = true;
+            freeClosed_.push_back(i - 1);
+        }
+        for (std::size_t i = minSize_; i != 0; --i)
+        {
+            pool_slot & slot = slots_[i - 1];
+            slot.opened_ = true;
+            slot.lastUsed_ = now;
+            slot.listed_ = true;
+            freeOpen_.push_back(i - 1);
+        }
+        openCount_ = minSize_;
+    }
 
-using namespace soci;
+    // Close the sessions of an elastic pool which were not used for longer
+    // than maxIdleTime_, runs in its own thread until the pool is destroyed.
+    static void run_reaper(void * p)
+    {
+        static_cast<connection_pool_impl *>(p)->reap();
+    }
 
-struct connection_pool::connection_pool_impl
-{
-    bool find_free(std::size_t & pos)
+    // Find the session idle for the longest time, the ones at the bottom of
+    // the stack, dropping the stale entries, return false if there is none.
+    bool oldest_idle(std::size_t & pos, long long & lastUsed)
     {
-        for (std::size_t i = 0; i != sessions_.size(); ++i)
+        while (freeOpen_.empty() == false)
         {
-            if (sessions_[i].first)
+            pool_slot & slot = slots_[freeOpen_.front()];
+            pool_slot_lock lock(slot, affine_ != NULL);
+
+            if (slot.used_ == false)
             {
-                pos = i;
+                pos = freeOpen_.front();
+                lastUsed = slot.lastUsed_;
                 return true;
             }
+
+            slot.listed_ = false;
+            freeOpen_.pop_front();
         }
 
         return false;
     }
 
-    // by convention, first == true means the entry is free (not used)
-    std::vector<std::pair<bool, session *> > sessions_;
+    void reap()
+    {
+        pool_lock lock(mtx_);
+
+        std::vector<std::size_t> idle;
+        while (stopping_ == false)
+        {
+            // the sessions reused by the thread which had them last are not
+            // moved in the free lists, so this is only approximate in the
+            // thread affinity mode
+            long long const now = now_ms();
+            while (openCount_ > minSize_ && freeOpen_.empty() == false)
+            {
+                std::size_t const pos = freeOpen_.front();
+                pool_slot & slot = slots_[pos];
+                pool_slot_lock slotLock(slot, affine_ != NULL);
+
+                if (slot.used_ == false && now - slot.lastUsed_ < maxIdleTime_)
+                {
+                    break;
+                }
+
+                freeOpen_.pop_front();
+                slot.listed_ = false;
+                if (slot.used_)
+                {
+                    // stale entry
+                    continue;
+                }
+
+                // not leased, so not counted in the statistics
+                slot.used_ = true;
+                set_closed(slot);
+                idle.push_back(pos);
+            }
 
-    CRITICAL_SECTION mtx_;
-    HANDLE sem_;
+            if (idle.empty() == false)
+            {
+                // the connections are closed without blocking the pool
+                mtx_.unlock();
+                for (std::size_t i = 0; i != idle.size(); ++i)
+                {
+                    try
+                    {
+                        slots_[idle[i]].session_->close();
+                    }
+                    catch (...)
+                    {
+                        // the session is unusable anyhow
+                    }
+                }
+                mtx_.lock();
+
+                for (std::size_t i = 0; i != idle.size(); ++i)
+                {
+                    give_back_locked(idle[i], false);
+                }
+                idle.clear();
+                continue;
+            }
+
+            long long deadline = -1;
+            std::size_t pos;
+            long long lastUsed;
+            if (openCount_ > minSize_ && oldest_idle(pos, lastUsed))
+            {
+                deadline = lastUsed + maxIdleTime_;
+            }
+
+            // without anything to close, wait until a session is opened
+            // above minSize_ or becomes idle
+            reaperWaiting_ = deadline < 0;
+            reaperSignal_.wait(mtx_, deadline);
+            reaperWaiting_ = false;
+        }
+    }
+
+    void get_stats(connection_pool_stats & stats)
+    {
+        pool_lock lock(mtx_);
+
+        stats.size_ = size_;
+        stats.open_ = elastic_ ? openCount_ : size_;
+        stats.inUse_ = 0;
+        stats.waiting_ = waiters_.size();
+        stats.leases_ = 0;
+        stats.timeouts_ = timeouts_;
+
+        std::size_t const n = connection_pool_stats::histogram_size;
+        for (std::size_t i = 0; i != n; ++i)
+        {
+            stats.waitTime_[i] = 0;
+            stats.holdTime_[i] = 0;
+        }
+
+        for (std::size_t pos = 0; pos != size_; ++pos)
+        {
+            pool_slot & slot = slots_[pos];
+            pool_slot_lock slotLock(slot, affine_ != NULL);
+
+            if (slot.leasedAt_ >= 0)
+            {
+                ++stats.inUse_;
+            }
+            stats.leases_ += slot.leases_;
+            for (std::size_t i = 0; i != n; ++i)
+            {
+                stats.waitTime_[i] += slot.waitTime_[i];
+                stats.holdTime_[i] += slot.holdTime_[i];
+            }
+        }
+    }
+
+    void start_reaper()
+    {
+        if (reaper_.start(run_reaper, this) == false)
+        {
+            throw soci_error("Cannot create pool thread");
+        }
+    }
+
+    void stop_reaper()
+    {
+        {
+            pool_lock lock(mtx_);
+            stopping_ = true;
+            reaperSignal_.signal();
+        }
+
+        reaper_.join();
+    }
+
+    std::size_t const size_;
+    pool_slot * slots_;
+
+    // free sessions, used as stacks, the open ones are also taken from the
+    // front when they are idle for too long
+    std::deque<std::size_t> freeOpen_;
+    std::vector<std::size_t> freeClosed_;
+
+    waiters_type waiters_;
+
+    pool_mutex mtx_;
+
+    // position (plus one) of the session given back last by each thread,
+    // only in the thread affinity mode
+    pool_thread_local * affine_;
+
+    // number of the failed leases
+    long long timeouts_;
+
+    // number of sessions kept for the leases with the given priority or a
+    // higher one
+    std::vector<std::pair<int, std::size_t> > reserved_;
+
+    // elastic pool configuration and state
+    bool elastic_;
+    connection_parameters parameters_;
+    std::size_t minSize_;
+    int maxIdleTime_;
+    std::size_t openCount_;
+
+    bool stopping_;
+    bool reaperWaiting_; // the reaper waits without a deadline
+    pool_signal reaperSignal_;
+    pool_thread reaper_;
 };
 
 connection_pool::connection_pool(std::size_t size)
@@ -217,117 +794,153 @@ connection_pool::connection_pool(std::size_t size)
         throw soci_error("Invalid pool size");
     }
 
-    pimpl_ = new connection_pool_impl();
-    pimpl_->sessions_.resize(size);
-    for (std::size_t i = 0; i != size; ++i)
-    {
-        pimpl_->sessions_[i] = std::make_pair(true, new session());
-    }
-
-    InitializeCriticalSection(&(pimpl_->mtx_));
+    pimpl_ = new connection_pool_impl(size);
 
-    // initially all entries are available
-    HANDLE s = CreateSemaphore(NULL,
-        static_cast<LONG>(size), static_cast<LONG>(size), NULL);
-    if (s == NULL)
+    // the first session ends at the top of the stack
+    for (std::size_t i = size; i != 0; --i)
     {
-        throw soci_error("Synchronization error");
+        pimpl_->slots_[i - 1].listed_ = true;
+        pimpl_->freeOpen_.push_back(i - 1);
     }
-
-    pimpl_->sem_ = s;
 }
 
-connection_pool::~connection_pool()
+connection_pool::connection_pool(connection_parameters const & parameters,
+    std::size_t minSize, std::size_t maxSize, int maxIdleTime)
 {
-    for (std::size_t i = 0; i != pimpl_->sessions_.size(); ++i)
+    if (maxSize == 0 || minSize > maxSize)
     {
-        delete pimpl_->sessions_[i].second;
+        throw soci_error("Invalid pool size");
     }
 
-    DeleteCriticalSection(&(pimpl_->mtx_));
-    CloseHandle(pimpl_->sem_);
+    pimpl_ = new connection_pool_impl(maxSize);
+    pimpl_->elastic_ = true;
+    pimpl_->parameters_ = parameters;
+    pimpl_->minSize_ = minSize;
+    pimpl_->maxIdleTime_ = maxIdleTime;
+
+    try
+    {
+        pimpl_->warm_up();
 
+        if (maxIdleTime >= 0)
+        {
+            pimpl_->start_reaper();
+        }
+    }
+    catch (...)
+    {
+        delete pimpl_;
+        throw;
+    }
+}
+
+connection_pool::~connection_pool()
+{
     delete pimpl_;
 }
 
 session & connection_pool::at(std::size_t pos)
 {
-    if (pos >= pimpl_->sessions_.size())
+    if (pos >= pimpl_->size_)
     {
         throw soci_error("Invalid pool position");
     }
 
-    return *(pimpl_->sessions_[pos].second);
+    return *(pimpl_->slots_[pos].session_);
 }
 
-std::size_t connection_pool::lease()
+std::size_t connection_pool::lease(int priority)
 {
     std::size_t pos;
 
     // no timeout
-    bool const success = try_lease(pos, -1);
-    assert(success);    
-    if (!success)
-    {
-        // TODO: anything to report? --mloskot
-    }
+    bool const success = try_lease(pos, -1, priority);
+    assert(success);
 
     return pos;
 }
 
-bool connection_pool::try_lease(std::size_t & pos, int timeout)
+bool connection_pool::try_lease(std::size_t & pos, int timeout, int priority)
 {
-    DWORD cc = WaitForSingleObject(pimpl_->sem_,
-        timeout >= 0 ? static_cast<DWORD>(timeout) : INFINITE);
-    if (cc == WAIT_OBJECT_0)
+    if (pimpl_->lease(pos, timeout, priority) == false)
     {
-        // semaphore acquired, there is (at least) one free entry
-
-        EnterCriticalSection(&(pimpl_->mtx_));
+        return false;
+    }
 
-        bool const success = pimpl_->find_free(pos);
-        assert(success);
-        if (!success)
+    // the sessions of an elastic pool are opened when they are needed
+    session & sql = *(pimpl_->slots_[pos].session_);
+    if (pimpl_->elastic_ && sql.get_backend() == NULL)
+    {
+        try
         {
-            // TODO: anything to report? --mloskot
+            sql.open(pimpl_->parameters_);
         }
+        catch (...)
+        {
+            pimpl_->give_back(pos, true);
+            throw;
+        }
+    }
 
-        pimpl_->sessions_[pos].first = false;
-
-        LeaveCriticalSection(&(pimpl_->mtx_));
+    return true;
+}
 
-        return true;
+void connection_pool::give_back(std::size_t pos)
+{
+    if (pos >= pimpl_->size_)
+    {
+        throw soci_error("Invalid pool position");
     }
-    else if (cc == WAIT_TIMEOUT)
+
+    // the sessions closed by their users are opened again when needed
+    bool const closed = pimpl_->elastic_ &&
+        pimpl_->slots_[pos].session_->get_backend() == NULL;
+
+    pimpl_->give_back(pos, closed);
+}
+
+void connection_pool::set_thread_affinity(bool affinity)
+{
+    if (affinity && pimpl_->affine_ == NULL)
     {
-        return false;
+        pimpl_->affine_ = new pool_thread_local();
     }
-    else
+    else if (affinity == false && pimpl_->affine_ != NULL)
     {
-        throw soci_error("Synchronization error");
+        delete pimpl_->affine_;
+        pimpl_->affine_ = NULL;
     }
 }
 
-void connection_pool::give_back(std::size_t pos)
+bool connection_pool::get_thread_affinity() const
 {
-    if (pos >= pimpl_->sessions_.size())
+    return pimpl_->affine_ != NULL;
+}
+
+void connection_pool::set_reserved(int priority, std::size_t count)
+{
+    if (count >= pimpl_->size_)
     {
-        throw soci_error("Invalid pool position");
+        throw soci_error("Invalid pool reservation");
     }
 
-    EnterCriticalSection(&(pimpl_->mtx_));
-
-    if (pimpl_->sessions_[pos].first)
+    std::vector<std::pair<int, std::size_t> > & reserved = pimpl_->reserved_;
+    for (std::size_t i = 0; i != reserved.size(); ++i)
     {
-        LeaveCriticalSection(&(pimpl_->mtx_));
-        throw soci_error("Cannot release pool entry (already free)");
+        if (reserved[i].first == priority)
+        {
+            reserved.erase(reserved.begin() + i);
+            break;
+        }
     }
 
-    pimpl_->sessions_[pos].first = true;
-
-    LeaveCriticalSection(&(pimpl_->mtx_));
-
-    ReleaseSemaphore(pimpl_->sem_, 1, NULL);
+    if (count != 0)
+    {
+        reserved.push_back(std::make_pair(priority, count));
+    }
 }
 
-#endif // _WIN32
+void connection_pool::get_stats(connection_pool_stats & stats) const
+{
+    pimpl_->get_stats(stats);
+}
@@ -16,19 +16,70 @@ namespace soci
 {
 
 class session;
+class connection_parameters;
+
+// Snapshot of the state and of the cumulative statistics of a pool.
+struct SOCI_DECL connection_pool_stats
+{
+    // The times are counted in microseconds in buckets of exponentially
+    // growing size: the bucket 0 counts the times below 1us, the bucket i
+    // the ones in [2^(i-1), 2^i) and the last one all the longer ones.
+    enum { histogram_size = 32 };
+
+    std::size_t size_;
+    std::size_t open_;       // same as size_ unless the pool is elastic
+    std::size_t inUse_;
+    std::size_t waiting_;
+
+    long long leases_;
+    long long timeouts_;
+
+    // time spent in lease() waiting for a session to be given back (0 when
+    // one was free) and time between the lease and give_back()
+    long long waitTime_[histogram_size];
+    long long holdTime_[histogram_size];
+};
 
 class SOCI_DECL connection_pool
 {
 public:
+    // Fixed size pool, its sessions must be opened by the user, see at().
     explicit connection_pool(std::size_t size);
+
+    // Elastic pool which opens its sessions itself, when they are needed.
+    // The first minSize sessions are opened (in parallel) by the constructor
+    // and are kept open, the others are only opened when all the open ones
+    // are in use, up to maxSize of them, and are closed again after staying
+    // unused for maxIdleTime milliseconds (negative value means never).
+    connection_pool(connection_parameters const & parameters,
+        std::size_t minSize, std::size_t maxSize, int maxIdleTime = -1);
+
     ~connection_pool();
 
     session & at(std::size_t pos);
 
-    std::size_t lease();
-    bool try_lease(std::size_t & pos, int timeout);
+    // The leases with a higher priority are served first, the waiting
+    // threads are served by priority and then in the order of their arrival.
+    std::size_t lease(int priority = 0);
+    bool try_lease(std::size_t & pos, int timeout, int priority = 0);
     void give_back(std::size_t pos);
 
+    // Keep count sessions which can only be leased with the given priority
+    // or a higher one, 0 removes the reservation. This must be set before
+    // the pool is used and disables the direct reuse of the sessions in the
+    // thread affinity mode.
+    void set_reserved(int priority, std::size_t count);
+
+    // In the thread affinity mode, a thread gets back the session which it
+    // gave back last, if nobody took it since, without locking the pool for
+    // the other threads. This must be set before the pool is used.
+    void set_thread_affinity(bool affinity);
+    bool get_thread_affinity() const;
+
+    // The statistics are kept for each session under the lock protecting
+    // it anyway, so this doesn't add any synchronization to the pool.
+    void get_stats(connection_pool_stats & stats) const;
+
 private:
     struct connection_pool_impl;
     connection_pool_impl * pimpl_;
@@ -0,0 +1,387 @@
+//
+// Copyright (C) 2008 Maciej Sobczak
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "executor.h"
+#include "connection-parameters.h"
+#include "connection-pool.h"
+#include "session.h"
+#include "thread-support.h"
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace soci;
+using namespace soci::details;
+
+struct executor_task::executor_task_impl
+{
+    executor_task_impl() : refs_(0), done_(false), failed_(false) {}
+
+    pool_mutex mtx_;
+    std::size_t refs_;
+    bool done_;
+    bool failed_;
+    std::string error_;
+
+    // threads waiting for the job, each one with its own signal
+    std::list<pool_signal *> waiters_;
+};
+
+executor_task::executor_task()
+    : pimpl_(new executor_task_impl())
+{
+}
+
+executor_task::~executor_task()
+{
+    delete pimpl_;
+}
+
+void executor_task::inc_ref()
+{
+    pool_lock lock(pimpl_->mtx_);
+    ++pimpl_->refs_;
+}
+
+void executor_task::dec_ref()
+{
+    bool last;
+    {
+        pool_lock lock(pimpl_->mtx_);
+        last = --pimpl_->refs_ == 0;
+    }
+
+    if (last)
+    {
+        delete this;
+    }
+}
+
+void executor_task::run(connection_pool & pool)
+{
+    bool failed = false;
+    std::string error;
+
+    try
+    {
+        session sql(pool);
+        execute(sql);
+    }
+    catch (std::exception const & e)
+    {
+        failed = true;
+        error = e.what();
+    }
+    catch (...)
+    {
+        failed = true;
+        error = "Unknown error in executor job";
+    }
+
+    pool_lock lock(pimpl_->mtx_);
+
+    pimpl_->done_ = true;
+    pimpl_->failed_ = failed;
+    pimpl_->error_ = error;
+
+    typedef std::list<pool_signal *>::iterator iterator;
+    for (iterator it = pimpl_->waiters_.begin();
+         it != pimpl_->waiters_.end(); ++it)
+    {
+        (*it)->signal();
+    }
+}
+
+bool executor_task::is_ready()
+{
+    pool_lock lock(pimpl_->mtx_);
+    return pimpl_->done_;
+}
+
+bool executor_task::wait(int timeout)
+{
+    pool_lock lock(pimpl_->mtx_);
+
+    if (pimpl_->done_ || timeout == 0)
+    {
+        return pimpl_->done_;
+    }
+
+    // timeout is relative in milliseconds
+    long long const deadline = timeout > 0 ? now_ms() + timeout : -1;
+
+    pool_signal signal;
+    std::list<pool_signal *>::iterator const it =
+        pimpl_->waiters_.insert(pimpl_->waiters_.end(), &signal);
+
+    try
+    {
+        while (pimpl_->done_ == false)
+        {
+            if (signal.wait(pimpl_->mtx_, deadline) == false)
+            {
+                break;
+            }
+        }
+    }
+    catch (...)
+    {
+        pimpl_->waiters_.erase(it);
+        throw;
+    }
+
+    pimpl_->waiters_.erase(it);
+    return pimpl_->done_;
+}
+
+void executor_task::check_error()
+{
+    pool_lock lock(pimpl_->mtx_);
+
+    if (pimpl_->failed_)
+    {
+        throw soci_error(pimpl_->error_);
+    }
+}
+
+struct executor::executor_impl
+{
+    struct worker;
+
+    executor_impl(connection_parameters const & parameters,
+        std::size_t threads, std::size_t sessions)
+        : pool_(parameters, sessions, sessions), pending_(0),
+          stopping_(false), next_(0)
+    {
+        // each thread gets back its own session for the next job, if the
+        // pool is large enough
+        pool_.set_thread_affinity(true);
+
+        try
+        {
+            for (std::size_t i = 0; i != threads; ++i)
+            {
+                worker * const w = new worker();
+                w->executor_ = this;
+                w->index_ = i;
+                w->woken_ = false;
+                workers_.push_back(w);
+            }
+
+            for (std::size_t i = 0; i != threads; ++i)
+            {
+                if (workers_[i]->thread_.start(run_worker, workers_[i]) == false)
+                {
+                    throw soci_error("Cannot create executor thread");
+                }
+            }
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+
+    ~executor_impl()
+    {
+        stop();
+    }
+
+    struct worker
+    {
+        executor_impl * executor_;
+        std::size_t index_;
+
+        // jobs queued for this thread
+        pool_mutex mtx_;
+        std::deque<executor_task *> tasks_;
+
+        // waited for with the executor mutex locked, when idle
+        pool_signal signal_;
+        bool woken_;
+
+        pool_thread thread_;
+    };
+
+    void enqueue(executor_task * task)
+    {
+        task->inc_ref();
+
+        pool_lock lock(mtx_);
+
+        // an idle thread gets the job, or they all get one in turn
+        worker * target;
+        bool const idle = idle_.empty() == false;
+        if (idle)
+        {
+            target = idle_.back();
+            idle_.pop_back();
+        }
+        else
+        {
+            target = workers_[next_++ % workers_.size()];
+        }
+
+        try
+        {
+            pool_lock targetLock(target->mtx_);
+            target->tasks_.push_back(task);
+        }
+        catch (...)
+        {
+            task->dec_ref();
+            throw;
+        }
+        ++pending_;
+
+        if (idle)
+        {
+            target->woken_ = true;
+            target->signal_.signal();
+        }
+    }
+
+    // Take the next job queued for this thread, or for another one when
+    // there is none.
+    executor_task * take(worker & self)
+    {
+        std::size_t const count = workers_.size();
+        for (std::size_t i = 0; i != count; ++i)
+        {
+            worker & w = *workers_[(self.index_ + i) % count];
+
+            pool_lock lock(w.mtx_);
+            if (w.tasks_.empty() == false)
+            {
+                // the oldest job first, also when it is stolen
+                executor_task * const task = w.tasks_.front();
+                w.tasks_.pop_front();
+                return task;
+            }
+        }
+
+        return NULL;
+    }
+
+    static void run_worker(void * p)
+    {
+        worker * const w = static_cast<worker *>(p);
+        w->executor_->work(*w);
+    }
+
+    void work(worker & self)
+    {
+        for (;;)
+        {
+            executor_task * const task = take(self);
+            if (task != NULL)
+            {
+                {
+                    pool_lock lock(mtx_);
+                    --pending_;
+                }
+
+                task->run(pool_);
+                task->dec_ref();
+                continue;
+            }
+
+            pool_lock lock(mtx_);
+
+            // a job can be taken by another thread but not counted yet
+            if (pending_ > 0)
+            {
+                continue;
+            }
+
+            if (stopping_)
+            {
+                return;
+            }
+
+            self.woken_ = false;
+            idle_.push_back(&self);
+            while (self.woken_ == false)
+            {
+                self.signal_.wait(mtx_, -1);
+            }
+        }
+    }
+
+    void stop()
+    {
+        {
+            pool_lock lock(mtx_);
+            stopping_ = true;
+
+            for (std::size_t i = 0; i != idle_.size(); ++i)
+            {
+                idle_[i]->woken_ = true;
+                idle_[i]->signal_.signal();
+            }
+            idle_.clear();
+        }
+
+        for (std::size_t i = 0; i != workers_.size(); ++i)
+        {
+            workers_[i]->thread_.join();
+        }
+
+        for (std::size_t i = 0; i != workers_.size(); ++i)
+        {
+            delete workers_[i];
+        }
+        workers_.clear();
+    }
+
+    // destroyed last, after the threads are stopped
+    connection_pool pool_;
+
+    std::vector<worker *> workers_;
+
+    // protects the members below
+    pool_mutex mtx_;
+
+    // number of the jobs queued and not taken yet
+    long pending_;
+
+    // threads waiting for a job, the one which was idle for the shortest
+    // time is woken up first
+    std::vector<worker *> idle_;
+
+    bool stopping_;
+    std::size_t next_;
+};
+
+executor::executor(connection_parameters const & parameters,
+    std::size_t threads, std::size_t sessions)
+{
+    if (threads == 0)
+    {
+        throw soci_error("Invalid executor size");
+    }
+
+    pimpl_ = new executor_impl(parameters, threads, sessions);
+}
+
+executor::~executor()
+{
+    delete pimpl_;
+}
+
+connection_pool & executor::get_pool()
+{
+    return pimpl_->pool_;
+}
+
+void executor::enqueue(executor_task * task)
+{
+    pimpl_->enqueue(task);
+}
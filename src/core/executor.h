@@ -0,0 +1,253 @@
+//
+// Copyright (C) 2008 Maciej Sobczak
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_EXECUTOR_H_INCLUDED
+#define SOCI_EXECUTOR_H_INCLUDED
+
+#include "soci-config.h"
+#include "error.h"
+// std
+#include <cstddef>
+
+namespace soci
+{
+
+class session;
+class connection_pool;
+class connection_parameters;
+
+namespace details
+{
+
+// Job submitted to the executor, shared by the executor and the futures.
+class SOCI_DECL executor_task
+{
+public:
+    executor_task();
+    virtual ~executor_task();
+
+    void inc_ref();
+    void dec_ref();
+
+    // lease a session from the pool, execute the job with it and wake up
+    // the threads waiting for the result
+    void run(connection_pool & pool);
+
+    bool is_ready();
+
+    // timeout in milliseconds, negative means no timeout, return false if
+    // the job is not done yet
+    bool wait(int timeout);
+
+    // throw the error of the job, if it failed
+    void check_error();
+
+protected:
+    virtual void execute(session & sql) = 0;
+
+private:
+    struct executor_task_impl;
+    executor_task_impl * pimpl_;
+
+    // noncopyable
+    executor_task(executor_task const &);
+    executor_task & operator=(executor_task const &);
+};
+
+template <typename R>
+class executor_value_task : public executor_task
+{
+public:
+    R value_;
+};
+
+template <>
+class executor_value_task<void> : public executor_task
+{
+};
+
+template <typename R, typename F>
+class executor_function_task : public executor_value_task<R>
+{
+public:
+    explicit executor_function_task(F f) : f_(f) {}
+
+protected:
+    virtual void execute(session & sql) { this->value_ = f_(sql); }
+
+private:
+    F f_;
+};
+
+template <typename F>
+class executor_function_task<void, F> : public executor_value_task<void>
+{
+public:
+    explicit executor_function_task(F f) : f_(f) {}
+
+protected:
+    virtual void execute(session & sql) { f_(sql); }
+
+private:
+    F f_;
+};
+
+class executor_future_base
+{
+public:
+    bool valid() const { return task_ != NULL; }
+
+    bool is_ready() const { return task()->is_ready(); }
+    void wait() const { task()->wait(-1); }
+    bool wait(int timeout) const { return task()->wait(timeout); }
+
+protected:
+    executor_future_base() : task_(NULL) {}
+
+    explicit executor_future_base(executor_task * task) : task_(task)
+    {
+        task_->inc_ref();
+    }
+
+    executor_future_base(executor_future_base const & other)
+        : task_(other.task_)
+    {
+        if (task_ != NULL)
+        {
+            task_->inc_ref();
+        }
+    }
+
+    executor_future_base & operator=(executor_future_base const & other)
+    {
+        if (other.task_ != NULL)
+        {
+            other.task_->inc_ref();
+        }
+        if (task_ != NULL)
+        {
+            task_->dec_ref();
+        }
+        task_ = other.task_;
+        return *this;
+    }
+
+    ~executor_future_base()
+    {
+        if (task_ != NULL)
+        {
+            task_->dec_ref();
+        }
+    }
+
+    executor_task * task() const
+    {
+        if (task_ == NULL)
+        {
+            throw soci_error("Invalid executor future");
+        }
+        return task_;
+    }
+
+    executor_task * task_;
+};
+
+} // namespace details
+
+// Result of a job submitted to the executor. The errors of the job are
+// reported by get() as soci_error with the message of the original one.
+template <typename R>
+class executor_future : public details::executor_future_base
+{
+public:
+    executor_future() {}
+    explicit executor_future(details::executor_value_task<R> * task)
+        : executor_future_base(task) {}
+
+    R get() const
+    {
+        details::executor_task * const t = task();
+        t->wait(-1);
+        t->check_error();
+        return static_cast<details::executor_value_task<R> *>(t)->value_;
+    }
+};
+
+template <>
+class executor_future<void> : public details::executor_future_base
+{
+public:
+    executor_future() {}
+    explicit executor_future(details::executor_value_task<void> * task)
+        : executor_future_base(task) {}
+
+    void get() const
+    {
+        details::executor_task * const t = task();
+        t->wait(-1);
+        t->check_error();
+    }
+};
+
+// Runs the jobs using the sessions of its own connection pool in its own
+// threads, each thread has a queue of jobs and takes the jobs queued for
+// the other ones when it has nothing else to do.
+class SOCI_DECL executor
+{
+public:
+    // At most sessions connections are opened with the given parameters
+    // (all of them by the constructor) and are shared by the threads.
+    executor(connection_parameters const & parameters,
+        std::size_t threads, std::size_t sessions);
+
+    // The jobs which are still queued are executed before the destructor
+    // returns.
+    ~executor();
+
+    // The jobs are functions, or function objects defining result_type
+    // (e.g. derived from std::unary_function<session &, R>), called with
+    // the session leased for them.
+    template <typename F>
+    executor_future<typename F::result_type> submit(F f)
+    {
+        typedef typename F::result_type result_type;
+        return submit_task(
+            new details::executor_function_task<result_type, F>(f));
+    }
+
+    template <typename R>
+    executor_future<R> submit(R (*f)(session &))
+    {
+        return submit_task(
+            new details::executor_function_task<R, R (*)(session &)>(f));
+    }
+
+    connection_pool & get_pool();
+
+private:
+    template <typename R>
+    executor_future<R> submit_task(details::executor_value_task<R> * task)
+    {
+        // the future deletes the task if it can't be queued
+        executor_future<R> future(task);
+        enqueue(task);
+        return future;
+    }
+
+    void enqueue(details::executor_task * task);
+
+    struct executor_impl;
+    executor_impl * pimpl_;
+
+    // noncopyable
+    executor(executor const &);
+    executor & operator=(executor const &);
+};
+
+} // namespace soci
+
+#endif // SOCI_EXECUTOR_H_INCLUDED
@@ -8,10 +8,35 @@
 #define SOCI_SOURCE
 #include "into-type.h"
 #include "statement.h"
+#include "session.h"
 
 using namespace soci;
 using namespace soci::details;
 
+into_type_base * into_type_ptr::get() const
+{
+    if (data_ != NULL)
+    {
+        p_ = ind_ != NULL
+            ? new standard_into_type(data_, type_, *ind_)
+            : new standard_into_type(data_, type_);
+        data_ = NULL;
+    }
+
+    return p_;
+}
+
+into_type_base * into_type_ptr::get(session & s) const
+{
+    if (data_ != NULL)
+    {
+        p_ = s.acquire_into_element(data_, type_, ind_);
+        data_ = NULL;
+    }
+
+    return p_;
+}
+
 standard_into_type::~standard_into_type()
 {
     delete backEnd_;
@@ -47,6 +72,20 @@ void standard_into_type::clean_up()
     }
 }
 
+void standard_into_type::release_backend(statement_impl & st)
+{
+    if (backEnd_ != NULL)
+    {
+        st.release_into_type_backend(backEnd_);
+        backEnd_ = NULL;
+    }
+}
+
+void pooled_into_type::destroy(statement_impl & st)
+{
+    st.session_.release_into_element(this);
+}
+
 vector_into_type::~vector_into_type()
 {
     delete backEnd_;
@@ -9,7 +9,6 @@
 #define SOCI_INTO_TYPE_H_INCLUDED
 
 #include "soci-backend.h"
-#include "type-ptr.h"
 #include "exchange-traits.h"
 // std
 #include <cstddef>
@@ -42,9 +41,40 @@ public:
 
     virtual std::size_t size() const = 0;  // returns the number of elements
     virtual void resize(std::size_t /* sz */) {} // used for vectors only
+
+    // give the backend back to the statement after clean_up(), if it can be
+    // reused by another element
+    virtual void release_backend(statement_impl & /* st */) {}
+
+    // destroy the element once the statement is done with it
+    virtual void destroy(statement_impl & /* st */) { delete this; }
 };
 
-typedef type_ptr<into_type_base> into_type_ptr;
+// Holds the element created by into() until it is given to the statement.
+// The single elements of the basic types are only described here and
+// created from the session by get(session &), which reuses the elements
+// given back by the previous statements instead of allocating new ones.
+class SOCI_DECL into_type_ptr
+{
+public:
+    into_type_ptr(into_type_base * p)
+        : p_(p), data_(NULL), type_(x_char), ind_(NULL) {}
+    into_type_ptr(void * data, exchange_type type, indicator * ind)
+        : p_(NULL), data_(data), type_(type), ind_(ind) {}
+    ~into_type_ptr() { delete p_; }
+
+    into_type_base * get() const;
+    into_type_base * get(session & s) const;
+    void release() const { p_ = NULL; }
+
+private:
+    mutable into_type_base * p_;
+
+    // description of the element not created yet, if data_ is not NULL
+    mutable void * data_;
+    exchange_type type_;
+    indicator * ind_;
+};
 
 // standard types
 
@@ -61,10 +91,19 @@ public:
 protected:
     virtual void post_fetch(bool gotData, bool calledFromFetch);
 
+    // used by the elements reused for another variable
+    void set_target(void * data, exchange_type type, indicator * ind)
+    {
+        data_ = data;
+        type_ = type;
+        ind_ = ind;
+    }
+
 private:
     virtual void define(statement_impl & st, int & position);
     virtual void pre_fetch();
     virtual void clean_up();
+    virtual void release_backend(statement_impl & st);
 
     virtual std::size_t size() const { return 1; }
 
@@ -78,6 +117,23 @@ private:
     standard_into_type_backend * backEnd_;
 };
 
+// single element of a basic type created by the session for into_type_ptr,
+// given back to the session when the statement is done with it
+class SOCI_DECL pooled_into_type : public standard_into_type
+{
+public:
+    pooled_into_type(void * data, exchange_type type, indicator * ind)
+        : standard_into_type(data, type)
+    {
+        set_target(data, type, ind);
+    }
+
+    using standard_into_type::set_target;
+
+private:
+    virtual void destroy(statement_impl & st);
+};
+
 // into type base class for vectors
 class SOCI_DECL vector_into_type : public into_type_base
 {
@@ -137,18 +193,48 @@ public:
             static_cast<exchange_type>(exchange_traits<T>::x_type), ind) {}
 };
 
+// the elements of the types handled by standard_into_type are only
+// described, the others are created right away
+
+template <typename T>
+into_type_ptr make_into_type_ptr(T & t, standard_into_type *)
+{
+    return into_type_ptr(&t,
+        static_cast<exchange_type>(exchange_traits<T>::x_type), NULL);
+}
+
+template <typename T>
+into_type_ptr make_into_type_ptr(T & t, into_type_base *)
+{
+    return into_type_ptr(new into_type<T>(t));
+}
+
+template <typename T>
+into_type_ptr make_into_type_ptr(T & t, indicator & ind,
+    standard_into_type *)
+{
+    return into_type_ptr(&t,
+        static_cast<exchange_type>(exchange_traits<T>::x_type), &ind);
+}
+
+template <typename T>
+into_type_ptr make_into_type_ptr(T & t, indicator & ind, into_type_base *)
+{
+    return into_type_ptr(new into_type<T>(t, ind));
+}
+
 // helper dispatchers for basic types
 
 template <typename T>
 into_type_ptr do_into(T & t, basic_type_tag)
 {
-    return into_type_ptr(new into_type<T>(t));
+    return make_into_type_ptr(t, static_cast<into_type<T> *>(NULL));
 }
 
 template <typename T>
 into_type_ptr do_into(T & t, indicator & ind, basic_type_tag)
 {
-    return into_type_ptr(new into_type<T>(t, ind));
+    return make_into_type_ptr(t, ind, static_cast<into_type<T> *>(NULL));
 }
 
 template <typename T>
@@ -14,10 +14,10 @@ using namespace soci;
 using namespace soci::details;
 
 once_temp_type::once_temp_type(session & s)
-    : rcst_(new ref_counted_statement(s))
+    : rcst_(s.acquire_once_statement())
 {
     // this is the beginning of new query
-    s.get_query_stream().str("");
+    s.reset_query();
 }
 
 once_temp_type::once_temp_type(once_temp_type const & o)
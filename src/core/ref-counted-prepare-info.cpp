@@ -14,13 +14,13 @@ using namespace soci::details;
 
 void ref_counted_prepare_info::exchange(into_type_ptr const & i)
 {
-    intos_.push_back(i.get());
+    intos_.push_back(i.get(session_));
     i.release();
 }
 
 void ref_counted_prepare_info::exchange(use_type_ptr const & u)
 {
-    uses_.push_back(u.get());
+    uses_.push_back(u.get(session_));
     u.release();
 }
 
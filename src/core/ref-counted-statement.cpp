@@ -23,7 +23,7 @@ void ref_counted_statement::final_action()
     try
     {
         st_.alloc();
-        st_.prepare(session_.get_query(), st_one_time_query);
+        st_.prepare(session_.get_query_text(), st_one_time_query);
         st_.define_and_bind();
 
         const bool gotData = st_.execute(true);
@@ -38,6 +38,21 @@ void ref_counted_statement::final_action()
     st_.clean_up();
 }
 
+void ref_counted_statement::release()
+{
+    session_.release_once_statement(this);
+}
+
+void ref_counted_statement_base::accumulate(char const * t)
+{
+    session_.append_query(t);
+}
+
+void ref_counted_statement_base::accumulate(std::string const & t)
+{
+    session_.append_query(t);
+}
+
 std::ostringstream& ref_counted_statement_base::get_query_stream()
 {
     return session_.get_query_stream();
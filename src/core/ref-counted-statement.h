@@ -13,6 +13,7 @@
 #include "use-type.h"
 // std
 #include <sstream>
+#include <string>
 
 namespace soci
 {
@@ -41,18 +42,27 @@ public:
             }
             catch (...)
             {
-                delete this;
+                release();
                 throw;
             }
 
-            delete this;
+            release();
         }
     }
 
     template <typename T>
     void accumulate(T const & t) { get_query_stream() << t; }
 
+    // strings don't need any formatting, so they are appended to the
+    // query text directly instead of going through the query stream
+    void accumulate(char const * t);
+    void accumulate(std::string const & t);
+
 protected:
+    // called instead of deleting the object when it is not referenced
+    // any more, can be overridden to reuse it
+    virtual void release() { delete this; }
+
     // this function allows to break the circular dependenc
     // between session and this class
     std::ostringstream & get_query_stream();
@@ -80,6 +90,11 @@ public:
 
     virtual void final_action();
 
+protected:
+    // the object is given back to the session to be reused by the next
+    // "once" statement, see session::acquire_once_statement()
+    virtual void release();
+
 private:
     statement st_;
 };
@@ -70,6 +70,40 @@ struct exchange_traits<row>
     typedef basic_type_tag type_family;
 };
 
+// Support selecting into a batch of rows for dynamic queries in bulk
+
+template <>
+class into_type<row_batch>
+    : public into_type_base // bypass the vector_into_type
+{
+public:
+    into_type(row_batch & rb) : rb_(rb) {}
+
+private:
+    virtual void define(statement_impl & st, int & /* position */)
+    {
+        st.set_row_batch(&rb_);
+
+        // the columns are described and bound as separate vector
+        // into elements as part of the statement execute
+    }
+
+    virtual void pre_fetch() {}
+    virtual void post_fetch(bool /* gotData */, bool /* calledFromFetch */) {}
+    virtual void clean_up() {}
+
+    virtual std::size_t size() const { return rb_.size(); }
+    virtual void resize(std::size_t sz) { rb_.resize(sz); }
+
+    row_batch & rb_;
+};
+
+template <>
+struct exchange_traits<row_batch>
+{
+    typedef basic_type_tag type_family;
+};
+
 } // namespace details
 
 } // namespace soci
@@ -8,16 +8,85 @@
 #define SOCI_SOURCE
 #include "row.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cctype>
+#include <ctime>
 #include <sstream>
 #include <string>
 
 using namespace soci;
 using namespace details;
 
+namespace // anonymous
+{
+
+struct index_entry_less
+{
+    typedef std::pair<std::string, std::size_t> entry;
+
+    bool operator()(entry const & a, std::string const & b) const
+    {
+        return a.first < b;
+    }
+
+    bool operator()(std::string const & a, entry const & b) const
+    {
+        return a < b.first;
+    }
+};
+
+std::size_t units_for(data_type dt)
+{
+    switch (dt)
+    {
+    case dt_string:
+        return type_holder_units<std::string>();
+    case dt_double:
+        return type_holder_units<double>();
+    case dt_integer:
+        return type_holder_units<int>();
+    case dt_long_long:
+        return type_holder_units<long long>();
+    case dt_unsigned_long_long:
+        return type_holder_units<unsigned long long>();
+    case dt_date:
+        return type_holder_units<std::tm>();
+    }
+
+    throw soci_error("Unknown data type of the row column.");
+}
+
+void construct_value(data_type dt, type_holder_unit * p)
+{
+    switch (dt)
+    {
+    case dt_string:
+        type_holder_construct<std::string>(p);
+        break;
+    case dt_double:
+        type_holder_construct<double>(p);
+        break;
+    case dt_integer:
+        type_holder_construct<int>(p);
+        break;
+    case dt_long_long:
+        type_holder_construct<long long>(p);
+        break;
+    case dt_unsigned_long_long:
+        type_holder_construct<unsigned long long>(p);
+        break;
+    case dt_date:
+        type_holder_construct<std::tm>(p);
+        break;
+    }
+}
+
+} // namespace anonymous
+
 row::row()
-    : uppercaseColumnNames_(false)
+    : valuesSize_(0)
+    , uppercaseColumnNames_(false)
     , currentPos_(0)
 {}
 
@@ -54,33 +123,71 @@ void row::add_properties(column_properties const &cp)
         columnName = originalName;
     }
 
-    index_[columnName] = columns_.size() - 1;
+    std::size_t const pos = columns_.size() - 1;
+
+    column_handle handle;
+    handle.pos_ = pos;
+    handle.offset_ = valuesSize_;
+    handle.dataType_ = cp.get_data_type();
+    handles_.push_back(handle);
+
+    valuesSize_ += units_for(handle.dataType_);
+
+    std::vector<index_entry>::iterator const it = std::lower_bound(
+        index_.begin(), index_.end(), columnName, index_entry_less());
+    if (it != index_.end() && it->first == columnName)
+    {
+        it->second = pos;
+    }
+    else
+    {
+        index_.insert(it, index_entry(columnName, pos));
+    }
+}
+
+void row::alloc_values()
+{
+    assert(values_.empty());
+
+    values_.resize(valuesSize_);
+    indicators_.resize(handles_.size(), i_ok);
+
+    std::size_t const hsize = handles_.size();
+    for (std::size_t i = 0; i != hsize; ++i)
+    {
+        construct_value(handles_[i].dataType_, &values_[handles_[i].offset_]);
+    }
 }
 
 std::size_t row::size() const
 {
-    return holders_.size();
+    return indicators_.size();
 }
 
 void row::clean_up()
 {
-    std::size_t const hsize = holders_.size();
-    for (std::size_t i = 0; i != hsize; ++i)
+    // only strings need to be destroyed, all the other values are trivial
+    std::size_t const vsize = values_.empty() ? 0 : handles_.size();
+    for (std::size_t i = 0; i != vsize; ++i)
     {
-        delete holders_[i];
-        delete indicators_[i];
+        if (handles_[i].dataType_ == dt_string)
+        {
+            type_holder_destroy<std::string>(&values_[handles_[i].offset_]);
+        }
     }
 
     columns_.clear();
-    holders_.clear();
+    handles_.clear();
+    values_.clear();
     indicators_.clear();
     index_.clear();
+    valuesSize_ = 0;
 }
 
 indicator row::get_indicator(std::size_t pos) const
 {
     assert(indicators_.size() >= static_cast<std::size_t>(pos + 1));
-    return *indicators_[pos];
+    return indicators_[pos];
 }
 
 indicator row::get_indicator(std::string const &name) const
@@ -99,10 +206,22 @@ column_properties const & row::get_properties(std::string const &name) const
     return get_properties(find_column(name));
 }
 
+column_handle const & row::get_handle(std::size_t pos) const
+{
+    assert(handles_.size() >= pos + 1);
+    return handles_[pos];
+}
+
+column_handle const & row::get_handle(std::string const &name) const
+{
+    return get_handle(find_column(name));
+}
+
 std::size_t row::find_column(std::string const &name) const
 {
-    std::map<std::string, std::size_t>::const_iterator it = index_.find(name);
-    if (it == index_.end())
+    std::vector<index_entry>::const_iterator const it = std::lower_bound(
+        index_.begin(), index_.end(), name, index_entry_less());
+    if (it == index_.end() || it->first != name)
     {
         std::ostringstream msg;
         msg << "Column '" << name << "' not found";
@@ -111,3 +230,197 @@ std::size_t row::find_column(std::string const &name) const
 
     return it->second;
 }
+
+row_batch::row_batch(std::size_t size)
+    : size_(size)
+{}
+
+row_batch::~row_batch()
+{
+    clean_up();
+}
+
+void row_batch::uppercase_column_names(bool forceToUpper)
+{
+    header_.uppercase_column_names(forceToUpper);
+}
+
+void row_batch::add_properties(column_properties const &cp)
+{
+    header_.add_properties(cp);
+}
+
+void row_batch::clean_up()
+{
+    header_.clean_up();
+
+    columns_.clear();
+    strings_.clear();
+    doubles_.clear();
+    integers_.clear();
+    longLongs_.clear();
+    unsignedLongLongs_.clear();
+    dates_.clear();
+    indicators_.clear();
+}
+
+void row_batch::alloc_columns()
+{
+    assert(columns_.empty());
+
+    // all the vectors must be created before any of them is bound,
+    // so that they are not moved later
+    std::size_t const csize = header_.columns_.size();
+    for (std::size_t i = 0; i != csize; ++i)
+    {
+        switch (header_.handles_[i].get_data_type())
+        {
+        case dt_string:
+            columns_.push_back(strings_.size());
+            strings_.push_back(std::vector<std::string>(size_));
+            break;
+        case dt_double:
+            columns_.push_back(doubles_.size());
+            doubles_.push_back(std::vector<double>(size_));
+            break;
+        case dt_integer:
+            columns_.push_back(integers_.size());
+            integers_.push_back(std::vector<int>(size_));
+            break;
+        case dt_long_long:
+            columns_.push_back(longLongs_.size());
+            longLongs_.push_back(std::vector<long long>(size_));
+            break;
+        case dt_unsigned_long_long:
+            columns_.push_back(unsignedLongLongs_.size());
+            unsignedLongLongs_.push_back(
+                std::vector<unsigned long long>(size_));
+            break;
+        case dt_date:
+            columns_.push_back(dates_.size());
+            dates_.push_back(std::vector<std::tm>(size_));
+            break;
+        }
+    }
+
+    indicators_.resize(csize, std::vector<indicator>(size_, i_ok));
+}
+
+void row_batch::resize(std::size_t sz)
+{
+    for (std::size_t i = 0; i != strings_.size(); ++i)
+    {
+        strings_[i].resize(sz);
+    }
+    for (std::size_t i = 0; i != doubles_.size(); ++i)
+    {
+        doubles_[i].resize(sz);
+    }
+    for (std::size_t i = 0; i != integers_.size(); ++i)
+    {
+        integers_[i].resize(sz);
+    }
+    for (std::size_t i = 0; i != longLongs_.size(); ++i)
+    {
+        longLongs_[i].resize(sz);
+    }
+    for (std::size_t i = 0; i != unsignedLongLongs_.size(); ++i)
+    {
+        unsignedLongLongs_[i].resize(sz);
+    }
+    for (std::size_t i = 0; i != dates_.size(); ++i)
+    {
+        dates_[i].resize(sz);
+    }
+    for (std::size_t i = 0; i != indicators_.size(); ++i)
+    {
+        indicators_[i].resize(sz, i_ok);
+    }
+
+    size_ = sz;
+}
+
+std::size_t row_batch::get_number_of_columns() const
+{
+    return header_.columns_.size();
+}
+
+column_properties const & row_batch::get_properties(std::size_t pos) const
+{
+    return header_.get_properties(pos);
+}
+
+column_properties const & row_batch::get_properties(
+    std::string const &name) const
+{
+    return header_.get_properties(name);
+}
+
+indicator row_batch::get_indicator(std::size_t i, std::size_t pos) const
+{
+    assert(indicators_.size() >= pos + 1);
+    assert(size_ >= i + 1);
+    return indicators_[pos][i];
+}
+
+indicator row_batch::get_indicator(std::size_t i,
+    std::string const &name) const
+{
+    return get_indicator(i, header_.find_column(name));
+}
+
+void row_batch::get_row(std::size_t i, row & r) const
+{
+    assert(size_ >= i + 1);
+
+    std::size_t const csize = header_.columns_.size();
+
+    bool sameColumns = r.size() == csize;
+    for (std::size_t pos = 0; sameColumns && pos != csize; ++pos)
+    {
+        sameColumns = r.handles_[pos].get_data_type() ==
+            header_.handles_[pos].get_data_type();
+    }
+
+    if (sameColumns == false)
+    {
+        r.clean_up();
+        for (std::size_t pos = 0; pos != csize; ++pos)
+        {
+            r.add_properties(header_.columns_[pos]);
+        }
+        r.alloc_values();
+    }
+
+    for (std::size_t pos = 0; pos != csize; ++pos)
+    {
+        std::size_t const column = columns_[pos];
+
+        switch (header_.handles_[pos].get_data_type())
+        {
+        case dt_string:
+            r.value_ref<std::string>(pos) = strings_[column][i];
+            break;
+        case dt_double:
+            r.value_ref<double>(pos) = doubles_[column][i];
+            break;
+        case dt_integer:
+            r.value_ref<int>(pos) = integers_[column][i];
+            break;
+        case dt_long_long:
+            r.value_ref<long long>(pos) = longLongs_[column][i];
+            break;
+        case dt_unsigned_long_long:
+            r.value_ref<unsigned long long>(pos) =
+                unsignedLongLongs_[column][i];
+            break;
+        case dt_date:
+            r.value_ref<std::tm>(pos) = dates_[column][i];
+            break;
+        }
+
+        r.indicator_ref(pos) = indicators_[pos][i];
+    }
+
+    r.reset_get_counter();
+}
@@ -14,8 +14,10 @@
 // std
 #include <cassert>
 #include <cstddef>
-#include <map>
+#include <ctime>
 #include <string>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 namespace soci
@@ -38,6 +40,34 @@ private:
     data_type dataType_;
 };
 
+namespace details
+{
+class statement_impl;
+} // namespace details
+
+// Precomputed reference to a column of a row, obtained with
+// row::get_handle(). It remains valid for all the rows fetched by the
+// same statement and allows to access the column value without looking
+// it up by name.
+class SOCI_DECL column_handle
+{
+public:
+    column_handle() : pos_(0), offset_(0), dataType_(dt_string) {}
+
+    std::size_t get_position() const { return pos_; }
+    data_type get_data_type() const { return dataType_; }
+
+private:
+    friend class row;
+
+    std::size_t pos_;
+
+    // position of the value in the values buffer of the row
+    std::size_t offset_;
+
+    data_type dataType_;
+};
+
 class SOCI_DECL row
 {
 public:    
@@ -52,40 +82,52 @@ public:
     indicator get_indicator(std::size_t pos) const;
     indicator get_indicator(std::string const& name) const;
 
-    template <typename T>
-    inline void add_holder(T* t, indicator* ind)
-    {
-        holders_.push_back(new details::type_holder<T>(t));
-        indicators_.push_back(ind);
-    }
-
     column_properties const& get_properties(std::size_t pos) const;
     column_properties const& get_properties(std::string const& name) const;
 
+    column_handle const& get_handle(std::size_t pos) const;
+    column_handle const& get_handle(std::string const& name) const;
+
     template <typename T>
-    T get(std::size_t pos) const
+    T get(column_handle const &handle) const
     {
-        assert(holders_.size() >= pos + 1);
+        assert(indicators_.size() >= handle.pos_ + 1);
 
         typedef typename type_conversion<T>::base_type base_type;
-        base_type const& baseVal = holders_[pos]->get<base_type>();
+        base_type const& baseVal = value<base_type>(handle);
 
         T ret;
-        type_conversion<T>::from_base(baseVal, *indicators_[pos], ret);
+        type_conversion<T>::from_base(baseVal, indicators_[handle.pos_], ret);
         return ret;
     }
 
     template <typename T>
-    T get(std::size_t pos, T const &nullValue) const
+    T get(column_handle const &handle, T const &nullValue) const
     {
-        assert(holders_.size() >= pos + 1);
+        assert(indicators_.size() >= handle.pos_ + 1);
 
-        if (i_null == *indicators_[pos])
+        if (i_null == indicators_[handle.pos_])
         {
             return nullValue;
         }
 
-        return get<T>(pos);
+        return get<T>(handle);
+    }
+
+    template <typename T>
+    T get(std::size_t pos) const
+    {
+        assert(handles_.size() >= pos + 1);
+
+        return get<T>(handles_[pos]);
+    }
+
+    template <typename T>
+    T get(std::size_t pos, T const &nullValue) const
+    {
+        assert(handles_.size() >= pos + 1);
+
+        return get<T>(handles_[pos], nullValue);
     }
 
     template <typename T>
@@ -99,13 +141,7 @@ public:
     T get(std::string const &name, T const &nullValue) const
     {
         std::size_t const pos = find_column(name);
-
-        if (i_null == *indicators_[pos])
-        {
-            return nullValue;
-        }
-
-        return get<T>(pos);
+        return get<T>(pos, nullValue);
     }
 
     template <typename T>
@@ -131,17 +167,201 @@ private:
     row(row const &);
     void operator=(row const &);
 
+    // the values are allocated and bound by the statement describing
+    // the row, once all the columns are known
+    friend class details::statement_impl;
+    friend class row_batch;
+
+    void alloc_values();
+
+    template <typename T>
+    T & value_ref(std::size_t pos)
+    {
+        return *reinterpret_cast<T *>(&values_[handles_[pos].offset_]);
+    }
+
+    indicator & indicator_ref(std::size_t pos)
+    {
+        return indicators_[pos];
+    }
+
+    template <typename T>
+    T const& value(column_handle const &handle) const
+    {
+        if (static_cast<int>(handle.dataType_) !=
+            static_cast<int>(details::type_holder_traits<T>::type))
+        {
+            throw std::bad_cast();
+        }
+
+        return *reinterpret_cast<T const *>(&values_[handle.offset_]);
+    }
+
     std::size_t find_column(std::string const& name) const;
 
+    typedef std::pair<std::string, std::size_t> index_entry;
+
     std::vector<column_properties> columns_;
-    std::vector<details::holder*> holders_;
-    std::vector<indicator*> indicators_;
-    std::map<std::string, std::size_t> index_;
+    std::vector<column_handle> handles_;
+
+    // all the values are held in this single buffer and their indicators
+    // in the parallel array, both are allocated by alloc_values()
+    std::vector<details::type_holder_unit> values_;
+    std::vector<indicator> indicators_;
+    std::size_t valuesSize_;
+
+    // column names index, sorted by name
+    std::vector<index_entry> index_;
 
     bool uppercaseColumnNames_;
     mutable std::size_t currentPos_;
 };
 
+// Batch of rows fetched in bulk by dynamic queries. The values of each
+// column are kept in a separate vector, which is bound by the statement as
+// a vector into element, so that many rows are fetched at once.
+class SOCI_DECL row_batch
+{
+public:
+    explicit row_batch(std::size_t size);
+    ~row_batch();
+
+    void uppercase_column_names(bool forceToUpper);
+    void add_properties(column_properties const& cp);
+    void clean_up();
+
+    // number of rows in the batch
+    std::size_t size() const { return size_; }
+    void resize(std::size_t sz);
+
+    std::size_t get_number_of_columns() const;
+
+    column_properties const& get_properties(std::size_t pos) const;
+    column_properties const& get_properties(std::string const& name) const;
+
+    indicator get_indicator(std::size_t i, std::size_t pos) const;
+    indicator get_indicator(std::size_t i, std::string const& name) const;
+
+    template <typename T>
+    T get(std::size_t i, std::size_t pos) const
+    {
+        assert(columns_.size() >= pos + 1);
+        assert(size_ >= i + 1);
+
+        typedef typename type_conversion<T>::base_type base_type;
+        base_type const& baseVal = value<base_type>(i, pos);
+
+        T ret;
+        type_conversion<T>::from_base(baseVal, indicators_[pos][i], ret);
+        return ret;
+    }
+
+    template <typename T>
+    T get(std::size_t i, std::size_t pos, T const &nullValue) const
+    {
+        assert(columns_.size() >= pos + 1);
+        assert(size_ >= i + 1);
+
+        if (i_null == indicators_[pos][i])
+        {
+            return nullValue;
+        }
+
+        return get<T>(i, pos);
+    }
+
+    template <typename T>
+    T get(std::size_t i, std::string const &name) const
+    {
+        return get<T>(i, header_.find_column(name));
+    }
+
+    template <typename T>
+    T get(std::size_t i, std::string const &name, T const &nullValue) const
+    {
+        return get<T>(i, header_.find_column(name), nullValue);
+    }
+
+    // Copies the i-th row of the batch to the given row, which gets the
+    // same columns as the batch first if it doesn't have them yet.
+    void get_row(std::size_t i, row & r) const;
+
+private:
+    // copy not supported
+    row_batch(row_batch const &);
+    void operator=(row_batch const &);
+
+    // the columns are allocated and bound by the statement describing
+    // the batch, once all of them are known
+    friend class details::statement_impl;
+
+    void alloc_columns();
+
+    template <typename T>
+    std::vector<T> & column_ref(std::size_t pos)
+    {
+        std::vector<std::vector<T> > const & values =
+            columns(static_cast<T *>(NULL));
+        return const_cast<std::vector<T> &>(values[columns_[pos]]);
+    }
+
+    std::vector<indicator> & indicators_ref(std::size_t pos)
+    {
+        return indicators_[pos];
+    }
+
+    template <typename T>
+    T const& value(std::size_t i, std::size_t pos) const
+    {
+        if (static_cast<int>(header_.handles_[pos].get_data_type()) !=
+            static_cast<int>(details::type_holder_traits<T>::type))
+        {
+            throw std::bad_cast();
+        }
+
+        return columns(static_cast<T *>(NULL))[columns_[pos]][i];
+    }
+
+    // the vectors holding the columns of each type
+    std::vector<std::vector<std::string> > const& columns(std::string *) const
+    { return strings_; }
+    std::vector<std::vector<double> > const& columns(double *) const
+    { return doubles_; }
+    std::vector<std::vector<int> > const& columns(int *) const
+    { return integers_; }
+    std::vector<std::vector<long long> > const& columns(long long *) const
+    { return longLongs_; }
+    std::vector<std::vector<unsigned long long> > const&
+        columns(unsigned long long *) const
+    { return unsignedLongLongs_; }
+    std::vector<std::vector<std::tm> > const& columns(std::tm *) const
+    { return dates_; }
+
+    template <typename T>
+    std::vector<std::vector<T> > const& columns(T *) const
+    {
+        // no column can hold values of this type
+        throw std::bad_cast();
+    }
+
+    // the properties and the names index of the columns
+    row header_;
+
+    // position of each column in the vectors of its type
+    std::vector<std::size_t> columns_;
+
+    std::vector<std::vector<std::string> > strings_;
+    std::vector<std::vector<double> > doubles_;
+    std::vector<std::vector<int> > integers_;
+    std::vector<std::vector<long long> > longLongs_;
+    std::vector<std::vector<unsigned long long> > unsignedLongLongs_;
+    std::vector<std::vector<std::tm> > dates_;
+
+    std::vector<std::vector<indicator> > indicators_;
+
+    std::size_t size_;
+};
+
 } // namespace soci
 
 #endif // SOCI_ROW_H_INCLUDED
@@ -50,6 +50,7 @@ template <>
 struct exchange_traits<soci::rowid>
 {
     typedef basic_type_tag type_family;
+    enum { x_type = x_rowid };
 };
 
 } // namespace details
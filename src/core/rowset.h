@@ -8,14 +8,183 @@
 #ifndef SOCI_ROWSET_H_INCLUDED
 #define SOCI_ROWSET_H_INCLUDED
 
+#include "row-exchange.h"
 #include "statement.h"
 // std
+#include <cstddef>
+#include <ctime>
 #include <iterator>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace soci
 {
 
+namespace details
+{
+
+//
+// Types which can be fetched by rowset in bulk, through a vector into element.
+// These are all the basic types and the user-defined types converted to them.
+//
+struct rowset_bulk_tag {};
+struct rowset_single_tag {};
+
+template <typename T>
+struct rowset_base_traits
+{
+    typedef rowset_single_tag fetch_type;
+};
+
+#define SOCI_ROWSET_BULK_TYPE(T) \
+template <> \
+struct rowset_base_traits<T> \
+{ \
+    typedef rowset_bulk_tag fetch_type; \
+}
+
+SOCI_ROWSET_BULK_TYPE(char);
+SOCI_ROWSET_BULK_TYPE(short);
+SOCI_ROWSET_BULK_TYPE(unsigned short);
+SOCI_ROWSET_BULK_TYPE(int);
+SOCI_ROWSET_BULK_TYPE(unsigned int);
+SOCI_ROWSET_BULK_TYPE(long);
+SOCI_ROWSET_BULK_TYPE(unsigned long);
+SOCI_ROWSET_BULK_TYPE(long long);
+SOCI_ROWSET_BULK_TYPE(unsigned long long);
+SOCI_ROWSET_BULK_TYPE(double);
+SOCI_ROWSET_BULK_TYPE(std::string);
+SOCI_ROWSET_BULK_TYPE(std::tm);
+
+#undef SOCI_ROWSET_BULK_TYPE
+
+template <typename T>
+struct rowset_traits
+{
+    typedef typename rowset_base_traits
+        <
+            typename type_conversion<T>::base_type
+        >::fetch_type fetch_type;
+};
+
+//
+// Buffer of rows fetched in batches, used by rowset in the bulk mode.
+//
+template <typename T>
+class rowset_batch
+{
+public:
+
+    rowset_batch(statement & st, std::size_t batchSize)
+        : st_(st), rows_(batchSize), pos_(0), count_(0)
+    {
+        st_.exchange_for_rowset(into(rows_));
+    }
+
+    // Moves to the next row, fetching the next batch if the current one
+    // is exhausted, returns false at the end of the rowset.
+    bool next()
+    {
+        if (pos_ + 1 < count_)
+        {
+            ++pos_;
+            return true;
+        }
+
+        if (st_.fetch() == false)
+        {
+            count_ = 0;
+            return false;
+        }
+
+        pos_ = 0;
+        count_ = rows_.size();
+        return true;
+    }
+
+    T & current()
+    {
+        return rows_[pos_];
+    }
+
+private:
+
+    statement & st_;
+    std::vector<T> rows_;
+
+    // current row and the number of rows in the current batch
+    std::size_t pos_;
+    std::size_t count_;
+
+    // Non-copyable
+    rowset_batch(rowset_batch const &);
+    rowset_batch & operator=(rowset_batch const &);
+
+}; // class rowset_batch
+
+// The rows of dynamic queries are fetched in bulk through a row_batch,
+// each of them is copied from the batch to the row seen by the iterator.
+template <>
+struct rowset_traits<row>
+{
+    typedef rowset_bulk_tag fetch_type;
+};
+
+template <>
+class rowset_batch<row>
+{
+public:
+
+    rowset_batch(statement & st, std::size_t batchSize)
+        : st_(st), rows_(batchSize), pos_(0), count_(0)
+    {
+        st_.exchange_for_rowset(into(rows_));
+    }
+
+    bool next()
+    {
+        if (pos_ + 1 < count_)
+        {
+            ++pos_;
+        }
+        else if (st_.fetch())
+        {
+            pos_ = 0;
+            count_ = rows_.size();
+        }
+        else
+        {
+            count_ = 0;
+            return false;
+        }
+
+        rows_.get_row(pos_, row_);
+        return true;
+    }
+
+    row & current()
+    {
+        return row_;
+    }
+
+private:
+
+    statement & st_;
+    row_batch rows_;
+    row row_;
+
+    std::size_t pos_;
+    std::size_t count_;
+
+    // Non-copyable
+    rowset_batch(rowset_batch const &);
+    rowset_batch & operator=(rowset_batch const &);
+
+}; // class rowset_batch<row>
+
+} // namespace details
+
 //
 // rowset iterator of input category.
 //
@@ -35,11 +204,11 @@ public:
     // Constructors
 
     rowset_iterator()
-        : st_(0), define_(0)
+        : st_(0), define_(0), batch_(0)
     {}
 
     rowset_iterator(statement & st, T & define)
-        : st_(&st), define_(&define)
+        : st_(&st), define_(&define), batch_(0)
     {
         assert(0 != st_);
         assert(0 != define_);
@@ -48,6 +217,16 @@ public:
         // Fetch first row to properly initialize iterator
         ++(*this);
     }
+
+    rowset_iterator(statement & st, details::rowset_batch<T> & batch)
+        : st_(&st), define_(0), batch_(&batch)
+    {
+        assert(0 != st_);
+        assert(0 != st_->get_backend());
+
+        // Fetch first row to properly initialize iterator
+        ++(*this);
+    }
     
     // Access operators
     
@@ -65,13 +244,19 @@ public:
 
     rowset_iterator & operator++()
     {
-        // Fetch next row from dataset
-        
-        if (st_->fetch() == false)
+        // Fetch next row from dataset, or take it from the current batch
+
+        bool const gotData = batch_ != 0 ? batch_->next() : st_->fetch();
+        if (gotData == false)
         {
             // Set iterator to non-derefencable state (pass-the-end)
             st_ = 0;
             define_ = 0;
+            batch_ = 0;
+        }
+        else if (batch_ != 0)
+        {
+            define_ = &batch_->current();
         }
 
         return (*this);
@@ -100,6 +285,7 @@ private:
 
     statement * st_;
     T * define_;
+    details::rowset_batch<T> * batch_;
 
 }; // class rowset_iterator
 
@@ -116,13 +302,22 @@ public:
 
     typedef rowset_iterator<T> iterator;
 
-    rowset_impl(details::prepare_temp_type const & prep)
+    rowset_impl(details::prepare_temp_type const & prep,
+        std::size_t batchSize = 1)
         : refs_(1), st_(new statement(prep)), define_(new T())
     {
         assert(0 != st_.get());
         assert(0 != define_.get());
 
-        st_->exchange_for_rowset(into(*define_));
+        if (batchSize > 1)
+        {
+            exchange(batchSize, typename rowset_traits<T>::fetch_type());
+        }
+        else
+        {
+            st_->exchange_for_rowset(into(*define_));
+        }
+
         st_->execute();
     }
 
@@ -142,6 +337,11 @@ public:
     iterator begin() const
     {
         // No ownership transfer occurs here
+        if (0 != batch_.get())
+        {
+            return iterator(*st_, *batch_);
+        }
+
         return iterator(*st_, *define_);
     }
 
@@ -152,10 +352,22 @@ public:
 
 private:
 
+    void exchange(std::size_t batchSize, rowset_bulk_tag)
+    {
+        batch_.reset(new rowset_batch<T>(*st_, batchSize));
+    }
+
+    void exchange(std::size_t, rowset_single_tag)
+    {
+        // this type can't be fetched in bulk, fall back to single rows
+        st_->exchange_for_rowset(into(*define_));
+    }
+
     unsigned int refs_;
 
     const std::auto_ptr<statement> st_;
     const std::auto_ptr<T> define_;
+    std::auto_ptr<rowset_batch<T> > batch_;
 
     // Non-copyable
     rowset_impl(rowset_impl const &);
@@ -187,6 +399,14 @@ public:
         assert(0 != pimpl_);
     }
 
+    // the rows are fetched from the database in batches of the given size
+    // (if the type T can be fetched in bulk, otherwise one by one)
+    rowset(details::prepare_temp_type const& prep, std::size_t batchSize)
+        : pimpl_(new details::rowset_impl<T>(prep, batchSize))
+    {
+        assert(0 != pimpl_);
+    }
+
     rowset(rowset const & other)
         : pimpl_(other.pimpl_)
     {
@@ -33,54 +33,60 @@ void ensureConnected(session_backend * backEnd)
 } // namespace anonymous
 
 session::session()
-    : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
+    : once(this), prepare(this), query_transformation_(NULL),
+      queryStreamUsed_(false), logStream_(NULL),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      spareOnceStatement_(NULL), isFromPool_(false), pool_(NULL)
 {
 }
 
 session::session(connection_parameters const & parameters)
-    : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
+    : once(this), prepare(this), query_transformation_(NULL),
+      queryStreamUsed_(false), logStream_(NULL),
       lastConnectParameters_(parameters),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      spareOnceStatement_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
 
 session::session(backend_factory const & factory,
     std::string const & connectString)
-    : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
+    : once(this), prepare(this), query_transformation_(NULL),
+      queryStreamUsed_(false), logStream_(NULL),
       lastConnectParameters_(factory, connectString),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      spareOnceStatement_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
 
 session::session(std::string const & backendName,
     std::string const & connectString)
-    : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
+    : once(this), prepare(this), query_transformation_(NULL),
+      queryStreamUsed_(false), logStream_(NULL),
       lastConnectParameters_(backendName, connectString),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      spareOnceStatement_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
 
 session::session(std::string const & connectString)
-    : once(this), prepare(this), query_transformation_(NULL), logStream_(NULL),
+    : once(this), prepare(this), query_transformation_(NULL),
+      queryStreamUsed_(false), logStream_(NULL),
       lastConnectParameters_(connectString),
       uppercaseColumnNames_(false), backEnd_(NULL),
-      isFromPool_(false), pool_(NULL)
+      spareOnceStatement_(NULL), isFromPool_(false), pool_(NULL)
 {
     open(lastConnectParameters_);
 }
 
-session::session(connection_pool & pool)
-    : query_transformation_(NULL), logStream_(NULL), isFromPool_(true), pool_(&pool)
+session::session(connection_pool & pool, int priority)
+    : query_transformation_(NULL), queryStreamUsed_(false), logStream_(NULL),
+      spareOnceStatement_(NULL), isFromPool_(true), pool_(&pool)
 {
-    poolPosition_ = pool.lease();
+    poolPosition_ = pool.lease(priority);
     session & pooledSession = pool.at(poolPosition_);
 
     once.set_session(&pooledSession);
@@ -97,6 +103,16 @@ session::~session()
     else
     {
         delete query_transformation_;
+        delete spareOnceStatement_;
+        for (std::size_t i = 0; i != spareIntoElements_.size(); ++i)
+        {
+            delete spareIntoElements_[i];
+        }
+        for (std::size_t i = 0; i != spareUseElements_.size(); ++i)
+        {
+            delete spareUseElements_[i];
+        }
+        statementCache_.clear();
         delete backEnd_;
     }
 }
@@ -151,6 +167,9 @@ void session::close()
     }
     else
     {
+        // cached statements can't outlive the connection they belong to
+        statementCache_.clear();
+
         delete backEnd_;
         backEnd_ = NULL;
     }
@@ -209,6 +228,14 @@ std::ostringstream & session::get_query_stream()
     }
     else
     {
+        if (queryStreamUsed_ == false)
+        {
+            // from now on the whole query is accumulated in the stream
+            query_stream_ << queryText_;
+            queryText_.clear();
+            queryStreamUsed_ = true;
+        }
+
         return query_stream_;
     }
 }
@@ -221,16 +248,85 @@ std::string session::get_query() const
     }
     else
     {
-        // preserve logical constness of get_query,
-        // stream used as read-only here, 
-        session* pthis = const_cast<session*>(this);
+        std::string const query =
+            queryStreamUsed_ ? query_stream_.str() : queryText_;
 
         // sole place where any user-defined query transformation is applied
         if (query_transformation_)
         {
-            return (*query_transformation_)(pthis->get_query_stream().str());
+            return (*query_transformation_)(query);
         }
-        return pthis->get_query_stream().str();
+        return query;
+    }
+}
+
+void session::reset_query()
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).reset_query();
+    }
+    else
+    {
+        // the string keeps its capacity, so that the next query of similar
+        // size can be accumulated without any memory allocations
+        queryText_.clear();
+
+        if (queryStreamUsed_)
+        {
+            query_stream_.str("");
+            queryStreamUsed_ = false;
+        }
+    }
+}
+
+void session::append_query(char const * text)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).append_query(text);
+    }
+    else if (queryStreamUsed_)
+    {
+        query_stream_ << text;
+    }
+    else
+    {
+        queryText_ += text;
+    }
+}
+
+void session::append_query(std::string const & text)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).append_query(text);
+    }
+    else if (queryStreamUsed_)
+    {
+        query_stream_ << text;
+    }
+    else
+    {
+        queryText_ += text;
+    }
+}
+
+std::string const & session::get_query_text()
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_query_text();
+    }
+    else
+    {
+        if (queryStreamUsed_ == false && query_transformation_ == NULL)
+        {
+            return queryText_;
+        }
+
+        transformedQuery_ = get_query();
+        return transformedQuery_;
     }
 }
 
@@ -370,6 +466,202 @@ std::string session::get_backend_name() const
     return backEnd_->get_backend_name();
 }
 
+void session::set_statement_cache_size(std::size_t size)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).set_statement_cache_size(size);
+    }
+    else
+    {
+        statementCache_.set_max_size(size);
+    }
+}
+
+std::size_t session::get_statement_cache_size() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_size();
+    }
+    else
+    {
+        return statementCache_.get_max_size();
+    }
+}
+
+std::size_t session::get_statement_cache_hits() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_hits();
+    }
+    else
+    {
+        return statementCache_.get_hits();
+    }
+}
+
+std::size_t session::get_statement_cache_misses() const
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).get_statement_cache_misses();
+    }
+    else
+    {
+        return statementCache_.get_misses();
+    }
+}
+
+statement_backend * session::take_cached_statement_backend(
+    std::string const & query, spare_element_backends & spares)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).take_cached_statement_backend(
+            query, spares);
+    }
+    else
+    {
+        ensureConnected(backEnd_);
+
+        return statementCache_.take(query, spares);
+    }
+}
+
+void session::cache_statement_backend(std::string const & query,
+    statement_backend * backEnd, spare_element_backends & spares)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).cache_statement_backend(
+            query, backEnd, spares);
+    }
+    else
+    {
+        statementCache_.put(query, backEnd, spares);
+    }
+}
+
+ref_counted_statement * session::acquire_once_statement()
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).acquire_once_statement();
+    }
+    else
+    {
+        if (spareOnceStatement_ != NULL)
+        {
+            ref_counted_statement * const st = spareOnceStatement_;
+            spareOnceStatement_ = NULL;
+
+            // the reference count dropped to zero when it was released
+            st->inc_ref();
+            return st;
+        }
+
+        return new ref_counted_statement(*this);
+    }
+}
+
+void session::release_once_statement(ref_counted_statement * st)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).release_once_statement(st);
+    }
+    else if (spareOnceStatement_ == NULL)
+    {
+        // the statement was already cleaned up by its final action
+        spareOnceStatement_ = st;
+    }
+    else
+    {
+        // this can only happen with nested "once" statements
+        delete st;
+    }
+}
+
+pooled_into_type * session::acquire_into_element(void * data,
+    exchange_type type, indicator * ind)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).acquire_into_element(data, type, ind);
+    }
+    else if (spareIntoElements_.empty())
+    {
+        return new pooled_into_type(data, type, ind);
+    }
+    else
+    {
+        pooled_into_type * const p = spareIntoElements_.back();
+        spareIntoElements_.pop_back();
+        p->set_target(data, type, ind);
+        return p;
+    }
+}
+
+void session::release_into_element(pooled_into_type * p)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).release_into_element(p);
+        return;
+    }
+
+    try
+    {
+        spareIntoElements_.push_back(p);
+    }
+    catch (...)
+    {
+        delete p;
+    }
+}
+
+pooled_use_type * session::acquire_use_element(void * data,
+    exchange_type type, indicator * ind, bool readOnly,
+    std::string const & name)
+{
+    if (isFromPool_)
+    {
+        return pool_->at(poolPosition_).acquire_use_element(
+            data, type, ind, readOnly, name);
+    }
+    else if (spareUseElements_.empty())
+    {
+        return new pooled_use_type(data, type, ind, readOnly, name);
+    }
+    else
+    {
+        pooled_use_type * const p = spareUseElements_.back();
+        p->set_target(data, type, ind, readOnly, name);
+        spareUseElements_.pop_back();
+        return p;
+    }
+}
+
+void session::release_use_element(pooled_use_type * p)
+{
+    if (isFromPool_)
+    {
+        pool_->at(poolPosition_).release_use_element(p);
+        return;
+    }
+
+    try
+    {
+        spareUseElements_.push_back(p);
+    }
+    catch (...)
+    {
+        delete p;
+    }
+}
+
 statement_backend * session::make_statement_backend()
 {
     ensureConnected(backEnd_);
@@ -11,6 +11,7 @@
 #include "once-temp-type.h"
 #include "query_transformation.h"
 #include "connection-parameters.h"
+#include "statement-cache.h"
 
 // std
 #include <cstddef>
@@ -18,6 +19,7 @@
 #include <ostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace soci
 {
@@ -29,6 +31,9 @@ namespace details
 
 class session_backend;
 class statement_backend;
+class ref_counted_statement;
+class pooled_into_type;
+class pooled_use_type;
 class rowid_backend;
 class blob_backend;
 
@@ -48,7 +53,7 @@ public:
     session(backend_factory const & factory, std::string const & connectString);
     session(std::string const & backendName, std::string const & connectString);
     explicit session(std::string const & connectString);
-    explicit session(connection_pool & pool);
+    explicit session(connection_pool & pool, int priority = 0);
 
     ~session();
 
@@ -74,6 +79,17 @@ public:
     std::ostringstream & get_query_stream();
     std::string get_query() const;
 
+    // used by once and prepare to build the query text, the string parts of
+    // the query are accumulated directly while everything else is formatted
+    // with the query stream
+    void reset_query();
+    void append_query(char const * text);
+    void append_query(std::string const & text);
+
+    // same as get_query() but avoids copying the query text when possible,
+    // the returned reference is valid until the next query is started
+    std::string const & get_query_text();
+
     template <typename T>
     void set_query_transformation(T callback)
     {
@@ -118,10 +134,41 @@ public:
 
     std::string get_backend_name() const;
 
+    // Prepared statements cache: when its size is set to a non-zero value,
+    // the statements executed in this session are kept prepared after use
+    // (up to the given number, least recently used ones are dropped first)
+    // and reused when the same query text is executed again.
+    void set_statement_cache_size(std::size_t size);
+    std::size_t get_statement_cache_size() const;
+    std::size_t get_statement_cache_hits() const;
+    std::size_t get_statement_cache_misses() const;
+
     details::statement_backend * make_statement_backend();
     details::rowid_backend * make_rowid_backend();
     details::blob_backend * make_blob_backend();
 
+    // used by statements to take and give back the cached backends
+    details::statement_backend * take_cached_statement_backend(
+        std::string const & query, details::spare_element_backends & spares);
+    void cache_statement_backend(std::string const & query,
+        details::statement_backend * backEnd,
+        details::spare_element_backends & spares);
+
+    // used by "once" statements, the same statement object is reused for
+    // all of them instead of being allocated for each query
+    details::ref_counted_statement * acquire_once_statement();
+    void release_once_statement(details::ref_counted_statement * st);
+
+    // used by into_type_ptr and use_type_ptr, the single elements of the
+    // basic types are reused by all the statements of the session
+    details::pooled_into_type * acquire_into_element(void * data,
+        details::exchange_type type, indicator * ind);
+    void release_into_element(details::pooled_into_type * p);
+    details::pooled_use_type * acquire_use_element(void * data,
+        details::exchange_type type, indicator * ind, bool readOnly,
+        std::string const & name);
+    void release_use_element(details::pooled_use_type * p);
+
 private:
     session(session const &);
     session& operator=(session const &);
@@ -129,6 +176,13 @@ private:
     std::ostringstream query_stream_;
     details::query_transformation_function* query_transformation_;
 
+    // the query text accumulated so far, unless the query stream is used
+    std::string queryText_;
+    bool queryStreamUsed_;
+
+    // the result of the query transformation, see get_query_text()
+    std::string transformedQuery_;
+
     std::ostream * logStream_;
     std::string lastQuery_;
 
@@ -138,6 +192,14 @@ private:
 
     details::session_backend * backEnd_;
 
+    details::statement_cache statementCache_;
+
+    details::ref_counted_statement * spareOnceStatement_;
+
+    // there are never more of them than the elements used at the same time
+    std::vector<details::pooled_into_type *> spareIntoElements_;
+    std::vector<details::pooled_use_type *> spareUseElements_;
+
     bool gotData_;
 
     bool isFromPool_;
@@ -151,6 +151,7 @@ class statement_backend
 {
 public:
     statement_backend() {}
+
     virtual ~statement_backend() {}
 
     virtual void alloc() = 0;
@@ -181,6 +182,25 @@ public:
     virtual vector_into_type_backend* make_vector_into_type_backend() = 0;
     virtual vector_use_type_backend* make_vector_use_type_backend() = 0;
 
+    // Called when the statement is kept in the session statement cache to
+    // be reused for another execution of the same query, after all its into
+    // and use elements were cleaned up. The backend should forget everything
+    // related to them but keep the prepared statement itself. Backends which
+    // can't reuse their statements in this way return false and are then
+    // simply not cached.
+    virtual bool reset_for_reuse() { return false; }
+
+    // Called when the backend of a single into or use element, left over by
+    // a previous execution of the statement reused from the cache, is given
+    // to a new element instead of one created by make_into_type_backend()
+    // or make_use_type_backend(). The element backends must not keep any
+    // state between their uses, but the statement may need to remember that
+    // it has such elements again.
+    virtual void reuse_into_type_backend(
+        standard_into_type_backend* /* backEnd */) {}
+    virtual void reuse_use_type_backend(
+        standard_use_type_backend* /* backEnd */) {}
+
 private:
     // noncopyable
     statement_backend(statement_backend const&);
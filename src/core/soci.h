@@ -19,6 +19,7 @@
 #include "connection-pool.h"
 #include "error.h"
 #include "exchange-traits.h"
+#include "executor.h"
 #include "into.h"
 #include "into-type.h"
 #include "once-temp-type.h"
@@ -0,0 +1,157 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#define SOCI_SOURCE
+#include "statement-cache.h"
+#include "soci-backend.h"
+
+using namespace soci;
+using namespace soci::details;
+
+void spare_element_backends::swap(spare_element_backends & other)
+{
+    intos_.swap(other.intos_);
+    uses_.swap(other.uses_);
+}
+
+void spare_element_backends::clear()
+{
+    for (std::size_t i = 0; i != intos_.size(); ++i)
+    {
+        delete intos_[i];
+    }
+    intos_.clear();
+
+    for (std::size_t i = 0; i != uses_.size(); ++i)
+    {
+        delete uses_[i];
+    }
+    uses_.clear();
+}
+
+statement_cache::statement_cache()
+    : maxSize_(0), hits_(0), misses_(0)
+{
+}
+
+statement_cache::~statement_cache()
+{
+    clear();
+}
+
+void statement_cache::set_max_size(std::size_t maxSize)
+{
+    maxSize_ = maxSize;
+    evict(maxSize_);
+}
+
+statement_backend * statement_cache::take(std::string const & query,
+    spare_element_backends & spares)
+{
+    index_type::iterator const it = index_.find(query);
+    if (it == index_.end() || it->second->backEnd_ == NULL)
+    {
+        ++misses_;
+        return NULL;
+    }
+
+    ++hits_;
+
+    // the entry itself is kept in place while its backend is in use, so
+    // that giving it back later doesn't need to allocate anything
+    entries_type::iterator const pos = it->second;
+    statement_backend * const backEnd = pos->backEnd_;
+    pos->backEnd_ = NULL;
+    spares.swap(pos->spares_);
+    entries_.splice(entries_.begin(), entries_, pos);
+
+    return backEnd;
+}
+
+void statement_cache::put(std::string const & query,
+    statement_backend * backEnd, spare_element_backends & spares)
+{
+    index_type::iterator const it = index_.find(query);
+
+    if (maxSize_ == 0 || backEnd->reset_for_reuse() == false)
+    {
+        if (it != index_.end() && it->second->backEnd_ == NULL)
+        {
+            entries_.erase(it->second);
+            index_.erase(it);
+        }
+
+        destroy(backEnd, spares);
+        return;
+    }
+
+    if (it != index_.end())
+    {
+        if (it->second->backEnd_ != NULL)
+        {
+            // the same query was used by two statements at the same time,
+            // keeping one prepared backend for it is enough
+            destroy(backEnd, spares);
+            return;
+        }
+
+        it->second->backEnd_ = backEnd;
+        it->second->spares_.swap(spares);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    evict(maxSize_ - 1);
+
+    entries_.push_front(entry());
+    entry & added = entries_.front();
+    added.query_ = query;
+    added.backEnd_ = backEnd;
+    added.spares_.swap(spares);
+    index_[query] = entries_.begin();
+}
+
+void statement_cache::clear()
+{
+    evict(0);
+}
+
+void statement_cache::evict(std::size_t maxSize)
+{
+    while (entries_.size() > maxSize)
+    {
+        entry & last = entries_.back();
+
+        // the backends which are currently in use are not owned by the cache
+        if (last.backEnd_ != NULL)
+        {
+            destroy(last.backEnd_, last.spares_);
+        }
+
+        index_.erase(last.query_);
+        entries_.pop_back();
+    }
+}
+
+void statement_cache::destroy(statement_backend * backEnd,
+    spare_element_backends & spares)
+{
+    // the element backends refer to the statement backend
+    spares.clear();
+
+    try
+    {
+        backEnd->clean_up();
+    }
+    catch (...)
+    {
+        // there is nobody to report the error to, the statement which used
+        // this backend has already completed successfully
+    }
+
+    delete backEnd;
+}
@@ -0,0 +1,117 @@
+//
+// Copyright (C) 2004-2008 Maciej Sobczak, Stephen Hutton
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_STATEMENT_CACHE_H_INCLUDED
+#define SOCI_STATEMENT_CACHE_H_INCLUDED
+
+#include "soci-config.h"
+// std
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace soci
+{
+
+namespace details
+{
+
+class statement_backend;
+class standard_into_type_backend;
+class standard_use_type_backend;
+
+// The backends of the single into and use elements of a statement kept in
+// the cache, already cleaned up. They are kept together with the statement
+// backend and reused by the next execution of the same query instead of
+// being allocated again, so they must not keep any state between their uses.
+struct SOCI_DECL spare_element_backends
+{
+    std::vector<standard_into_type_backend *> intos_;
+    std::vector<standard_use_type_backend *> uses_;
+
+    bool empty() const { return intos_.empty() && uses_.empty(); }
+    void swap(spare_element_backends & other);
+
+    // Destroy all the backends.
+    void clear();
+};
+
+// LRU cache of prepared statement backends, indexed by the query text.
+//
+// The backends are "checked out" of the cache by the statements using them
+// and put back when these statements are done, so that a cached backend is
+// never shared by two statements alive at the same time. The entry of a
+// checked out backend stays in the cache with a null pointer.
+class SOCI_DECL statement_cache
+{
+public:
+    statement_cache();
+    ~statement_cache();
+
+    // Setting the maximal size to 0 disables the cache.
+    void set_max_size(std::size_t maxSize);
+    std::size_t get_max_size() const { return maxSize_; }
+
+    std::size_t size() const { return entries_.size(); }
+
+    // Return the backend prepared for the given query, checking it out of
+    // the cache, or NULL if there is none available. The spare element
+    // backends kept with it are moved to the given object, which must be
+    // empty.
+    statement_backend * take(std::string const & query,
+        spare_element_backends & spares);
+
+    // Give back the backend prepared for the given query together with the
+    // spare backends of its elements, which are moved out of the given
+    // object. The cache takes ownership of all of them and destroys them if
+    // they can't be kept.
+    void put(std::string const & query, statement_backend * backEnd,
+        spare_element_backends & spares);
+
+    // Destroy all the cached backends.
+    void clear();
+
+    std::size_t get_hits() const { return hits_; }
+    std::size_t get_misses() const { return misses_; }
+
+private:
+    struct entry
+    {
+        entry() : backEnd_(NULL) {}
+
+        std::string query_;
+        statement_backend * backEnd_;
+        spare_element_backends spares_;
+    };
+
+    typedef std::list<entry> entries_type;
+    typedef std::map<std::string, entries_type::iterator> index_type;
+
+    void evict(std::size_t maxSize);
+    static void destroy(statement_backend * backEnd,
+        spare_element_backends & spares);
+
+    // the most recently used entries are at the front of the list
+    entries_type entries_;
+    index_type index_;
+
+    std::size_t maxSize_;
+    std::size_t hits_;
+    std::size_t misses_;
+
+    // noncopyable
+    statement_cache(statement_cache const &);
+    statement_cache & operator=(statement_cache const &);
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_STATEMENT_CACHE_H_INCLUDED
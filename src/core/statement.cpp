@@ -32,18 +32,28 @@ void statement::exchange(use_type_ptr const & u)
 }
 
 statement_impl::statement_impl(session & s)
-    : session_(s), refCount_(1), row_(0),
+    : session_(s), refCount_(1), row_(0), rowBatch_(0),
       fetchSize_(1), initialFetchSize_(1),
-      alreadyDescribed_(false)
+      alreadyDescribed_(false), backEnd_(NULL), backEndCached_(false)
 {
-    backEnd_ = s.make_statement_backend();
+    // when the statement cache is used, the backend is either taken from
+    // the cache or created only once the query is known, see prepare()
+    if (session_.get_statement_cache_size() == 0)
+    {
+        backEnd_ = s.make_statement_backend();
+    }
 }
 
 statement_impl::statement_impl(prepare_temp_type const & prep)
     : session_(prep.get_prepare_info()->session_),
-      refCount_(1), row_(0), fetchSize_(1), alreadyDescribed_(false)
+      refCount_(1), row_(0), rowBatch_(0), fetchSize_(1),
+      alreadyDescribed_(false),
+      backEnd_(NULL), backEndCached_(false)
 {
-    backEnd_ = session_.make_statement_backend();
+    if (session_.get_statement_cache_size() == 0)
+    {
+        backEnd_ = session_.make_statement_backend();
+    }
 
     ref_counted_prepare_info * prepInfo = prep.get_prepare_info();
 
@@ -76,7 +86,11 @@ statement_impl::~statement_impl()
 
 void statement_impl::alloc()
 {
-    backEnd_->alloc();
+    // if there is no backend yet, it will be allocated by prepare()
+    if (backEnd_ != NULL)
+    {
+        backEnd_->alloc();
+    }
 }
 
 void statement_impl::bind(values & values)
@@ -153,13 +167,13 @@ void statement_impl::bind(values & values)
 
 void statement_impl::exchange(into_type_ptr const & i)
 {
-    intos_.push_back(i.get());
+    intos_.push_back(i.get(session_));
     i.release();
 }
 
 void statement_impl::exchange_for_row(into_type_ptr const & i)
 {
-    intosForRow_.push_back(i.get());
+    intosForRow_.push_back(i.get(session_));
     i.release();
 }
 
@@ -170,7 +184,7 @@ void statement_impl::exchange_for_rowset(into_type_ptr const & i)
         throw soci_error("Explicit into elements not allowed with rowset.");
     }
 
-    into_type_base* p = i.get();
+    into_type_base* p = i.get(session_);
     intos_.push_back(p);
     i.release();
 
@@ -181,7 +195,7 @@ void statement_impl::exchange_for_rowset(into_type_ptr const & i)
 
 void statement_impl::exchange(use_type_ptr const & u)
 {
-    uses_.push_back(u.get());
+    uses_.push_back(u.get(session_));
     u.release();
 }
 
@@ -192,7 +206,8 @@ void statement_impl::clean_up()
     for (std::size_t i = isize; i != 0; --i)
     {
         intos_[i - 1]->clean_up();
-        delete intos_[i - 1];
+        intos_[i - 1]->release_backend(*this);
+        intos_[i - 1]->destroy(*this);
         intos_.resize(i - 1);
     }
 
@@ -200,7 +215,8 @@ void statement_impl::clean_up()
     for (std::size_t i = ifrsize; i != 0; --i)
     {
         intosForRow_[i - 1]->clean_up();
-        delete intosForRow_[i - 1];
+        intosForRow_[i - 1]->release_backend(*this);
+        intosForRow_[i - 1]->destroy(*this);
         intosForRow_.resize(i - 1);
     }
 
@@ -208,7 +224,8 @@ void statement_impl::clean_up()
     for (std::size_t i = usize; i != 0; --i)
     {
         uses_[i - 1]->clean_up();
-        delete uses_[i - 1];
+        uses_[i - 1]->release_backend(*this);
+        uses_[i - 1]->destroy(*this);
         uses_.resize(i - 1);
     }
 
@@ -218,24 +235,93 @@ void statement_impl::clean_up()
         delete indicators_[i];
         indicators_[i] = NULL;
     }
+    indicators_.clear();
 
-    if (backEnd_ != NULL)
-    {
-        backEnd_->clean_up();
-        delete backEnd_;
-        backEnd_ = NULL;
-    }
+    // the statement can be reused for another query after this
+    row_ = NULL;
+    rowBatch_ = NULL;
+    alreadyDescribed_ = false;
+
+    release_backend();
 }
 
 void statement_impl::prepare(std::string const & query,
     statement_type eType)
 {
+    if (backEndCached_)
+    {
+        // the statement is being re-prepared with a different query,
+        // the backend prepared for the old one can be reused by others
+        release_backend();
+    }
+
     query_ = query;
     session_.log_query(query);
 
+    if (session_.get_statement_cache_size() != 0)
+    {
+        statement_backend * const cached =
+            session_.take_cached_statement_backend(query,
+                spareElementBackends_);
+        if (cached != NULL)
+        {
+            release_backend();
+
+            backEnd_ = cached;
+            backEndCached_ = true;
+            return;
+        }
+
+        if (backEnd_ == NULL)
+        {
+            make_backend();
+        }
+
+        // the statement is going to be kept for reuse, so prepare it as
+        // such even if it is executed only once right now
+        backEnd_->prepare(query, st_repeatable_query);
+        backEndCached_ = true;
+        return;
+    }
+
+    if (backEnd_ == NULL)
+    {
+        make_backend();
+    }
+
     backEnd_->prepare(query, eType);
 }
 
+void statement_impl::make_backend()
+{
+    backEnd_ = session_.make_statement_backend();
+    backEnd_->alloc();
+}
+
+void statement_impl::release_backend()
+{
+    if (backEnd_ == NULL)
+    {
+        return;
+    }
+
+    if (backEndCached_)
+    {
+        statement_backend * const backEnd = backEnd_;
+        backEnd_ = NULL;
+        backEndCached_ = false;
+
+        session_.cache_statement_backend(query_, backEnd,
+            spareElementBackends_);
+    }
+    else
+    {
+        backEnd_->clean_up();
+        delete backEnd_;
+        backEnd_ = NULL;
+    }
+}
+
 void statement_impl::define_and_bind()
 {
     int definePosition = 1;
@@ -320,7 +406,7 @@ bool statement_impl::execute(bool withDataExchange)
     // and *before* the into elements are touched, so that the row
     // description process can inject more into elements for
     // implicit data exchange
-    if (row_ != NULL && alreadyDescribed_ == false)
+    if ((row_ != NULL || rowBatch_ != NULL) && alreadyDescribed_ == false)
     {
         describe();
         define_for_row();
@@ -601,44 +687,51 @@ namespace details
 // Map data_types to stock types for dynamic result set support
 
 template<>
-void statement_impl::bind_into<dt_string>()
+void statement_impl::bind_into<dt_string>(std::size_t pos)
 {
-    into_row<std::string>();
+    into_row<std::string>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_double>()
+void statement_impl::bind_into<dt_double>(std::size_t pos)
 {
-    into_row<double>();
+    into_row<double>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_integer>()
+void statement_impl::bind_into<dt_integer>(std::size_t pos)
 {
-    into_row<int>();
+    into_row<int>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_long_long>()
+void statement_impl::bind_into<dt_long_long>(std::size_t pos)
 {
-    into_row<long long>();
+    into_row<long long>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_unsigned_long_long>()
+void statement_impl::bind_into<dt_unsigned_long_long>(std::size_t pos)
 {
-    into_row<unsigned long long>();
+    into_row<unsigned long long>(pos);
 }
 
 template<>
-void statement_impl::bind_into<dt_date>()
+void statement_impl::bind_into<dt_date>(std::size_t pos)
 {
-    into_row<std::tm>();
+    into_row<std::tm>(pos);
 }
 
 void statement_impl::describe()
 {
-    row_->clean_up();
+    if (row_ != NULL)
+    {
+        row_->clean_up();
+    }
+    else
+    {
+        rowBatch_->clean_up();
+    }
 
     int const numcols = backEnd_->prepare_for_describe();
     for (int i = 1; i <= numcols; ++i)
@@ -655,22 +748,11 @@ void statement_impl::describe()
         switch (dtype)
         {
         case dt_string:
-            bind_into<dt_string>();
-            break;
         case dt_double:
-            bind_into<dt_double>();
-            break;
         case dt_integer:
-            bind_into<dt_integer>();
-            break;
         case dt_long_long:
-            bind_into<dt_long_long>();
-            break;
         case dt_unsigned_long_long:
-            bind_into<dt_unsigned_long_long>();
-            break;
         case dt_date:
-            bind_into<dt_date>();
             break;
         default:
             std::ostringstream msg;
@@ -678,18 +760,94 @@ void statement_impl::describe()
                 <<" not supported for dynamic selects"<<std::endl;
             throw soci_error(msg.str());
         }
-        row_->add_properties(props);
+
+        if (row_ != NULL)
+        {
+            row_->add_properties(props);
+        }
+        else
+        {
+            rowBatch_->add_properties(props);
+        }
+    }
+
+    if (rowBatch_ != NULL)
+    {
+        define_for_row_batch();
+        alreadyDescribed_ = true;
+        return;
+    }
+
+    // the values of all the columns are kept in a single buffer,
+    // so they can only be bound once it is allocated
+    row_->alloc_values();
+
+    std::size_t const rsize = row_->size();
+    for (std::size_t i = 0; i != rsize; ++i)
+    {
+        switch (row_->get_properties(i).get_data_type())
+        {
+        case dt_string:
+            bind_into<dt_string>(i);
+            break;
+        case dt_double:
+            bind_into<dt_double>(i);
+            break;
+        case dt_integer:
+            bind_into<dt_integer>(i);
+            break;
+        case dt_long_long:
+            bind_into<dt_long_long>(i);
+            break;
+        case dt_unsigned_long_long:
+            bind_into<dt_unsigned_long_long>(i);
+            break;
+        case dt_date:
+            bind_into<dt_date>(i);
+            break;
+        }
     }
 
     alreadyDescribed_ = true;
 }
 
+void statement_impl::define_for_row_batch()
+{
+    rowBatch_->alloc_columns();
+
+    std::size_t const csize = rowBatch_->get_number_of_columns();
+    for (std::size_t i = 0; i != csize; ++i)
+    {
+        switch (rowBatch_->get_properties(i).get_data_type())
+        {
+        case dt_string:
+            into_row_batch<std::string>(i);
+            break;
+        case dt_double:
+            into_row_batch<double>(i);
+            break;
+        case dt_integer:
+            into_row_batch<int>(i);
+            break;
+        case dt_long_long:
+            into_row_batch<long long>(i);
+            break;
+        case dt_unsigned_long_long:
+            into_row_batch<unsigned long long>(i);
+            break;
+        case dt_date:
+            into_row_batch<std::tm>(i);
+            break;
+        }
+    }
+}
+
 } // namespace details
 } // namespace soci
 
 void statement_impl::set_row(row * r)
 {
-    if (row_ != NULL)
+    if (row_ != NULL || rowBatch_ != NULL)
     {
         throw soci_error(
             "Only one Row element allowed in a single statement.");
@@ -699,8 +857,25 @@ void statement_impl::set_row(row * r)
     row_->uppercase_column_names(session_.get_uppercase_column_names());
 }
 
+void statement_impl::set_row_batch(row_batch * rb)
+{
+    if (row_ != NULL || rowBatch_ != NULL)
+    {
+        throw soci_error(
+            "Only one Row element allowed in a single statement.");
+    }
+
+    rowBatch_ = rb;
+    rowBatch_->uppercase_column_names(session_.get_uppercase_column_names());
+}
+
 std::string statement_impl::rewrite_for_procedure_call(std::string const & query)
 {
+    if (backEnd_ == NULL)
+    {
+        make_backend();
+    }
+
     return backEnd_->rewrite_for_procedure_call(query);
 }
 
@@ -720,12 +895,32 @@ void statement_impl::dec_ref()
 standard_into_type_backend *
 statement_impl::make_into_type_backend()
 {
+    std::vector<standard_into_type_backend *> & spares =
+        spareElementBackends_.intos_;
+    if (spares.empty() == false)
+    {
+        standard_into_type_backend * const backEnd = spares.back();
+        spares.pop_back();
+        backEnd_->reuse_into_type_backend(backEnd);
+        return backEnd;
+    }
+
     return backEnd_->make_into_type_backend();
 }
 
 standard_use_type_backend *
 statement_impl::make_use_type_backend()
 {
+    std::vector<standard_use_type_backend *> & spares =
+        spareElementBackends_.uses_;
+    if (spares.empty() == false)
+    {
+        standard_use_type_backend * const backEnd = spares.back();
+        spares.pop_back();
+        backEnd_->reuse_use_type_backend(backEnd);
+        return backEnd;
+    }
+
     return backEnd_->make_use_type_backend();
 }
 
@@ -740,3 +935,42 @@ statement_impl::make_vector_use_type_backend()
 {
     return backEnd_->make_vector_use_type_backend();
 }
+
+void statement_impl::release_into_type_backend(
+    standard_into_type_backend * backEnd)
+{
+    // only the statements kept in the cache are executed again
+    if (backEndCached_ == false || backEnd_ == NULL)
+    {
+        delete backEnd;
+        return;
+    }
+
+    try
+    {
+        spareElementBackends_.intos_.push_back(backEnd);
+    }
+    catch (...)
+    {
+        delete backEnd;
+    }
+}
+
+void statement_impl::release_use_type_backend(
+    standard_use_type_backend * backEnd)
+{
+    if (backEndCached_ == false || backEnd_ == NULL)
+    {
+        delete backEnd;
+        return;
+    }
+
+    try
+    {
+        spareElementBackends_.uses_.push_back(backEnd);
+    }
+    catch (...)
+    {
+        delete backEnd;
+    }
+}
@@ -12,6 +12,7 @@
 #include "into.h"
 #include "use-type.h"
 #include "soci-backend.h"
+#include "statement-cache.h"
 #include "row.h"
 // std
 #include <cstddef>
@@ -54,6 +55,7 @@ public:
     bool fetch();
     void describe();
     void set_row(row * r);
+    void set_row_batch(row_batch * rb);
     void exchange_for_rowset(into_type_ptr const & i);
 
     // for diagnostics and advanced users
@@ -65,6 +67,11 @@ public:
     vector_into_type_backend * make_vector_into_type_backend();
     vector_use_type_backend * make_vector_use_type_backend();
 
+    // the backends released by the elements when the statement is cleaned
+    // up are reused if the statement backend is kept in the cache
+    void release_into_type_backend(standard_into_type_backend * backEnd);
+    void release_use_type_backend(standard_use_type_backend * backEnd);
+
     void inc_ref();
     void dec_ref();
 
@@ -82,6 +89,7 @@ private:
     int refCount_;
 
     row * row_;
+    row_batch * rowBatch_;
     std::size_t fetchSize_;
     std::size_t initialFetchSize_;
     std::string query_;
@@ -94,16 +102,28 @@ private:
     void define_for_row();
 
     template<typename T>
-    void into_row()
+    void into_row(std::size_t pos)
     {
-        T * t = new T();
-        indicator * ind = new indicator(i_ok);
-        row_->add_holder(t, ind);
-        exchange_for_row(into(*t, *ind));
+        exchange_for_row(into(row_->value_ref<T>(pos), row_->indicator_ref(pos)));
     }
 
     template<data_type>
-    void bind_into();
+    void bind_into(std::size_t pos);
+
+    template<typename T>
+    void into_row_batch(std::size_t pos)
+    {
+        into_type_ptr const i = into(rowBatch_->column_ref<T>(pos),
+            rowBatch_->indicators_ref(pos));
+
+        // the columns of the batch are bulk into elements, which are
+        // resized together with the other ones
+        intos_.push_back(i.get(session_));
+        i.release();
+        intos_.back()->define(*this, definePositionForRow_);
+    }
+
+    void define_for_row_batch();
 
     bool alreadyDescribed_;
 
@@ -118,6 +138,16 @@ private:
 
     soci::details::statement_backend * backEnd_;
 
+    // true if backEnd_ was prepared for use with the session statement cache
+    // and must be given back to it instead of being destroyed
+    bool backEndCached_;
+
+    // the element backends given back to the cache with backEnd_
+    spare_element_backends spareElementBackends_;
+
+    void make_backend();
+    void release_backend();
+
     // The type is noncopyable.
     statement_impl(statement_impl const &);
     statement_impl& operator=(statement_impl const &);
@@ -186,6 +216,7 @@ public:
 
     void describe()       { impl_->describe(); }
     void set_row(row * r) { impl_->set_row(r); }
+    void set_row_batch(row_batch * rb) { impl_->set_row_batch(rb); }
     void exchange_for_rowset(details::into_type_ptr const & i)
     {
         impl_->exchange_for_rowset(i);
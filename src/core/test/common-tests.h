@@ -342,6 +342,10 @@ public:
         test_prepared_insert_with_orm_type();
         test_issue154();
         test_placeholder_partial_matching_with_orm_type();
+        test_statement_cache();
+        test_statement_cache_with_connection_pool();
+        test_rowset_batch();
+        test_row_batch();
     }
 
 private:
@@ -2018,6 +2022,58 @@ void test12()
                 assert(t.tm_sec == 17);
                 assert(c == "a");
             }
+
+            // access through precomputed column handles
+            {
+                column_handle const num = r.get_handle("NUM_INT");
+                column_handle const name = r.get_handle(2);
+
+                assert(num.get_position() == 1);
+                assert(num.get_data_type() == dt_integer);
+                assert(name.get_position() == 2);
+
+                assert(r.get<int>(num) == 123);
+                assert(r.get<std::string>(name) == "Johny");
+                assert(r.get<std::string>(name, "") == "Johny");
+
+                caught = false;
+                try
+                {
+                    r.get<std::string>(num);
+                }
+                catch (std::bad_cast const &)
+                {
+                    caught = true;
+                }
+                assert(caught);
+            }
+        }
+
+        // column handles remain valid for all the rows of a rowset
+        {
+            sql << "insert into soci_test"
+                " values(2.72, 456, 'Mary',"
+                << tc_.to_date_time("2006-01-02 03:04:05")
+                << ", 'b')";
+
+            rowset<row> rs = (sql.prepare <<
+                "select * from soci_test order by num_int");
+
+            rowset<row>::const_iterator it = rs.begin();
+            column_handle const num = it->get_handle("NUM_INT");
+            column_handle const name = it->get_handle("NAME");
+
+            assert(it->get<int>(num) == 123);
+            assert(it->get<std::string>(name) == "Johny");
+
+            ++it;
+            assert(it->get<int>(num) == 456);
+            assert(it->get<std::string>(name) == "Mary");
+
+            ++it;
+            assert(it == rs.end());
+
+            sql << "delete from soci_test where num_int = 456";
         }
 
         // additional test to check if the row object can be
@@ -2701,6 +2757,153 @@ void test21()
     std::cout << "test 21 passed" << std::endl;
 }
 
+// test for reading rowset in batches
+void test_rowset_batch()
+{
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+    {
+        for (int i = 1; i <= 10; ++i)
+        {
+            sql << "insert into soci_test(id, str) values(:id, 'x')", use(i);
+        }
+
+        // the batch sizes which divide the number of rows and which don't
+        for (std::size_t batch = 2; batch <= 5; ++batch)
+        {
+            rowset<int> rs((sql.prepare <<
+                "select id from soci_test order by id asc"), batch);
+
+            int expected = 1;
+            for (rowset<int>::const_iterator it = rs.begin();
+                it != rs.end(); ++it)
+            {
+                assert(*it == expected);
+                ++expected;
+            }
+            assert(expected == 11);
+        }
+
+        {
+            rowset<std::string> rs((sql.prepare <<
+                "select str from soci_test"), 4);
+
+            std::size_t count = 0;
+            for (rowset<std::string>::const_iterator it = rs.begin();
+                it != rs.end(); ++it)
+            {
+                assert(*it == "x");
+                ++count;
+            }
+            assert(count == 10);
+        }
+
+        // no rows at all
+        {
+            rowset<int> rs((sql.prepare <<
+                "select id from soci_test where id > 100"), 4);
+            assert(rs.begin() == rs.end());
+        }
+
+        // dynamic rows are fetched in bulk too
+        {
+            sql << "update soci_test set str = NULL where id = 5";
+
+            rowset<row> rs((sql.prepare <<
+                "select id, str from soci_test order by id asc"), 4);
+
+            int expected = 1;
+            for (rowset<row>::const_iterator it = rs.begin();
+                it != rs.end(); ++it)
+            {
+                assert(it->size() == 2);
+                assert(it->get<int>(0) == expected);
+                if (expected == 5)
+                {
+                    assert(it->get_indicator(1) == i_null);
+                }
+                else
+                {
+                    assert(it->get_indicator(1) == i_ok);
+                    assert(it->get<std::string>(1) == "x");
+                }
+                ++expected;
+            }
+            assert(expected == 11);
+        }
+    }
+
+    std::cout << "test rowset batch passed" << std::endl;
+}
+
+// test for fetching dynamic rows in bulk
+void test_row_batch()
+{
+    session sql(backEndFactory_, connectString_);
+
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+    {
+        for (int i = 1; i <= 7; ++i)
+        {
+            double const d = i + 0.5;
+            sql << "insert into soci_test(id, d, str) values(:id, :d, 'x')",
+                use(i), use(d);
+        }
+        sql << "insert into soci_test(id) values(8)";
+
+        row_batch rb(3);
+        statement st = (sql.prepare <<
+            "select id, d, str from soci_test order by id asc", into(rb));
+        st.execute();
+
+        int expected = 1;
+        while (st.fetch())
+        {
+            assert(rb.get_number_of_columns() == 3);
+            assert(rb.size() == (expected < 7 ? 3u : 2u));
+
+            for (std::size_t i = 0; i != rb.size(); ++i)
+            {
+                assert(rb.get<int>(i, 0) == expected);
+                if (expected == 8)
+                {
+                    assert(rb.get_indicator(i, 1) == i_null);
+                    assert(rb.get<std::string>(i, 2, "null") == "null");
+                }
+                else
+                {
+                    assert(equal_approx(rb.get<double>(i, 1), expected + 0.5));
+                    assert(rb.get<std::string>(i, 2) == "x");
+                }
+
+                row r;
+                rb.get_row(i, r);
+                assert(r.size() == 3);
+                assert(r.get<int>(0) == expected);
+
+                ++expected;
+            }
+        }
+        assert(expected == 9);
+
+        // verify exception thrown on invalid get<>
+        bool caught = false;
+        try
+        {
+            rb.resize(1);
+            rb.get<std::string>(0, 0);
+        }
+        catch (std::bad_cast const &)
+        {
+            caught = true;
+        }
+        assert(caught);
+    }
+
+    std::cout << "test row batch passed" << std::endl;
+}
+
 // test for handling 'use' and reading rowset<std::string> using iterator
 void test22()
 {
@@ -3971,6 +4174,128 @@ void test_issue154()
     std::cout << "test issue-154 passed - check memory debugger output for leaks" << std::endl;
 }
 
+// test the session-level cache of prepared statements
+void run_statement_cache_test(session& sql)
+{
+    auto_table_creator tableCreator(tc_.table_creator_1(sql));
+
+    sql.set_statement_cache_size(2);
+
+    std::size_t const hits = sql.get_statement_cache_hits();
+    std::size_t const misses = sql.get_statement_cache_misses();
+
+    for (int i = 0; i != 10; ++i)
+    {
+        sql << "insert into soci_test(id) values(:id)", use(i);
+    }
+
+    if (sql.get_statement_cache_hits() == hits)
+    {
+        std::cout << "test statement_cache skipped (not supported by the backend)" << std::endl;
+        sql.set_statement_cache_size(0);
+        return;
+    }
+
+    assert(sql.get_statement_cache_hits() == hits + 9);
+    assert(sql.get_statement_cache_misses() == misses + 1);
+
+    // the cached statements must work with different into elements
+    int count = 0;
+    sql << "select count(*) from soci_test", into(count);
+    assert(count == 10);
+    long long llcount = 0;
+    sql << "select count(*) from soci_test", into(llcount);
+    assert(llcount == 10);
+
+    // prepared statements reuse the same cache
+    {
+        int id = 3;
+        int val = 0;
+        statement st = (sql.prepare <<
+            "select id from soci_test where id = :id", use(id), into(val));
+        st.execute(true);
+        assert(val == 3);
+    }
+    {
+        std::size_t const hitsBefore = sql.get_statement_cache_hits();
+
+        int id = 7;
+        int val = 0;
+        statement st = (sql.prepare <<
+            "select id from soci_test where id = :id", use(id), into(val));
+        st.execute(true);
+        assert(val == 7);
+
+        assert(sql.get_statement_cache_hits() == hitsBefore + 1);
+
+        // a second statement with the same query can't share the backend
+        int val2 = 0;
+        statement st2 = (sql.prepare <<
+            "select id from soci_test where id = :id", use(id), into(val2));
+        st2.execute(true);
+        assert(val2 == 7);
+    }
+
+    // a single use element with a vector into element, the backends of the
+    // elements are reused the second time
+    for (int i = 0; i != 2; ++i)
+    {
+        int limit = 5;
+        std::vector<int> ids(10);
+        sql << "select id from soci_test where id < :limit order by id",
+            use(limit), into(ids);
+        assert(ids.size() == 5);
+        for (int j = 0; j != 5; ++j)
+        {
+            assert(ids[j] == j);
+        }
+    }
+
+    // least recently used statements are evicted
+    {
+        std::size_t const missesBefore = sql.get_statement_cache_misses();
+
+        sql << "select count(*) from soci_test where id < 5", into(count);
+        assert(count == 5);
+        sql << "select count(*) from soci_test where id < 6", into(count);
+        assert(count == 6);
+        sql << "insert into soci_test(id) values(:id)", use(count);
+
+        assert(sql.get_statement_cache_misses() == missesBefore + 3);
+    }
+
+    sql.set_statement_cache_size(0);
+}
+
+void test_statement_cache()
+{
+    {
+        session sql(backEndFactory_, connectString_);
+        run_statement_cache_test(sql);
+    }
+    std::cout << "test statement_cache passed" << std::endl;
+}
+
+void test_statement_cache_with_connection_pool()
+{
+    {
+        const size_t pool_size = 2;
+        connection_pool pool(pool_size);
+
+        for (std::size_t i = 0; i != pool_size; ++i)
+        {
+            session & sql = pool.at(i);
+            sql.open(backEndFactory_, connectString_);
+        }
+
+        {
+            session sql(pool);
+            run_statement_cache_test(sql);
+        }
+    }
+    std::cout << "test statement_cache with connection pool passed" << std::endl;
+}
+
 }; // class common_tests
 
 } // namespace tests
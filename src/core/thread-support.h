@@ -0,0 +1,479 @@
+//
+// Copyright (C) 2008 Maciej Sobczak
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef SOCI_THREAD_SUPPORT_H_INCLUDED
+#define SOCI_THREAD_SUPPORT_H_INCLUDED
+
+// Thin layer over the threading primitives used by the connection pool and
+// the executor, this is not a part of the public interface.
+
+#include "error.h"
+// std
+#include <cstddef>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#ifdef __APPLE__
+#include <sys/time.h>
+#endif
+#else
+#include <Windows.h>
+#include <process.h>
+#endif
+
+namespace soci
+{
+
+namespace details
+{
+
+
+typedef void (*pool_thread_function)(void *);
+
+struct pool_thread_start
+{
+    pool_thread_function function_;
+    void * arg_;
+};
+
+#ifndef _WIN32
+// POSIX implementation
+
+// current time in milliseconds, measured by the same clock which is used
+// for the timed waits
+inline long long now_ms()
+{
+#ifdef __APPLE__
+    // there is no pthread_condattr_setclock() there
+    struct timeval tmv;
+    gettimeofday(&tmv, NULL);
+    return static_cast<long long>(tmv.tv_sec) * 1000 + tmv.tv_usec / 1000;
+#else
+    struct timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+    return static_cast<long long>(tm.tv_sec) * 1000 + tm.tv_nsec / 1000000;
+#endif
+}
+
+// current time in microseconds, for the statistics
+inline long long now_us()
+{
+#ifdef __APPLE__
+    struct timeval tmv;
+    gettimeofday(&tmv, NULL);
+    return static_cast<long long>(tmv.tv_sec) * 1000000 + tmv.tv_usec;
+#else
+    struct timespec tm;
+    clock_gettime(CLOCK_MONOTONIC, &tm);
+    return static_cast<long long>(tm.tv_sec) * 1000000 + tm.tv_nsec / 1000;
+#endif
+}
+
+class pool_mutex
+{
+public:
+    pool_mutex()
+    {
+        if (pthread_mutex_init(&mtx_, NULL) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~pool_mutex()
+    {
+        pthread_mutex_destroy(&mtx_);
+    }
+
+    void lock()
+    {
+        if (pthread_mutex_lock(&mtx_) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    void unlock()
+    {
+        pthread_mutex_unlock(&mtx_);
+    }
+
+    pthread_mutex_t mtx_;
+
+private:
+    // noncopyable
+    pool_mutex(pool_mutex const &);
+    pool_mutex & operator=(pool_mutex const &);
+};
+
+// Signal waited for by a single thread holding the pool mutex.
+class pool_signal
+{
+public:
+    pool_signal()
+    {
+        pthread_condattr_t attr;
+        if (pthread_condattr_init(&attr) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+
+#ifndef __APPLE__
+        // the timed waits are not affected by the changes of the system time
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+#endif
+
+        int const cc = pthread_cond_init(&cond_, &attr);
+        pthread_condattr_destroy(&attr);
+        if (cc != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~pool_signal()
+    {
+        pthread_cond_destroy(&cond_);
+    }
+
+    // Wait until signalled, or until the given deadline (as returned by
+    // now_ms(), negative for no deadline) and return false in this case.
+    // The wake-ups can be spurious.
+    bool wait(pool_mutex & mtx, long long deadline)
+    {
+        if (deadline < 0)
+        {
+            pthread_cond_wait(&cond_, &mtx.mtx_);
+            return true;
+        }
+
+        struct timespec tm;
+        tm.tv_sec = static_cast<time_t>(deadline / 1000);
+        tm.tv_nsec = static_cast<long>(deadline % 1000) * 1000 * 1000;
+
+        return pthread_cond_timedwait(&cond_, &mtx.mtx_, &tm) != ETIMEDOUT;
+    }
+
+    // must be called with the pool mutex locked
+    void signal()
+    {
+        pthread_cond_signal(&cond_);
+    }
+
+private:
+    pthread_cond_t cond_;
+
+    // noncopyable
+    pool_signal(pool_signal const &);
+    pool_signal & operator=(pool_signal const &);
+};
+
+// Value specific to the calling thread, 0 until it is set by this thread.
+class pool_thread_local
+{
+public:
+    pool_thread_local()
+    {
+        if (pthread_key_create(&key_, NULL) != 0)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~pool_thread_local()
+    {
+        pthread_key_delete(key_);
+    }
+
+    std::size_t get() const
+    {
+        return reinterpret_cast<std::size_t>(pthread_getspecific(key_));
+    }
+
+    void set(std::size_t value)
+    {
+        pthread_setspecific(key_, reinterpret_cast<void *>(value));
+    }
+
+private:
+    pthread_key_t key_;
+
+    // noncopyable
+    pool_thread_local(pool_thread_local const &);
+    pool_thread_local & operator=(pool_thread_local const &);
+};
+
+} // namespace details
+
+} // namespace soci
+
+extern "C"
+{
+
+static void * soci_pool_thread_entry(void * p)
+{
+    soci::details::pool_thread_start * const start =
+        static_cast<soci::details::pool_thread_start *>(p);
+    start->function_(start->arg_);
+    return NULL;
+}
+
+} // extern "C"
+
+namespace soci
+{
+
+namespace details
+{
+
+class pool_thread
+{
+public:
+    pool_thread() : started_(false) {}
+
+    // return false if the thread couldn't be created
+    bool start(pool_thread_function function, void * arg)
+    {
+        start_.function_ = function;
+        start_.arg_ = arg;
+        started_ = pthread_create(&id_, NULL,
+            soci_pool_thread_entry, &start_) == 0;
+        return started_;
+    }
+
+    void join()
+    {
+        if (started_)
+        {
+            pthread_join(id_, NULL);
+            started_ = false;
+        }
+    }
+
+private:
+    pool_thread_start start_;
+    pthread_t id_;
+    bool started_;
+};
+
+#else
+// Windows implementation
+
+inline long long now_ms()
+{
+    return static_cast<long long>(GetTickCount64());
+}
+
+inline long long now_us()
+{
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart / frequency.QuadPart * 1000000 +
+        counter.QuadPart % frequency.QuadPart * 1000000 / frequency.QuadPart;
+}
+
+class pool_mutex
+{
+public:
+    pool_mutex()
+    {
+        InitializeCriticalSection(&mtx_);
+    }
+
+    ~pool_mutex()
+    {
+        DeleteCriticalSection(&mtx_);
+    }
+
+    void lock()
+    {
+        EnterCriticalSection(&mtx_);
+    }
+
+    void unlock()
+    {
+        LeaveCriticalSection(&mtx_);
+    }
+
+    CRITICAL_SECTION mtx_;
+
+private:
+    // noncopyable
+    pool_mutex(pool_mutex const &);
+    pool_mutex & operator=(pool_mutex const &);
+};
+
+// Signal waited for by a single thread holding the pool mutex.
+class pool_signal
+{
+public:
+    pool_signal()
+    {
+        // auto-reset event, it stays signalled until the waiter gets it
+        event_ = CreateEvent(NULL, FALSE, FALSE, NULL);
+        if (event_ == NULL)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~pool_signal()
+    {
+        CloseHandle(event_);
+    }
+
+    bool wait(pool_mutex & mtx, long long deadline)
+    {
+        DWORD timeout = INFINITE;
+        if (deadline >= 0)
+        {
+            long long const now = now_ms();
+            timeout = deadline > now ? static_cast<DWORD>(deadline - now) : 0;
+        }
+
+        mtx.unlock();
+        DWORD const cc = WaitForSingleObject(event_, timeout);
+        mtx.lock();
+
+        if (cc == WAIT_FAILED)
+        {
+            throw soci_error("Synchronization error");
+        }
+
+        return cc != WAIT_TIMEOUT;
+    }
+
+    void signal()
+    {
+        SetEvent(event_);
+    }
+
+private:
+    HANDLE event_;
+
+    // noncopyable
+    pool_signal(pool_signal const &);
+    pool_signal & operator=(pool_signal const &);
+};
+
+// Value specific to the calling thread, 0 until it is set by this thread.
+class pool_thread_local
+{
+public:
+    pool_thread_local()
+    {
+        index_ = TlsAlloc();
+        if (index_ == TLS_OUT_OF_INDEXES)
+        {
+            throw soci_error("Synchronization error");
+        }
+    }
+
+    ~pool_thread_local()
+    {
+        TlsFree(index_);
+    }
+
+    std::size_t get() const
+    {
+        return reinterpret_cast<std::size_t>(TlsGetValue(index_));
+    }
+
+    void set(std::size_t value)
+    {
+        TlsSetValue(index_, reinterpret_cast<LPVOID>(value));
+    }
+
+private:
+    DWORD index_;
+
+    // noncopyable
+    pool_thread_local(pool_thread_local const &);
+    pool_thread_local & operator=(pool_thread_local const &);
+};
+
+} // namespace details
+
+} // namespace soci
+
+extern "C"
+{
+
+static unsigned __stdcall soci_pool_thread_entry(void * p)
+{
+    soci::details::pool_thread_start * const start =
+        static_cast<soci::details::pool_thread_start *>(p);
+    start->function_(start->arg_);
+    return 0;
+}
+
+} // extern "C"
+
+namespace soci
+{
+
+namespace details
+{
+
+class pool_thread
+{
+public:
+    pool_thread() : handle_(NULL) {}
+
+    bool start(pool_thread_function function, void * arg)
+    {
+        start_.function_ = function;
+        start_.arg_ = arg;
+        handle_ = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0,
+            soci_pool_thread_entry, &start_, 0, NULL));
+        return handle_ != NULL;
+    }
+
+    void join()
+    {
+        if (handle_ != NULL)
+        {
+            WaitForSingleObject(handle_, INFINITE);
+            CloseHandle(handle_);
+            handle_ = NULL;
+        }
+    }
+
+private:
+    pool_thread_start start_;
+    HANDLE handle_;
+};
+
+#endif // _WIN32
+
+class pool_lock
+{
+public:
+    explicit pool_lock(pool_mutex & mtx) : mtx_(mtx) { mtx_.lock(); }
+    ~pool_lock() { mtx_.unlock(); }
+
+private:
+    pool_mutex & mtx_;
+
+    // noncopyable
+    pool_lock(pool_lock const &);
+    pool_lock & operator=(pool_lock const &);
+};
+
+} // namespace details
+
+} // namespace soci
+
+#endif // SOCI_THREAD_SUPPORT_H_INCLUDED
@@ -7,8 +7,13 @@
 
 #ifndef SOCI_TYPE_HOLDER_H_INCLUDED
 #define SOCI_TYPE_HOLDER_H_INCLUDED
+
+#include "soci-backend.h"
 // std
-#include <typeinfo>
+#include <cstddef>
+#include <ctime>
+#include <new>
+#include <string>
 
 namespace soci
 {
@@ -16,51 +21,79 @@ namespace soci
 namespace details
 {
 
-// Base class holder + derived class type_holder for storing type data
-// instances in a container of holder objects
+// The values of a dynamic row are held in a single buffer of these units,
+// the union makes the buffer suitably aligned for all the stored types.
+union type_holder_unit
+{
+    double d_;
+    long long ll_;
+    void * p_;
+};
+
+// Mapping of the types which can be held in a row to their data_type tags,
+// the types which can't be held there are mapped to an invalid tag, so that
+// any attempt to get them fails at run-time.
 template <typename T>
-class type_holder;
+struct type_holder_traits
+{
+    enum { type = -1 };
+};
 
-class holder
+template <>
+struct type_holder_traits<std::string>
 {
-public:
-    holder() {}
-    virtual ~holder() {}
-
-    template<typename T>
-    T get()
-    {
-        type_holder<T>* p = dynamic_cast<type_holder<T> *>(this);
-        if (p)
-        {
-            return p->template value<T>();
-        }
-        else
-        {
-            throw std::bad_cast();
-        }
-    }
-
-private:
-
-    template<typename T>
-    T value();
+    enum { type = dt_string };
 };
 
-template <typename T>
-class type_holder : public holder
+template <>
+struct type_holder_traits<double>
+{
+    enum { type = dt_double };
+};
+
+template <>
+struct type_holder_traits<int>
+{
+    enum { type = dt_integer };
+};
+
+template <>
+struct type_holder_traits<long long>
 {
-public:
-    type_holder(T * t) : t_(t) {}
-    ~type_holder() { delete t_; }
+    enum { type = dt_long_long };
+};
 
-    template<typename TypeValue>
-    TypeValue value() const { return *t_; }
+template <>
+struct type_holder_traits<unsigned long long>
+{
+    enum { type = dt_unsigned_long_long };
+};
 
-private:
-    T * t_;
+template <>
+struct type_holder_traits<std::tm>
+{
+    enum { type = dt_date };
 };
 
+// number of buffer units needed to hold a value of the given type
+template <typename T>
+inline std::size_t type_holder_units()
+{
+    return (sizeof(T) + sizeof(type_holder_unit) - 1) / sizeof(type_holder_unit);
+}
+
+template <typename T>
+inline void type_holder_construct(type_holder_unit * p)
+{
+    new (p) T();
+}
+
+template <typename T>
+inline void type_holder_destroy(type_holder_unit * p)
+{
+    reinterpret_cast<T *>(p)->~T();
+}
+
 } // namespace details
 
 } // namespace soci
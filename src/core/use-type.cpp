@@ -8,10 +8,35 @@
 #define SOCI_SOURCE
 #include "use-type.h"
 #include "statement.h"
+#include "session.h"
 
 using namespace soci;
 using namespace soci::details;
 
+use_type_base * use_type_ptr::get() const
+{
+    if (data_ != NULL)
+    {
+        p_ = ind_ != NULL
+            ? new standard_use_type(data_, type_, *ind_, readOnly_, name_)
+            : new standard_use_type(data_, type_, readOnly_, name_);
+        data_ = NULL;
+    }
+
+    return p_;
+}
+
+use_type_base * use_type_ptr::get(session & s) const
+{
+    if (data_ != NULL)
+    {
+        p_ = s.acquire_use_element(data_, type_, ind_, readOnly_, name_);
+        data_ = NULL;
+    }
+
+    return p_;
+}
+
 standard_use_type::~standard_use_type()
 {
     delete backEnd_;
@@ -63,6 +88,20 @@ void standard_use_type::clean_up()
     }
 }
 
+void standard_use_type::release_backend(statement_impl & st)
+{
+    if (backEnd_ != NULL)
+    {
+        st.release_use_type_backend(backEnd_);
+        backEnd_ = NULL;
+    }
+}
+
+void pooled_use_type::destroy(statement_impl & st)
+{
+    st.session_.release_use_element(this);
+}
+
 vector_use_type::~vector_use_type()
 {
     delete backEnd_;
@@ -9,14 +9,19 @@
 #define SOCI_USE_TYPE_H_INCLUDED
 
 #include "soci-backend.h"
-#include "type-ptr.h"
 #include "exchange-traits.h"
 // std
 #include <cstddef>
 #include <string>
 #include <vector>
 
-namespace soci { namespace details {
+namespace soci
+{
+
+class session;
+
+namespace details
+{
 
 class statement_impl;
 
@@ -33,9 +38,44 @@ public:
     virtual void clean_up() = 0;
 
     virtual std::size_t size() const = 0;  // returns the number of elements
+
+    // give the backend back to the statement after clean_up(), if it can be
+    // reused by another element
+    virtual void release_backend(statement_impl & /* st */) {}
+
+    // destroy the element once the statement is done with it
+    virtual void destroy(statement_impl & /* st */) { delete this; }
 };
 
-typedef type_ptr<use_type_base> use_type_ptr;
+// Holds the element created by use() until it is given to the statement.
+// The single elements of the basic types are only described here and
+// created from the session by get(session &), which reuses the elements
+// given back by the previous statements instead of allocating new ones.
+class SOCI_DECL use_type_ptr
+{
+public:
+    use_type_ptr(use_type_base * p)
+        : p_(p), data_(NULL), type_(x_char), ind_(NULL), readOnly_(false) {}
+    use_type_ptr(void * data, exchange_type type, indicator * ind,
+        bool readOnly, std::string const & name)
+        : p_(NULL), data_(data), type_(type), ind_(ind),
+          readOnly_(readOnly), name_(name) {}
+    ~use_type_ptr() { delete p_; }
+
+    use_type_base * get() const;
+    use_type_base * get(session & s) const;
+    void release() const { p_ = NULL; }
+
+private:
+    mutable use_type_base * p_;
+
+    // description of the element not created yet, if data_ is not NULL
+    mutable void * data_;
+    exchange_type type_;
+    indicator * ind_;
+    bool readOnly_;
+    std::string name_;
+};
 
 class SOCI_DECL standard_use_type : public use_type_base
 {
@@ -80,9 +120,21 @@ public:
 protected:
     virtual void pre_use();
 
+    // used by the elements reused for another variable
+    void set_target(void * data, exchange_type type, indicator * ind,
+        bool readOnly, std::string const & name)
+    {
+        data_ = data;
+        type_ = type;
+        ind_ = ind;
+        readOnly_ = readOnly;
+        name_ = name;
+    }
+
 private:
     virtual void post_use(bool gotData);
     virtual void clean_up();
+    virtual void release_backend(statement_impl & st);
     virtual std::size_t size() const { return 1; }
 
     void* data_;
@@ -94,6 +146,24 @@ private:
     standard_use_type_backend* backEnd_;
 };
 
+// single element of a basic type created by the session for use_type_ptr,
+// given back to the session when the statement is done with it
+class SOCI_DECL pooled_use_type : public standard_use_type
+{
+public:
+    pooled_use_type(void * data, exchange_type type, indicator * ind,
+        bool readOnly, std::string const & name)
+        : standard_use_type(data, type, readOnly, name)
+    {
+        set_target(data, type, ind, readOnly, name);
+    }
+
+    using standard_use_type::set_target;
+
+private:
+    virtual void destroy(statement_impl & st);
+};
+
 class SOCI_DECL vector_use_type : public use_type_base
 {
 public:
@@ -190,32 +260,71 @@ public:
     {}
 };
 
+// the elements of the types handled by standard_use_type are only
+// described, the others are created right away
+
+template <typename T, typename U>
+use_type_ptr make_use_type_ptr(U & t, bool readOnly,
+    std::string const & name, standard_use_type *)
+{
+    return use_type_ptr(const_cast<T *>(&t),
+        static_cast<exchange_type>(exchange_traits<T>::x_type), NULL,
+        readOnly, name);
+}
+
+template <typename T, typename U>
+use_type_ptr make_use_type_ptr(U & t, bool /* readOnly */,
+    std::string const & name, use_type_base *)
+{
+    return use_type_ptr(new use_type<T>(t, name));
+}
+
+template <typename T, typename U>
+use_type_ptr make_use_type_ptr(U & t, indicator & ind, bool readOnly,
+    std::string const & name, standard_use_type *)
+{
+    return use_type_ptr(const_cast<T *>(&t),
+        static_cast<exchange_type>(exchange_traits<T>::x_type), &ind,
+        readOnly, name);
+}
+
+template <typename T, typename U>
+use_type_ptr make_use_type_ptr(U & t, indicator & ind, bool /* readOnly */,
+    std::string const & name, use_type_base *)
+{
+    return use_type_ptr(new use_type<T>(t, ind, name));
+}
+
 // helper dispatchers for basic types
 
 template <typename T>
 use_type_ptr do_use(T & t, std::string const & name, basic_type_tag)
 {
-    return use_type_ptr(new use_type<T>(t, name));
+    return make_use_type_ptr<T>(t, false, name,
+        static_cast<use_type<T> *>(NULL));
 }
 
 template <typename T>
 use_type_ptr do_use(T const & t, std::string const & name, basic_type_tag)
 {
-    return use_type_ptr(new use_type<T>(t, name));
+    return make_use_type_ptr<T>(t, true, name,
+        static_cast<use_type<T> *>(NULL));
 }
 
 template <typename T>
 use_type_ptr do_use(T & t, indicator & ind,
     std::string const & name, basic_type_tag)
 {
-    return use_type_ptr(new use_type<T>(t, ind, name));
+    return make_use_type_ptr<T>(t, ind, false, name,
+        static_cast<use_type<T> *>(NULL));
 }
 
 template <typename T>
 use_type_ptr do_use(T const & t, indicator & ind,
     std::string const & name, basic_type_tag)
 {
-    return use_type_ptr(new use_type<T>(t, ind, name));
+    return make_use_type_ptr<T>(t, ind, true, name,
+        static_cast<use_type<T> *>(NULL));
 }
 
 template <typename T>